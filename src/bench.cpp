@@ -0,0 +1,112 @@
+#include "grim.hpp"
+#include "params.hpp"
+
+/* grim_bench: timeStepper::benchmarkKernels() over a range of grid sizes and
+ * dimensions, with the problem, physics and solvers set in params.cpp.
+ *
+ *   mpirun -np 4 ./grim_bench -bench_sizes 32,64,128 -bench_dims 2,3 \
+ *                             -bench_evals 20 -bench_file bench.csv
+ *
+ * -bench_sizes : zones along each of the dim directions
+ *                (default: params::N1, N2, N3 as set)
+ * -bench_dims  : dimensions (default: params::dim)
+ * -bench_evals : timed calls of each kernel (default 10)
+ * -bench_file  : CSV output, appended to (default grim_bench.csv)
+ *
+ * Every size takes one time step first, so that the kernels see a physical
+ * state. Restarts, the geometry cache and checkpoints are turned off, since
+ * the sizes differ from those of the run they are for. */
+int main(int argc, char **argv)
+{
+  PetscInitialize(&argc, &argv, NULL, help);
+
+  int world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+  //af::setDevice(world_rank%params::numDevices);
+  af::setDevice(1);
+
+  std::string threadInfo;
+  threads::setupThreads(params::numThreads, params::pinThreads, threadInfo);
+  PetscSynchronizedPrintf(PETSC_COMM_WORLD, "  Rank %d : %s\n",
+                          world_rank, threadInfo.c_str()
+                         );
+  PetscSynchronizedFlush(PETSC_COMM_WORLD, PETSC_STDOUT);
+
+  const int maxEntries = 16;
+  PetscInt sizes[maxEntries], dims[maxEntries];
+  PetscInt numSizes = maxEntries, numDims = maxEntries;
+  PetscInt numEvals = 10;
+  char fileName[PETSC_MAX_PATH_LEN] = "grim_bench.csv";
+  PetscBool sizesSet, dimsSet, isSet;
+  PetscOptionsGetIntArray(NULL, NULL, "-bench_sizes", sizes, &numSizes,
+                          &sizesSet
+                         );
+  PetscOptionsGetIntArray(NULL, NULL, "-bench_dims", dims, &numDims,
+                          &dimsSet
+                         );
+  PetscOptionsGetInt(NULL, NULL, "-bench_evals", &numEvals, &isSet);
+  PetscOptionsGetString(NULL, NULL, "-bench_file", fileName,
+                        PETSC_MAX_PATH_LEN, &isSet
+                       );
+  if (!dimsSet)
+  {
+    numDims = 1;
+    dims[0] = params::dim;
+  }
+  const int N1Default = params::N1;
+  const int N2Default = params::N2;
+  const int N3Default = params::N3;
+  if (!sizesSet)
+  {
+    numSizes = 1;
+  }
+
+  /* The sizes are not those of the run: no restart lookup, geometry cache,
+   * checkpoints or signal handlers */
+  params::restart                 = 0;
+  params::restartFileName         = "";
+  params::restartFileTime         = "";
+  params::geometryCache           = 0;
+  params::checkpointOnSignal      = 0;
+  params::checkpointEveryNSteps   = 0;
+  params::checkpointEveryWallTime = 0.;
+  params::MaxWallTime             = 1e30;
+
+  for (int d=0; d < numDims; d++)
+  {
+    for (int s=0; s < numSizes; s++)
+    {
+      /* The physics and the problem read params::dim and params::N1 too.
+       * grid sets N2 = N3 = 1 in 1D and N3 = 1 in 2D. */
+      params::dim = dims[d];
+      params::N1  = sizesSet ? sizes[s] : N1Default;
+      params::N2  = sizesSet ? sizes[s] : N2Default;
+      params::N3  = sizesSet ? sizes[s] : N3Default;
+
+      /* Local scope so that all grids are destroyed before the next size */
+      {
+        timeStepper ts(params::N1, params::N2, params::N3,
+                       params::dim, vars::dof, params::numGhost,
+                       params::Time, params::InitialDt,
+                       params::boundaryLeft,  params::boundaryRight,
+                       params::boundaryTop,   params::boundaryBottom,
+                       params::boundaryFront, params::boundaryBack,
+                       params::metric, params::blackHoleSpin, params::hSlope,
+                       params::X1Start, params::X1End,
+                       params::X2Start, params::X2End,
+                       params::X3Start, params::X3End
+                      );
+        ts.timeStep();
+        af::sync();
+
+        ts.benchmarkKernels(numEvals, fileName);
+      }
+    }
+  }
+
+  PetscPrintf(PETSC_COMM_WORLD, "\n  Kernel timings written to %s\n\n",
+              fileName
+             );
+  PetscFinalize();
+  return(0);
+}
@@ -0,0 +1,212 @@
+#include "coordinateMap.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/* Every geometry, and the key of the geometry cache, needs the maps; the
+ * files are read once */
+const coordinateMap &coordinateMap::shared(const std::string fileName)
+{
+  static std::map<std::string, coordinateMap> maps;
+  if (maps.find(fileName) == maps.end())
+  {
+    maps[fileName].load(fileName);
+  }
+
+  return maps[fileName];
+}
+
+void coordinateMap::load(const std::string fileName)
+{
+  this->fileName = fileName;
+
+  int rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  std::vector<double> table;
+  int fileFound = 1;
+  if (rank == 0)
+  {
+    std::ifstream mapFile(fileName.c_str());
+    fileFound = mapFile.good();
+
+    std::string line;
+    while (std::getline(mapFile, line))
+    {
+      if (line.find_first_not_of(" \t") == std::string::npos
+          || line[line.find_first_not_of(" \t")] == '#'
+         )
+      {
+        continue;
+      }
+      std::istringstream pair(line);
+      double X, x;
+      if (pair >> X >> x)
+      {
+        table.push_back(X);
+        table.push_back(x);
+      }
+    }
+  }
+  int tableSize = table.size();
+  MPI_Bcast(&fileFound, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&tableSize, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  table.resize(tableSize);
+  MPI_Bcast(&table[0], tableSize, MPI_DOUBLE, 0, PETSC_COMM_WORLD);
+
+  if (!fileFound || tableSize < 4)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "Coordinate map %s: could not read at least two X x pairs\n",
+                fileName.c_str()
+               );
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  const int numKnots = tableSize/2;
+  XKnots.resize(numKnots);
+  xKnots.resize(numKnots);
+  for (int i=0; i < numKnots; i++)
+  {
+    XKnots[i] = table[2*i];
+    xKnots[i] = table[2*i + 1];
+    if (i > 0 && (XKnots[i] <= XKnots[i-1] || xKnots[i] <= xKnots[i-1]))
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "Coordinate map %s: X and x must be strictly increasing, "
+                  "see line %d of the table\n",
+                  fileName.c_str(), i+1
+                 );
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+  }
+
+  setSpline();
+
+  /* The spline through increasing data can still turn back between knots,
+   * which would fold the grid */
+  for (int i=0; i < numKnots-1; i++)
+  {
+    for (int n=0; n < 4; n++)
+    {
+      double x, dxdX, d2xdX2;
+      evaluatePoint(XKnots[i] + 0.25*n*(XKnots[i+1] - XKnots[i]),
+                    x, dxdX, d2xdX2
+                   );
+      if (dxdX <= 0.)
+      {
+        PetscPrintf(PETSC_COMM_WORLD,
+                    "Coordinate map %s: the spline is not monotonic near "
+                    "X = %g, use a smoother table\n",
+                    fileName.c_str(), XKnots[i]
+                   );
+        MPI_Abort(PETSC_COMM_WORLD, 1);
+      }
+    }
+  }
+}
+
+/* Second derivatives of the natural cubic spline (zero at both ends), from
+ * the tridiagonal system
+ *   h_{i-1} M_{i-1} + 2 (h_{i-1} + h_i) M_i + h_i M_{i+1}
+ *     = 6 ((x_{i+1} - x_i)/h_i - (x_i - x_{i-1})/h_{i-1}),
+ * solved with the Thomas algorithm */
+void coordinateMap::setSpline()
+{
+  const int numKnots = XKnots.size();
+  d2xKnots.assign(numKnots, 0.);
+  if (numKnots < 3)
+  {
+    return;
+  }
+
+  std::vector<double> diag(numKnots, 1.), upper(numKnots, 0.);
+  std::vector<double> rhs(numKnots, 0.);
+  for (int i=1; i < numKnots-1; i++)
+  {
+    const double hLeft  = XKnots[i]   - XKnots[i-1];
+    const double hRight = XKnots[i+1] - XKnots[i];
+    const double lower  = hLeft;
+
+    diag[i]  = 2.*(hLeft + hRight);
+    upper[i] = hRight;
+    rhs[i]   = 6.*(  (xKnots[i+1] - xKnots[i])/hRight
+                   - (xKnots[i] - xKnots[i-1])/hLeft
+                  );
+
+    /* Eliminate the lower diagonal; row 0 is M_0 = 0 */
+    const double factor = (i == 1) ? 0. : lower/diag[i-1];
+    diag[i] -= factor*upper[i-1];
+    rhs[i]  -= factor*rhs[i-1];
+  }
+
+  for (int i=numKnots-2; i > 0; i--)
+  {
+    d2xKnots[i] = (rhs[i] - upper[i]*d2xKnots[i+1])/diag[i];
+  }
+}
+
+void coordinateMap::evaluatePoint(const double X,
+                                  double &x, double &dxdX, double &d2xdX2
+                                 ) const
+{
+  const int numKnots = XKnots.size();
+
+  /* Straight line continuation, d^2x/dX^2 = 0 at the ends */
+  if (X <= XKnots[0] || X >= XKnots[numKnots-1])
+  {
+    const int end   = (X <= XKnots[0]) ? 0 : numKnots-1;
+    const int i     = (X <= XKnots[0]) ? 0 : numKnots-2;
+    const double h  = XKnots[i+1] - XKnots[i];
+    const double slope = (xKnots[i+1] - xKnots[i])/h
+                       + (end == 0 ? -h*d2xKnots[1]/6. : h*d2xKnots[i]/6.);
+    x      = xKnots[end] + slope*(X - XKnots[end]);
+    dxdX   = slope;
+    d2xdX2 = 0.;
+    return;
+  }
+
+  const int i = std::upper_bound(XKnots.begin(), XKnots.end(), X)
+              - XKnots.begin() - 1;
+  const double h = XKnots[i+1] - XKnots[i];
+  const double A = (XKnots[i+1] - X)/h;
+  const double B = 1. - A;
+
+  x      =  A*xKnots[i] + B*xKnots[i+1]
+          + ((A*A*A - A)*d2xKnots[i] + (B*B*B - B)*d2xKnots[i+1])*h*h/6.;
+  dxdX   =  (xKnots[i+1] - xKnots[i])/h
+          - (3.*A*A - 1.)*h*d2xKnots[i]/6.
+          + (3.*B*B - 1.)*h*d2xKnots[i+1]/6.;
+  d2xdX2 =  A*d2xKnots[i] + B*d2xKnots[i+1];
+}
+
+/* Evaluated on the host: geometry is set up once, and the table lookup has
+ * no ArrayFire equivalent */
+void coordinateMap::evaluate(const array &X,
+                             array &x, array &dxdX, array &d2xdX2
+                            ) const
+{
+  const int numPoints = X.elements();
+  double *XHostPtr    = X.as(f64).host<double>();
+
+  std::vector<double> xHost(numPoints), dxdXHost(numPoints);
+  std::vector<double> d2xdX2Host(numPoints);
+  for (int n=0; n < numPoints; n++)
+  {
+    evaluatePoint(XHostPtr[n], xHost[n], dxdXHost[n], d2xdX2Host[n]);
+  }
+  af::freeHost(XHostPtr);
+
+  x      = array(X.dims(), &xHost[0]);
+  dxdX   = array(X.dims(), &dxdXHost[0]);
+  d2xdX2 = array(X.dims(), &d2xdX2Host[0]);
+}
+
+void coordinateMap::writeKey(std::ostream &key) const
+{
+  key << " " << XKnots.size();
+  for (int i=0; i < XKnots.size(); i++)
+  {
+    key << " " << XKnots[i] << " " << xKnots[i];
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef GRIM_COORDINATEMAP_H_
+#define GRIM_COORDINATEMAP_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include "../params.hpp"
+#include "../grid/grid.hpp"
+
+/* Coordinate map x(X) of one direction read from a table, so that the zones,
+ * uniform in X, can be placed anywhere in x without code changes. The file
+ * has one "X x" pair per line, with X and x strictly increasing; lines
+ * starting with # are comments. The map and its first two derivatives, for
+ * the metric Jacobian and the connection coefficients, come from the natural
+ * cubic spline through the pairs. Outside of the table the map continues as
+ * a straight line. */
+class coordinateMap
+{
+  std::vector<double> XKnots, xKnots;
+  /* d^2x/dX^2 at the knots */
+  std::vector<double> d2xKnots;
+
+  void setSpline();
+
+  public:
+    std::string fileName;
+
+    coordinateMap() {}
+    /* Collective: rank 0 reads fileName and broadcasts the table */
+    void load(const std::string fileName);
+    /* The map of fileName, loaded on the first call of the run only, which
+     * is collective */
+    static const coordinateMap &shared(const std::string fileName);
+    bool isLoaded() const {return XKnots.size() > 0;}
+
+    void evaluatePoint(const double X,
+                       double &x, double &dxdX, double &d2xdX2
+                      ) const;
+    void evaluate(const array &X,
+                  array &x, array &dxdX, array &d2xdX2
+                 ) const;
+
+    /* Writes the table, for keys that must change with the map */
+    void writeKey(std::ostream &key) const;
+};
+
+#endif /* GRIM_COORDINATEMAP_H_ */
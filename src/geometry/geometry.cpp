@@ -1,11 +1,128 @@
 #include "geometry.hpp"
 #include "CoordinateChangeFunctionsArray.hpp"
+#include "geometrySourceHash.hpp"
 
 geometry::geometry(const int metric,
                    const double blackHoleSpin,
                    const double hSlope,
                    const coordinatesGrid &XCoordsGrid
                   )
+{
+  setParams(metric, blackHoleSpin, hSlope, XCoordsGrid);
+
+  XCoordsToxCoords(XCoords,xCoords);
+
+  if (isFlat)
+  {
+    setFlatMetric();
+    return;
+  }
+
+  /* Allocate space */
+  g          = zero;
+  array gDet = zero;
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=0; nu<NDIM; nu++)
+    {
+      gCov[mu][nu] = zero;
+      gCon[mu][nu] = zero;
+    }
+  }
+  
+  setgCovInXCoords(XCoords, gCov);
+  setgDetAndgConFromgCov(gCov, gDet, gCon);
+
+  g = af::sqrt(-gDet);
+  alpha = 1./af::sqrt(-gCon[0][0]);
+  g.eval();
+  alpha.eval();
+
+  af::sync();
+}
+
+/* Geometry read from a cache file written by dumpCache() for the same
+ * metric, coordinates and decomposition. The connection coefficients are
+ * read too if the file has them. */
+geometry::geometry(const int metric,
+                   const double blackHoleSpin,
+                   const double hSlope,
+                   const coordinatesGrid &XCoordsGrid,
+                   const std::string cacheFileName
+                  )
+{
+  setParams(metric, blackHoleSpin, hSlope, XCoordsGrid);
+
+  Vec cacheVec;
+  VecCreate(PETSC_COMM_SELF, &cacheVec);
+  VecSetType(cacheVec, VECSEQ);
+  PetscObjectSetName((PetscObject) cacheVec, "geometry");
+
+  PetscViewer viewer;
+  PetscViewerHDF5Open(PETSC_COMM_SELF,
+                      cacheFileName.c_str(), FILE_MODE_READ, &viewer
+                     );
+  VecLoad(cacheVec, viewer);
+  PetscViewerDestroy(&viewer);
+
+  const int numZones = XCoords[0].elements();
+  PetscInt cacheSize;
+  VecGetSize(cacheVec, &cacheSize);
+  int numCacheVars = cacheSize/numZones;
+  if (   cacheSize % numZones != 0
+      || (   numCacheVars != NUM_CACHE_VARS
+          && numCacheVars != NUM_CACHE_VARS + NUM_CACHE_CONNECTION_VARS
+         )
+     )
+  {
+    PetscPrintf(PETSC_COMM_SELF, "Geometry cache %s does not match the grid\n",
+                cacheFileName.c_str()
+               );
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  const PetscScalar *cachePtr;
+  VecGetArrayRead(cacheVec, &cachePtr);
+  std::vector<array *> cacheVars;
+  setCacheVars(numCacheVars > NUM_CACHE_VARS, cacheVars);
+  for (int var=0; var < cacheVars.size(); var++)
+  {
+    *cacheVars[var] = array(XCoords[0].dims(), cachePtr + var*numZones);
+  }
+  VecRestoreArrayRead(cacheVec, &cachePtr);
+  VecDestroy(&cacheVec);
+
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=0; nu<mu; nu++)
+    {
+      gCov[mu][nu] = gCov[nu][mu];
+      gCon[mu][nu] = gCon[nu][mu];
+    }
+  }
+  if (numCacheVars > NUM_CACHE_VARS)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda = 0; lamda<nu; lamda++)
+        {
+          gammaUpDownDown[mu][nu][lamda] = gammaUpDownDown[mu][lamda][nu];
+        }
+      }
+    }
+    haveConnectionCoeffs = true;
+  }
+
+  af::sync();
+}
+
+void geometry::setParams(const int metric,
+                         const double blackHoleSpin,
+                         const double hSlope,
+                         const coordinatesGrid &XCoordsGrid
+                        )
 {
   /* Differencing parameter for computing connections */
   GAMMA_EPS = 1.e-5;
@@ -19,16 +136,49 @@ geometry::geometry(const int metric,
   this->blackHoleSpin = blackHoleSpin;
   this->hSlope = hSlope;
 
+  haveConnectionCoeffs = false;
+
+  gCovGrid            = NULL;
+  gConGrid            = NULL;
+  gGrid               = NULL;
+  alphaGrid           = NULL;
+  gammaUpDownDownGrid = NULL;
+  xCoordsGrid         = NULL;
+
   XCoords[directions::X1] = XCoordsGrid.vars[directions::X1];
   XCoords[directions::X2] = XCoordsGrid.vars[directions::X2];
   XCoords[directions::X3] = XCoordsGrid.vars[directions::X3];
 
-  XCoordsToxCoords(XCoords,xCoords);
+  isFlat = (metric == metrics::MINKOWSKI);
 
-  /* Allocate space */
-  zero       = 0.*XCoords[0];
-  g          = zero;
-  array gDet = zero;
+  const std::string mapFiles[2] = {params::X1MapFile, params::X2MapFile};
+  for (int i=0; i<2; i++)
+  {
+    if (metric != metrics::MODIFIED_KERR_SCHILD || mapFiles[i].empty())
+    {
+      continue;
+    }
+    if (params::DoCylindrify || params::DerefineThetaHorizon)
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "Tabulated coordinate maps cannot be combined with "
+                  "DoCylindrify or DerefineThetaHorizon\n"
+                 );
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    tabulatedMaps[i] = coordinateMap::shared(mapFiles[i]);
+  }
+
+  /* A lazy constant, and not 0.*XCoords[0], so that expressions built on it
+   * do not read the coordinates */
+  zero = af::constant(0., XCoords[0].dims(), XCoords[0].type());
+}
+
+/* Minkowski metric diag(-1, 1, 1, 1) as lazy ArrayFire constants. Nothing is
+ * allocated: every kernel that uses them gets the values as literals, so
+ * flat-space problems do not read any metric from memory. */
+void geometry::setFlatMetric()
+{
   for (int mu=0; mu<NDIM; mu++)
   {
     for (int nu=0; nu<NDIM; nu++)
@@ -37,25 +187,155 @@ geometry::geometry(const int metric,
       gCon[mu][nu] = zero;
     }
   }
-  
-  setgCovInXCoords(XCoords, gCov);
-  setgDetAndgConFromgCov(gCov, gDet, gCon);
+  const array one = af::constant(1., XCoords[0].dims(), XCoords[0].type());
+  gCov[0][0] = -one;
+  gCon[0][0] = -one;
+  for (int i=1; i<NDIM; i++)
+  {
+    gCov[i][i] = one;
+    gCon[i][i] = one;
+  }
+  g     = one;
+  alpha = one;
+}
 
-  g = af::sqrt(-gDet);
-  alpha = 1./af::sqrt(-gCon[0][0]);
-  g.eval();
-  alpha.eval();
+/* Arrays in a cache file, in order: xCoords, the upper triangles of gCov
+ * and gCon, g, alpha, and gammaUpDownDown^mu_nu_lamda for nu <= lamda */
+void geometry::setCacheVars(const bool withConnectionCoeffs,
+                            std::vector<array *> &cacheVars
+                           )
+{
+  cacheVars.clear();
+  for (int d=0; d<3; d++)
+  {
+    cacheVars.push_back(&xCoords[d]);
+  }
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=mu; nu<NDIM; nu++)
+    {
+      cacheVars.push_back(&gCov[mu][nu]);
+    }
+  }
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=mu; nu<NDIM; nu++)
+    {
+      cacheVars.push_back(&gCon[mu][nu]);
+    }
+  }
+  cacheVars.push_back(&g);
+  cacheVars.push_back(&alpha);
+
+  if (withConnectionCoeffs)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda = nu; lamda<NDIM; lamda++)
+        {
+          cacheVars.push_back(&gammaUpDownDown[mu][nu][lamda]);
+        }
+      }
+    }
+  }
+}
 
-  setgCovGrid();
-  setgConGrid();
-  setgGrid();
-  setalphaGrid();
-  setxCoordsGrid();
+/* Write this rank's geometry, ghost zones included, to its own HDF5 file
+ * for the cache constructor. Not collective. */
+std::string geometry::sourceHash()
+{
+  return GRIM_GEOMETRY_SOURCE_HASH;
+}
 
-  af::sync();
+void geometry::dumpCache(const std::string cacheFileName)
+{
+  std::vector<array *> cacheVars;
+  setCacheVars(haveConnectionCoeffs, cacheVars);
+
+  const int numZones = XCoords[0].elements();
+  Vec cacheVec;
+  VecCreateSeq(PETSC_COMM_SELF, cacheVars.size()*numZones, &cacheVec);
+  PetscObjectSetName((PetscObject) cacheVec, "geometry");
+
+  PetscScalar *cachePtr;
+  VecGetArray(cacheVec, &cachePtr);
+  for (int var=0; var < cacheVars.size(); var++)
+  {
+    cacheVars[var]->host(cachePtr + var*numZones);
+  }
+  VecRestoreArray(cacheVec, &cachePtr);
+
+  PetscViewer viewer;
+  PetscViewerHDF5Open(PETSC_COMM_SELF,
+                      cacheFileName.c_str(), FILE_MODE_WRITE, &viewer
+                     );
+  VecView(cacheVec, viewer);
+  PetscViewerDestroy(&viewer);
+  VecDestroy(&cacheVec);
 }
 
+/* Connection coefficients gammaUpDownDown, in closed form unless
+ * params::analyticConnectionCoeffs is 0. With params::checkConnectionCoeffs
+ * the finite difference ones are also computed, for the largest difference
+ * between the two, and the closed form ones are kept. Collective when
+ * checking. */
 void geometry::computeConnectionCoeffs()
+{
+  if (params::analyticConnectionCoeffs == 0)
+  {
+    computeConnectionCoeffsFiniteDifference();
+    return;
+  }
+
+  computeConnectionCoeffsAnalytic();
+
+  if (params::checkConnectionCoeffs)
+  {
+    array gammaAnalytic[NDIM][NDIM][NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda = 0; lamda<NDIM; lamda++)
+        {
+          gammaAnalytic[mu][nu][lamda] = gammaUpDownDown[mu][nu][lamda];
+        }
+      }
+    }
+    computeConnectionCoeffsFiniteDifference();
+
+    double maxDiff[2] = {0., 0.};
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda = 0; lamda<NDIM; lamda++)
+        {
+          array diff =   gammaAnalytic[mu][nu][lamda]
+                       - gammaUpDownDown[mu][nu][lamda];
+          maxDiff[0] = std::max(maxDiff[0], af::max<double>(af::abs(diff)));
+          maxDiff[1] = std::max(maxDiff[1],
+                         af::max<double>(af::abs(gammaAnalytic[mu][nu][lamda]))
+                       );
+          gammaUpDownDown[mu][nu][lamda] = gammaAnalytic[mu][nu][lamda];
+        }
+      }
+    }
+    double globalMaxDiff[2];
+    MPI_Allreduce(maxDiff, globalMaxDiff, 2, MPI_DOUBLE, MPI_MAX,
+                  PETSC_COMM_WORLD
+                 );
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  Connection coefficients: max |analytic - finite difference|"
+                " = %e, max |gamma| = %e\n",
+                globalMaxDiff[0], globalMaxDiff[1]
+               );
+  }
+}
+
+void geometry::computeConnectionCoeffsFiniteDifference()
 {
   array gammaDownDownDown[NDIM][NDIM][NDIM];
   array gCovPlus[NDIM-1][NDIM][NDIM];
@@ -92,6 +372,175 @@ void geometry::computeConnectionCoeffs()
     }
   }
 
+  raiseConnectionCoeffs(gammaDownDownDown);
+}
+
+/* Closed form connection coefficients. With x^mu = {t, r, theta, phi} and
+ * the metric g_mu_nu = J^alpha_mu J^beta_nu gKS_alpha_beta(r, theta), where
+ * J is the Jacobian of the map (t, X1, X2, X3) -> x^mu in setMapJacobian(),
+ *
+ * d(g_mu_nu)/dX^sigma =   J^alpha_mu J^beta_nu dgKS_alpha_beta/dX^sigma
+ *                       + (dJ^alpha_mu/dX^sigma J^beta_nu
+ *                          + J^alpha_mu dJ^beta_nu/dX^sigma) gKS_alpha_beta
+ *
+ * with dgKS/dX^sigma = dgKS/dr dr/dX^sigma + dgKS/dtheta dtheta/dX^sigma,
+ * and then gamma_eta_mu_nu = 0.5*(  d(g_eta_mu)/dX^nu + d(g_eta_nu)/dX^mu
+ *                                 - d(g_mu_nu)/dX^eta). Only X1 and X2
+ * derivatives are non-zero. */
+void geometry::computeConnectionCoeffsAnalytic()
+{
+  if (metric == metrics::MINKOWSKI)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda = 0; lamda<NDIM; lamda++)
+        {
+          gammaUpDownDown[mu][nu][lamda] = zero;
+        }
+      }
+    }
+    haveConnectionCoeffs = true;
+    return;
+  }
+
+  array dxdX[2][2], ddxdXdX[2][2][2];
+  setMapJacobian(XCoords, xCoords, dxdX);
+  setMapJacobianDerivatives(XCoords, xCoords, ddxdXdX);
+
+  /* d(r, theta)/d(X1, X2) in the chain rule for gKS(r, theta). Same as the
+   * Jacobian in the metric, except with DerefineThetaHorizon and no
+   * cylindrification: the metric then uses the Jacobian of GammieTheta,
+   * while theta is that of ThetaNoCyl */
+  array dxdXChain[2][2];
+  for (int a=0; a<2; a++)
+  {
+    for (int i=0; i<2; i++)
+    {
+      dxdXChain[a][i] = dxdX[a][i];
+    }
+  }
+  if (params::DerefineThetaHorizon && !params::DoCylindrify)
+  {
+    /* theta = acos(cTh), cTh = cTh1 + A*(cTh0 - cTh1), A = exp(X1Start - X1),
+     * so that dtheta/dX = -dcTh/dX / sin(theta) */
+    array X2          = XCoords[directions::X2];
+    array thetaGammie = GammieTheta(X2);
+    array dthetaGammie_dX2 =  M_PI
+                            + M_PI*(1 - params::hSlope)*af::cos(2*M_PI*X2);
+    array cTh0 = af::cos(M_PI*X2);
+    array cTh1 = af::cos(thetaGammie);
+    array A    = exp(params::X1Start)/af::exp(XCoords[directions::X1]);
+
+    array dcTh1_dX2 = -af::sin(thetaGammie)*dthetaGammie_dX2;
+    array dcTh_dX1  = -A*(cTh0 - cTh1);
+    array dcTh_dX2  =  dcTh1_dX2 + A*(-M_PI*af::sin(M_PI*X2) - dcTh1_dX2);
+
+    array sinTheta = af::sin(xCoords[directions::X2]);
+    dxdXChain[1][0] = -dcTh_dX1/sinTheta;
+    dxdXChain[1][1] = -dcTh_dX2/sinTheta;
+    dxdXChain[1][0].eval();
+    dxdXChain[1][1].eval();
+  }
+
+  array gKS[NDIM][NDIM], dgKS[2][NDIM][NDIM];
+  setKerrSchildMetric(xCoords[directions::X1], xCoords[directions::X2],
+                      gKS, dgKS
+                     );
+
+  /* J^alpha_mu: identity in t and phi, dxdX in (r, theta) x (X1, X2) */
+  array J[NDIM][NDIM];
+  bool isMapped[NDIM][NDIM];
+  for (int alpha=0; alpha<NDIM; alpha++)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      J[alpha][mu]        = zero;
+      isMapped[alpha][mu] = false;
+    }
+  }
+  J[0][0] = zero + 1.; isMapped[0][0] = true;
+  J[3][3] = zero + 1.; isMapped[3][3] = true;
+  for (int a=0; a<2; a++)
+  {
+    for (int i=0; i<2; i++)
+    {
+      J[a+1][i+1]        = dxdX[a][i];
+      isMapped[a+1][i+1] = true;
+    }
+  }
+
+  /* d(g_mu_nu)/dX^sigma, zero for sigma = 0 and 3 */
+  array dgCov[NDIM][NDIM][NDIM];
+  for (int sigma=0; sigma<NDIM; sigma++)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=mu; nu<NDIM; nu++)
+      {
+        dgCov[sigma][mu][nu] = zero;
+        if (sigma == 0 || sigma == 3)
+        {
+          dgCov[sigma][nu][mu] = zero;
+          continue;
+        }
+
+        for (int alpha=0; alpha<NDIM; alpha++)
+        {
+          if (!isMapped[alpha][mu]) continue;
+
+          for (int beta=0; beta<NDIM; beta++)
+          {
+            if (!isMapped[beta][nu]) continue;
+
+            array dgKS_dX =  dgKS[0][alpha][beta]*dxdXChain[0][sigma-1]
+                           + dgKS[1][alpha][beta]*dxdXChain[1][sigma-1];
+            dgCov[sigma][mu][nu] += J[alpha][mu]*J[beta][nu]*dgKS_dX;
+
+            if (alpha == 1 || alpha == 2)
+            {
+              dgCov[sigma][mu][nu] +=
+                ddxdXdX[alpha-1][mu-1][sigma-1]*J[beta][nu]*gKS[alpha][beta];
+            }
+            if (beta == 1 || beta == 2)
+            {
+              dgCov[sigma][mu][nu] +=
+                J[alpha][mu]*ddxdXdX[beta-1][nu-1][sigma-1]*gKS[alpha][beta];
+            }
+          }
+        }
+        dgCov[sigma][mu][nu].eval();
+        dgCov[sigma][nu][mu] = dgCov[sigma][mu][nu];
+      }
+    }
+  }
+
+  array gammaDownDownDown[NDIM][NDIM][NDIM];
+  for (int eta=0; eta<NDIM; eta++)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=mu; nu<NDIM; nu++)
+      {
+        gammaDownDownDown[eta][mu][nu] =
+          0.5*(  dgCov[nu][eta][mu] + dgCov[mu][eta][nu]
+               - dgCov[eta][mu][nu]
+              );
+        gammaDownDownDown[eta][mu][nu].eval();
+        gammaDownDownDown[eta][nu][mu] = gammaDownDownDown[eta][mu][nu];
+      }
+    }
+  }
+
+  raiseConnectionCoeffs(gammaDownDownDown);
+}
+
+/* gammaUpDownDown^mu_nu_lamda = gCon^mu_eta gamma_eta_nu_lamda */
+void geometry::raiseConnectionCoeffs(
+  const array gammaDownDownDown[NDIM][NDIM][NDIM]
+)
+{
   for (int mu=0; mu<NDIM; mu++)
   {
     for (int nu=0; nu<NDIM; nu++)
@@ -111,10 +560,273 @@ void geometry::computeConnectionCoeffs()
       }
     }
   }
+  haveConnectionCoeffs = true;
 
   af::sync();
 }
 
+/* Jacobian of the MODIFIED_KERR_SCHILD map as used in the metric,
+ * dxdX[a][i] = d(r, theta)[a]/d(X1, X2)[i]. Spline derivatives for tabulated
+ * maps, finite differences of the map when cylindrified. */
+void geometry::setMapJacobian(const array XCoords[3],
+                              const array xCoords[3],
+                              array dxdX[2][2]
+                             )
+{
+  /* r = exp(X1) => dr/dX = exp(X1) = r */
+  dxdX[0][0] = xCoords[directions::X1];
+  dxdX[0][1] = zero;
+  /* theta = pi*X2 + 0.5*(1 - H_SLOPE)*sin(2*pi*X2) 
+      -         => dtheta/dX2 = pi + pi*(1 - H_SLOPE)*cos(2*pi*X2) */
+  dxdX[1][1] =  M_PI 
+	+ M_PI*(1 - hSlope)
+	*af::cos(2*M_PI*XCoords[directions::X2]);
+  dxdX[1][0] = zero;
+
+  for (int i=0; i<2; i++)
+  {
+    if (tabulatedMaps[i].isLoaded())
+    {
+      array x, d2xdX2;
+      tabulatedMaps[i].evaluate(XCoords[directions::X1 + i],
+                                x, dxdX[i][i], d2xdX2
+                               );
+    }
+  }
+      
+  if(params::DoCylindrify)
+	{
+	  array XCoordsPlusEps[3];
+	  array xCoordsPlusEps[3];
+	  array XCoordsMinusEps[3];
+	  array xCoordsMinusEps[3];
+
+	  for (int i=0; i<2; i++)
+	    {
+	      for(int d=0;d<3;d++)
+		{
+		  XCoordsPlusEps[d] = XCoords[d];
+		  xCoordsPlusEps[d] = xCoords[d];
+		  XCoordsMinusEps[d] = XCoords[d];
+		  xCoordsMinusEps[d] = xCoords[d];
+		}
+	      XCoordsPlusEps[directions::X1 + i]+=GAMMA_EPS;
+	      XCoordsMinusEps[directions::X1 + i]-=GAMMA_EPS;
+	      XCoordsToxCoords(XCoordsPlusEps,xCoordsPlusEps);      
+	      XCoordsToxCoords(XCoordsMinusEps,xCoordsMinusEps);
+	      dxdX[0][i] = (xCoordsPlusEps[directions::X1]-xCoordsMinusEps[directions::X1])/(2.*GAMMA_EPS);
+	      dxdX[1][i] = (xCoordsPlusEps[directions::X2]-xCoordsMinusEps[directions::X2])/(2.*GAMMA_EPS);
+	    }
+	}
+
+  for (int a=0; a<2; a++)
+  {
+    for (int i=0; i<2; i++)
+    {
+      dxdX[a][i].eval();
+    }
+  }
+}
+
+/* Second differences of the map x(X1, X2) with step h. Their error is
+ * ~h^2 d^4x/dX^4/12 in truncation plus ~1e-16 |x|/h^2 in round-off. */
+void geometry::mapSecondDifferences(const array XCoords[3],
+                                    const array xCoords[3],
+                                    const double h,
+                                    array ddxdXdX[2][2][2]
+                                   ) const
+{
+  /* x at X + n1*h e_X1 + n2*h e_X2, n1, n2 = -1, 0, 1 */
+  array xShifted[3][3][2];
+  for (int n1=-1; n1<=1; n1++)
+  {
+    for (int n2=-1; n2<=1; n2++)
+    {
+      array XCoordsShifted[3], xCoordsShifted[3];
+      if (n1 == 0 && n2 == 0)
+      {
+        xShifted[1][1][0] = xCoords[directions::X1];
+        xShifted[1][1][1] = xCoords[directions::X2];
+        continue;
+      }
+      for (int d=0; d<3; d++)
+      {
+        XCoordsShifted[d] = XCoords[d];
+      }
+      XCoordsShifted[directions::X1] += n1*h;
+      XCoordsShifted[directions::X2] += n2*h;
+      XCoordsToxCoords(XCoordsShifted, xCoordsShifted);
+      xShifted[n1+1][n2+1][0] = xCoordsShifted[directions::X1];
+      xShifted[n1+1][n2+1][1] = xCoordsShifted[directions::X2];
+    }
+  }
+
+  double h2 = h*h;
+  for (int a=0; a<2; a++)
+  {
+    ddxdXdX[a][0][0] = (  xShifted[2][1][a] - 2.*xShifted[1][1][a]
+                        + xShifted[0][1][a]
+                       )/h2;
+    ddxdXdX[a][1][1] = (  xShifted[1][2][a] - 2.*xShifted[1][1][a]
+                        + xShifted[1][0][a]
+                       )/h2;
+    ddxdXdX[a][0][1] = (  xShifted[2][2][a] - xShifted[2][0][a]
+                        - xShifted[0][2][a] + xShifted[0][0][a]
+                       )/(4.*h2);
+    ddxdXdX[a][1][0] = ddxdXdX[a][0][1];
+  }
+}
+
+/* ddxdXdX[a][i][j] = d(dxdX[a][i])/dX^j of the Jacobian in setMapJacobian():
+ * closed form for the map of GammieRadius and GammieTheta, from the spline
+ * for tabulated maps, Richardson extrapolated second differences of the map
+ * when cylindrified */
+void geometry::setMapJacobianDerivatives(const array XCoords[3],
+                                         const array xCoords[3],
+                                         array ddxdXdX[2][2][2]
+                                        )
+{
+  for (int a=0; a<2; a++)
+  {
+    for (int i=0; i<2; i++)
+    {
+      for (int j=0; j<2; j++)
+      {
+        ddxdXdX[a][i][j] = zero;
+      }
+    }
+  }
+
+  if (params::DoCylindrify)
+  {
+    /* Second differences at GAMMA_EPS alone leave ~1e-6 of round-off. At
+     * steps h and h/2, h = 2e-4, the combination (4 D(h/2) - D(h))/3 cancels
+     * the h^2 term of the truncation error, which leaves O(h^4) and a
+     * round-off of ~1e-8 relative. */
+    const double h = 2.e-4;
+    array coarse[2][2][2], fine[2][2][2];
+    mapSecondDifferences(XCoords, xCoords, h, coarse);
+    mapSecondDifferences(XCoords, xCoords, 0.5*h, fine);
+    for (int a=0; a<2; a++)
+    {
+      for (int i=0; i<2; i++)
+      {
+        for (int j=0; j<2; j++)
+        {
+          ddxdXdX[a][i][j] = (4.*fine[a][i][j] - coarse[a][i][j])/3.;
+        }
+      }
+    }
+  }
+  else
+  {
+    /* d(dr/dX1)/dX1 = r */
+    ddxdXdX[0][0][0] = xCoords[directions::X1];
+    /* d(dtheta/dX2)/dX2 = -2*pi^2*(1 - H_SLOPE)*sin(2*pi*X2) */
+    ddxdXdX[1][1][1] =
+      -2.*M_PI*M_PI*(1 - hSlope)*af::sin(2*M_PI*XCoords[directions::X2]);
+
+    for (int i=0; i<2; i++)
+    {
+      if (tabulatedMaps[i].isLoaded())
+      {
+        array x, dxdX;
+        tabulatedMaps[i].evaluate(XCoords[directions::X1 + i],
+                                  x, dxdX, ddxdXdX[i][i][i]
+                                 );
+      }
+    }
+  }
+
+  for (int a=0; a<2; a++)
+  {
+    for (int i=0; i<2; i++)
+    {
+      for (int j=0; j<2; j++)
+      {
+        ddxdXdX[a][i][j].eval();
+      }
+    }
+  }
+}
+
+/* Kerr-Schild metric gKS in x^mu = {t, r, theta, phi}, and its derivatives
+ * dgKS[0] = d(gKS)/dr and dgKS[1] = d(gKS)/dtheta */
+void geometry::setKerrSchildMetric(const array &r, const array &theta,
+                                   array gKS[NDIM][NDIM],
+                                   array dgKS[2][NDIM][NDIM]
+                                  )
+{
+  double a = blackHoleSpin;
+
+  array sinTheta = af::sin(theta);
+  array cosTheta = af::cos(theta);
+  array sin2     = sinTheta*sinTheta;
+
+  array sigma        = r*r + a*a*cosTheta*cosTheta;
+  array dsigma_dr     = 2.*r;
+  array dsigma_dtheta = -2.*a*a*cosTheta*sinTheta;
+  sigma.eval();
+
+  /* z = 2*r/sigma */
+  array z         = 2.*r/sigma;
+  array dz_dr     = 2.*(sigma - 2.*r*r)/(sigma*sigma);
+  array dz_dtheta = 4.*a*a*r*cosTheta*sinTheta/(sigma*sigma);
+  z.eval();
+  dz_dr.eval();
+  dz_dtheta.eval();
+
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=0; nu<NDIM; nu++)
+    {
+      gKS[mu][nu]     = zero;
+      dgKS[0][mu][nu] = zero;
+      dgKS[1][mu][nu] = zero;
+    }
+  }
+
+  gKS[0][0] = -(1. - z);
+  gKS[0][1] = z;
+  gKS[0][3] = -a*z*sin2;
+  gKS[1][1] = 1. + z;
+  gKS[1][3] = -a*(1. + z)*sin2;
+  gKS[2][2] = sigma;
+  gKS[3][3] = sin2*(sigma + a*a*(1. + z)*sin2);
+
+  dgKS[0][0][0] = dz_dr;
+  dgKS[0][0][1] = dz_dr;
+  dgKS[0][0][3] = -a*dz_dr*sin2;
+  dgKS[0][1][1] = dz_dr;
+  dgKS[0][1][3] = -a*dz_dr*sin2;
+  dgKS[0][2][2] = dsigma_dr;
+  dgKS[0][3][3] = sin2*(dsigma_dr + a*a*dz_dr*sin2);
+
+  dgKS[1][0][0] = dz_dtheta;
+  dgKS[1][0][1] = dz_dtheta;
+  dgKS[1][0][3] = -a*(dz_dtheta*sin2 + 2.*z*sinTheta*cosTheta);
+  dgKS[1][1][1] = dz_dtheta;
+  dgKS[1][1][3] = -a*(dz_dtheta*sin2 + 2.*(1. + z)*sinTheta*cosTheta);
+  dgKS[1][2][2] = dsigma_dtheta;
+  dgKS[1][3][3] =   2.*sinTheta*cosTheta*sigma + sin2*dsigma_dtheta
+                  + a*a*(  dz_dtheta*sin2*sin2
+                         + 4.*(1. + z)*sin2*sinTheta*cosTheta
+                        );
+
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=mu; nu<NDIM; nu++)
+    {
+      gKS[mu][nu].eval();
+      dgKS[0][mu][nu].eval();
+      dgKS[1][mu][nu].eval();
+      gKS[nu][mu]     = gKS[mu][nu];
+      dgKS[0][nu][mu] = dgKS[0][mu][nu];
+      dgKS[1][nu][mu] = dgKS[1][mu][nu];
+    }
+  }
+}
+
 void geometry::setgDetAndgConFromgCov(const array gCov[NDIM][NDIM],
                                       array &gDet,
                                       array gCon[NDIM][NDIM]
@@ -276,56 +988,12 @@ void geometry::setgCovInXCoords(const array XCoords[3],
       array r     = xCoords[directions::X1];
       array theta = xCoords[directions::X2];
 
-      /* r = exp(X1) => dr/dX = exp(X1) = r */
-      array dr_dX1 = r;
-      array dr_dX2 = zero;
-      /* theta = pi*X2 + 0.5*(1 - H_SLOPE)*sin(2*pi*X2) 
-	  -         => dtheta/dX2 = pi + pi*(1 - H_SLOPE)*cos(2*pi*X2) */
-      array dtheta_dX2 =  M_PI 
-	+ M_PI*(1 - hSlope)
-	*af::cos(2*M_PI*XCoords[directions::X2]);
-      array dtheta_dX1 = zero;
-      
-      if(params::DoCylindrify)
-	{
-	  array XCoordsPlusEps[3];
-	  array xCoordsPlusEps[3];
-	  array XCoordsMinusEps[3];
-	  array xCoordsMinusEps[3];
-	  
-	  for(int d=0;d<3;d++)
-	    {
-	      XCoordsPlusEps[d] = XCoords[d];
-	      xCoordsPlusEps[d] = xCoords[d];
-	      XCoordsMinusEps[d] = XCoords[d];
-	      xCoordsMinusEps[d] = xCoords[d];
-	    }
-	  XCoordsPlusEps[directions::X1]+=GAMMA_EPS;
-	  XCoordsMinusEps[directions::X1]-=GAMMA_EPS;
-	  XCoordsToxCoords(XCoordsPlusEps,xCoordsPlusEps);      
-	  XCoordsToxCoords(XCoordsMinusEps,xCoordsMinusEps);      
-	  dr_dX1 = (xCoordsPlusEps[directions::X1]-xCoordsMinusEps[directions::X1])/(2.*GAMMA_EPS);
-	  dtheta_dX1 = (xCoordsPlusEps[directions::X2]-xCoordsMinusEps[directions::X2])/(2.*GAMMA_EPS);
-
-	  for(int d=0;d<3;d++)
-	    {
-	      XCoordsPlusEps[d] = XCoords[d];
-	      xCoordsPlusEps[d] = xCoords[d];
-	      XCoordsMinusEps[d] = XCoords[d];
-              xCoordsMinusEps[d] = xCoords[d];
-	    }
-	  XCoordsPlusEps[directions::X2]+=GAMMA_EPS;
-	  XCoordsMinusEps[directions::X2]-=GAMMA_EPS;
-	  XCoordsToxCoords(XCoordsPlusEps,xCoordsPlusEps);      
-	  XCoordsToxCoords(XCoordsMinusEps,xCoordsMinusEps);
-	  dr_dX2 = (xCoordsPlusEps[directions::X1]-xCoordsMinusEps[directions::X1])/(2.*GAMMA_EPS);
-	  dtheta_dX2 = (xCoordsPlusEps[directions::X2]-xCoordsMinusEps[directions::X2])/(2.*GAMMA_EPS);
-	}
-
-      dr_dX1.eval();
-      dtheta_dX1.eval();
-      dr_dX2.eval();
-      dtheta_dX2.eval();
+      array dxdX[2][2];
+      setMapJacobian(XCoords, xCoords, dxdX);
+      array dr_dX1     = dxdX[0][0];
+      array dr_dX2     = dxdX[0][1];
+      array dtheta_dX1 = dxdX[1][0];
+      array dtheta_dX2 = dxdX[1][1];
 
       array sigma =  r*r + af::pow(blackHoleSpin * af::cos(theta), 2.);
       sigma.eval();
@@ -418,6 +1086,18 @@ void geometry::XCoordsToxCoords(const array XCoords[3],
       xCoords[directions::X2] = ThetaNoCyl(XCoords[directions::X1],XCoords[directions::X2]); 
       xCoords[directions::X3] = XCoords[directions::X3];
 
+      /* Tabulated maps replace r(X1) and theta(X2) */
+      for (int i=0; i<2; i++)
+      {
+        if (tabulatedMaps[i].isLoaded())
+        {
+          array dxdX, d2xdX2;
+          tabulatedMaps[i].evaluate(XCoords[directions::X1 + i],
+                                    xCoords[directions::X1 + i], dxdX, d2xdX2
+                                   );
+        }
+      }
+
       xCoords[directions::X1].eval();
       xCoords[directions::X2].eval();
       xCoords[directions::X3].eval();
@@ -549,13 +1229,21 @@ void geometry::computeGammaDownDownDown(const int eta,
 
 geometry::~geometry()
 {
+  releaseGrids();
 }
 
-void geometry::setgCovGrid()
+/* Grids with copies of the geometry, for dumps and for Numpy. Each one has
+ * its own DMDA and vectors, so they are created on the first call of their
+ * get function and kept until releaseGrids(). Every call copies the current
+ * arrays into the grid. */
+grid *geometry::getgCovGrid()
 {
-  gCovGrid = new grid(N1, N2, N3, dim, 16, numGhost,
-                      false, false, false
-                     );
+  if (gCovGrid == NULL)
+  {
+    gCovGrid = new grid(N1, N2, N3, dim, 16, numGhost,
+                        false, false, false
+                       );
+  }
 
   for (int mu=0; mu<NDIM; mu++)
   {
@@ -564,13 +1252,17 @@ void geometry::setgCovGrid()
       gCovGrid->vars[nu + NDIM*mu] = gCov[mu][nu];
     }
   }
+  return gCovGrid;
 }
 
-void geometry::setgConGrid()
+grid *geometry::getgConGrid()
 {
-  gConGrid = new grid(N1, N2, N3, dim, 16, numGhost,
-                      false, false, false
-                     );
+  if (gConGrid == NULL)
+  {
+    gConGrid = new grid(N1, N2, N3, dim, 16, numGhost,
+                        false, false, false
+                       );
+  }
 
   for (int mu=0; mu<NDIM; mu++)
   {
@@ -579,31 +1271,43 @@ void geometry::setgConGrid()
       gConGrid->vars[nu + NDIM*mu] = gCon[mu][nu];
     }
   }
+  return gConGrid;
 }
 
-void geometry::setgGrid()
+grid *geometry::getgGrid()
 {
-  gGrid = new grid(N1, N2, N3, dim, 1, numGhost,
-                   false, false, false
-                  );
+  if (gGrid == NULL)
+  {
+    gGrid = new grid(N1, N2, N3, dim, 1, numGhost,
+                     false, false, false
+                    );
+  }
 
   gGrid->vars[0] = g;
+  return gGrid;
 }
 
-void geometry::setalphaGrid()
+grid *geometry::getalphaGrid()
 {
-  alphaGrid = new grid(N1, N2, N3, dim, 1, numGhost,
-                       false, false, false
-                      );
+  if (alphaGrid == NULL)
+  {
+    alphaGrid = new grid(N1, N2, N3, dim, 1, numGhost,
+                         false, false, false
+                        );
+  }
 
   alphaGrid->vars[0] = alpha;
+  return alphaGrid;
 }
 
-void geometry::setgammaUpDownDownGrid()
+grid *geometry::getgammaUpDownDownGrid()
 {
-  gammaUpDownDownGrid = new grid(N1, N2, N3, dim, 64, numGhost,
-                                 false, false, false
-                                );
+  if (gammaUpDownDownGrid == NULL)
+  {
+    gammaUpDownDownGrid = new grid(N1, N2, N3, dim, 64, numGhost,
+                                   false, false, false
+                                  );
+  }
 
   for (int mu=0; mu<NDIM; mu++)
   {
@@ -616,17 +1320,37 @@ void geometry::setgammaUpDownDownGrid()
       }
     }
   }
+  return gammaUpDownDownGrid;
 }
 
-void geometry::setxCoordsGrid()
+grid *geometry::getxCoordsGrid()
 {
-  xCoordsGrid = new grid(N1, N2, N3, dim, 3, numGhost,
-                         false, false, false
-                        );
-  array xCoords[3];
-  XCoordsToxCoords(XCoords, xCoords);
+  if (xCoordsGrid == NULL)
+  {
+    xCoordsGrid = new grid(N1, N2, N3, dim, 3, numGhost,
+                           false, false, false
+                          );
+  }
 
   xCoordsGrid->vars[directions::X1] = xCoords[directions::X1];
   xCoordsGrid->vars[directions::X2] = xCoords[directions::X2];
   xCoordsGrid->vars[directions::X3] = xCoords[directions::X3];
+  return xCoordsGrid;
+}
+
+void geometry::releaseGrids()
+{
+  delete gCovGrid;
+  delete gConGrid;
+  delete gGrid;
+  delete alphaGrid;
+  delete gammaUpDownDownGrid;
+  delete xCoordsGrid;
+
+  gCovGrid            = NULL;
+  gConGrid            = NULL;
+  gGrid               = NULL;
+  alphaGrid           = NULL;
+  gammaUpDownDownGrid = NULL;
+  xCoordsGrid         = NULL;
 }
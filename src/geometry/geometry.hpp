@@ -3,6 +3,7 @@
 
 #include "../params.hpp"
 #include "../grid/grid.hpp"
+#include "coordinateMap.hpp"
 
 class geometry
 {
@@ -11,6 +12,7 @@ class geometry
     array XCoords[3];
     array xCoords[3];
     void setgCovInXCoords(const array XCoords[NDIM], array gCov[NDIM][NDIM]);
+    void setFlatMetric();
     void setgDetAndgConFromgCov(const array gCov[NDIM][NDIM],
                                 array &gDet, array gCon[NDIM][NDIM]
                                );
@@ -23,6 +25,49 @@ class geometry
                                  );
     // Change in coord value when computing metric derivatives
     double GAMMA_EPS;
+
+    /* r(X1) and theta(X2) from params::X1MapFile and params::X2MapFile, in
+     * place of GammieRadius and GammieTheta when loaded */
+    coordinateMap tabulatedMaps[2];
+
+    grid *gCovGrid;
+    grid *gConGrid;
+    grid *gGrid;
+    grid *alphaGrid;
+    grid *gammaUpDownDownGrid;
+    grid *xCoordsGrid;
+
+    void setParams(const int metric,
+                   const double blackHoleSpin,
+                   const double hSlope,
+                   const coordinatesGrid &XCoordsGrid
+                  );
+    void setCacheVars(const bool withConnectionCoeffs,
+                      std::vector<array *> &cacheVars
+                     );
+    /* Arrays in a cache file without and with the connection coefficients */
+    static const int NUM_CACHE_VARS = 3 + 10 + 10 + 2;
+    static const int NUM_CACHE_CONNECTION_VARS = NDIM*10;
+
+    /* Connection coefficients, see computeConnectionCoeffs() */
+    void computeConnectionCoeffsAnalytic();
+    void raiseConnectionCoeffs(const array gammaDownDownDown[NDIM][NDIM][NDIM]);
+    void setMapJacobian(const array XCoords[3], const array xCoords[3],
+                        array dxdX[2][2]
+                       );
+    void setMapJacobianDerivatives(const array XCoords[3],
+                                   const array xCoords[3],
+                                   array ddxdXdX[2][2][2]
+                                  );
+    void mapSecondDifferences(const array XCoords[3],
+                              const array xCoords[3],
+                              const double h,
+                              array ddxdXdX[2][2][2]
+                             ) const;
+    void setKerrSchildMetric(const array &r, const array &theta,
+                             array gKS[NDIM][NDIM],
+                             array dgKS[2][NDIM][NDIM]
+                            );
   
   public:
     int N1, N2, N3, dim, numGhost;
@@ -30,6 +75,8 @@ class geometry
     int metric;
     double blackHoleSpin;
     double hSlope;
+    /* Minkowski: the metric arrays are constants, see setFlatMetric() */
+    bool isFlat;
 
     array alpha;
     array g;
@@ -37,15 +84,28 @@ class geometry
     array gCon[NDIM][NDIM];
 
     array gammaUpDownDown[NDIM][NDIM][NDIM];
+    bool haveConnectionCoeffs;
 
     geometry(const int metric,
              const double blackHoleSpin,
              const double hSlope,
              const coordinatesGrid &XCoordsGrid
             );
+    geometry(const int metric,
+             const double blackHoleSpin,
+             const double hSlope,
+             const coordinatesGrid &XCoordsGrid,
+             const std::string cacheFileName
+            );
     ~geometry();
 
+    void dumpCache(const std::string cacheFileName);
+    /* MD5 of the geometry sources, generated by CMake, so that cached
+     * geometry from other code is not loaded */
+    static std::string sourceHash();
+
     void computeConnectionCoeffs();
+    void computeConnectionCoeffsFiniteDifference();
     void getXCoords(array tXCoords[3]) const
     {
       for(int d=0;d<3;d++) tXCoords[d]=XCoords[d];
@@ -56,20 +116,15 @@ class geometry
     }
     void XCoordsToxCoords(const array XCoords[3], array xCoords[3]) const;
 
-    /* Pointers to data on host. Needed to get data into Numpy */
-    grid *gCovGrid;
-    grid *gConGrid;
-    grid *gGrid;
-    grid *alphaGrid;
-    grid *gammaUpDownDownGrid;
-    grid *xCoordsGrid;
-
-    void setgConGrid();
-    void setgCovGrid();
-    void setgGrid();
-    void setalphaGrid();
-    void setgammaUpDownDownGrid();
-    void setxCoordsGrid();
+    /* Copies of the geometry in grids, for dumps and to get data into
+     * Numpy. Created on first use; releaseGrids() frees them. */
+    grid *getgCovGrid();
+    grid *getgConGrid();
+    grid *getgGrid();
+    grid *getalphaGrid();
+    grid *getgammaUpDownDownGrid();
+    grid *getxCoordsGrid();
+    void releaseGrids();
 };
 
 #endif /* GRIM_GEOMETRY_H_ */
@@ -17,17 +17,19 @@ cdef extern from "geometry.hpp":
     double hSlope
 
     void computeConnectionCoeffs()
+    void computeConnectionCoeffsFiniteDifference()
 
-    grid *gCovGrid
-    grid *gConGrid
-    grid *gGrid
-    grid *alphaGrid
-    grid *gammaUpDownDownGrid
-    grid *xCoordsGrid
+    grid *getgCovGrid()
+    grid *getgConGrid()
+    grid *getgGrid()
+    grid *getalphaGrid()
+    grid *getgammaUpDownDownGrid()
+    grid *getxCoordsGrid()
+    void releaseGrids()
 
-    void setgConGrid()
-    void setgCovGrid()
-    void setgGrid()
-    void setalphaGrid()
-    void setgammaUpDownDownGrid()
-    void setxCoordsGrid()
+# Map parameters of the problem, for tests of the cylindrified map
+cdef extern from "params.hpp":
+  int    paramsDoCylindrify "params::DoCylindrify"
+  double paramsX1cyl        "params::X1cyl"
+  double paramsX2cyl        "params::X2cyl"
+  double paramsX1Start      "params::X1Start"
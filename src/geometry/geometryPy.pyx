@@ -4,6 +4,7 @@ from gridPy cimport gridPy, coordinatesGridPy
 from geometryHeaders cimport geometry
 from geometryHeaders cimport METRICS_MINKOWSKI
 from geometryHeaders cimport METRICS_MODIFIED_KERR_SCHILD
+cimport geometryHeaders
 
 np.import_array()
 
@@ -11,15 +12,30 @@ np.import_array()
 MINKOWSKI             = METRICS_MINKOWSKI
 MODIFIED_KERR_SCHILD  = METRICS_MODIFIED_KERR_SCHILD
 
+def setCylindrify(int doCylindrify, double X1cyl, double X2cyl,
+                  double X1Start
+                 ):
+  """Cylindrification parameters of the map (see params.hpp) for the
+  geometries created after the call; returns the previous ones"""
+  previous = (geometryHeaders.paramsDoCylindrify,
+              geometryHeaders.paramsX1cyl, geometryHeaders.paramsX2cyl,
+              geometryHeaders.paramsX1Start
+             )
+  geometryHeaders.paramsDoCylindrify = doCylindrify
+  geometryHeaders.paramsX1cyl        = X1cyl
+  geometryHeaders.paramsX2cyl        = X2cyl
+  geometryHeaders.paramsX1Start      = X1Start
+  return previous
+
 cdef class geometryPy(object):
 
   def setGeometryPy(self):
-    gCovGridPy  = gridPy.createGridPyFromGridPtr(self.geometryPtr.gCovGrid)
-    gConGridPy  = gridPy.createGridPyFromGridPtr(self.geometryPtr.gConGrid)
-    gGridPy     = gridPy.createGridPyFromGridPtr(self.geometryPtr.gGrid)
-    alphaGridPy = gridPy.createGridPyFromGridPtr(self.geometryPtr.alphaGrid)
+    gCovGridPy  = gridPy.createGridPyFromGridPtr(self.geometryPtr.getgCovGrid())
+    gConGridPy  = gridPy.createGridPyFromGridPtr(self.geometryPtr.getgConGrid())
+    gGridPy     = gridPy.createGridPyFromGridPtr(self.geometryPtr.getgGrid())
+    alphaGridPy = gridPy.createGridPyFromGridPtr(self.geometryPtr.getalphaGrid())
 
-    xCoordsGridPy = gridPy.createGridPyFromGridPtr(self.geometryPtr.xCoordsGrid)
+    xCoordsGridPy = gridPy.createGridPyFromGridPtr(self.geometryPtr.getxCoordsGrid())
 
     self.gCov = gCovGridPy.getVars()
     self.gCov = self.gCov.reshape([4, 4, 
@@ -50,6 +66,7 @@ cdef class geometryPy(object):
                                     ]
                                    )
     self.xCoords = xCoordsGridPy.getVars()
+    self.geometryPtr.releaseGrids()
 
   def __cinit__(self, int metric = 9999, 
                       double blackHoleSpin = 9999, 
@@ -84,10 +101,17 @@ cdef class geometryPy(object):
 
   def computeConnectionCoeffs(self):
     self.geometryPtr.computeConnectionCoeffs()
-    self.geometryPtr.setgammaUpDownDownGrid()
-    gammaUpDownDownGridPy = gridPy()
-    gammaUpDownDownGridPy.setGridPtr(self.geometryPtr.gammaUpDownDownGrid)
+    self.setGammaUpDownDown()
+
+  def computeConnectionCoeffsFiniteDifference(self):
+    self.geometryPtr.computeConnectionCoeffsFiniteDifference()
+    self.setGammaUpDownDown()
+
+  def setGammaUpDownDown(self):
+    gammaUpDownDownGridPy = \
+      gridPy.createGridPyFromGridPtr(self.geometryPtr.getgammaUpDownDownGrid())
     self.gammaUpDownDown = gammaUpDownDownGridPy.getVars()
+    self.geometryPtr.releaseGrids()
     self.gammaUpDownDown = \
           self.gammaUpDownDown.reshape([4, 4, 4, 
                                         self.gammaUpDownDown.shape[1],
@@ -0,0 +1,17 @@
+# Writes OUTPUT, defining GRIM_GEOMETRY_SOURCE_HASH as the MD5 of the files
+# in SOURCES (a ;-separated list), for the geometry cache key. Run with
+# cmake -DOUTPUT=... -DSOURCES=... -P sourceHash.cmake
+set(content "")
+foreach(source ${SOURCES})
+  file(READ ${source} sourceContent)
+  set(content "${content}${sourceContent}")
+endforeach()
+string(MD5 hash "${content}")
+
+set(header "#define GRIM_GEOMETRY_SOURCE_HASH \"${hash}\"\n")
+if (EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} oldHeader)
+endif()
+if (NOT "${header}" STREQUAL "${oldHeader}")
+  file(WRITE ${OUTPUT} "${header}")
+endif()
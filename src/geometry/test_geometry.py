@@ -626,3 +626,46 @@ def test_modifiedKerrSchild_gammaUpDownDown():
   np.testing.assert_allclose(          gammaUpDownDownCheck[3][3][3],
                              geomKerrSchild.gammaUpDownDown[3][3][3]
                             )
+
+def test_modifiedKerrSchild_gammaUpDownDown_finiteDifference():
+  # The closed form connection coefficients against finite differences of
+  # the metric
+  geomFiniteDifference = geometryPy.geometryPy(geometryPy.MODIFIED_KERR_SCHILD,
+                                               blackHoleSpin, hSlope,
+                                               XCoords
+                                              )
+  geomFiniteDifference.computeConnectionCoeffsFiniteDifference()
+  np.testing.assert_allclose(geomFiniteDifference.gammaUpDownDown,
+                             geomKerrSchild.gammaUpDownDown,
+                             rtol=1e-6, atol=1e-7
+                            )
+
+def test_modifiedKerrSchild_cylindrified_gammaUpDownDown():
+  # Closed form connection coefficients of the cylindrified map, whose
+  # second derivatives are Richardson extrapolated differences (~1e-8
+  # relative), against finite differences of the metric (~1e-9). Tolerance
+  # rtol=1e-6, atol=1e-7, as for the plain map above; the ~1e-6 round-off
+  # of second differences at GAMMA_EPS alone was at the edge of it.
+  previous = geometryPy.setCylindrify(1, X1Start + 0.8*(X1End - X1Start),
+                                      0.25, X1Start
+                                     )
+  # The map is evaluated again by both connections, so the parameters stay
+  # set until the end
+  try:
+    geomCylindrified = \
+      geometryPy.geometryPy(geometryPy.MODIFIED_KERR_SCHILD,
+                            blackHoleSpin, hSlope,
+                            XCoords
+                           )
+    # The map has been changed
+    assert np.max(np.abs(geomCylindrified.xCoords[1] - theta)) > 1e-3
+
+    geomCylindrified.computeConnectionCoeffs()
+    gammaClosedForm = geomCylindrified.gammaUpDownDown.copy()
+    geomCylindrified.computeConnectionCoeffsFiniteDifference()
+    np.testing.assert_allclose(geomCylindrified.gammaUpDownDown,
+                               gammaClosedForm,
+                               rtol=1e-6, atol=1e-7
+                              )
+  finally:
+    geometryPy.setCylindrify(*previous)
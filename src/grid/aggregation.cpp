@@ -0,0 +1,248 @@
+#include "grid.hpp"
+#include <algorithm>
+#include <climits>
+
+/* Aggregated output: the ranks are split into groups of consecutive ranks,
+ * either within each node (aggregatorsPerNode groups per node) or across
+ * nodes (groupSize ranks per group, for runs with few ranks per node), and
+ * one rank per group, the aggregator, gathers the blocks of its group and
+ * writes them. Only the aggregators open the file.
+ * The dataset is the one VecView() writes for a DMDA vector, N3 x N2 x N1 x
+ * numVars (dimensions beyond dim, and numVars if 1, left out), so grid::load()
+ * and the Python readers read either. */
+
+MPI_Comm grid::ioGroupComm  = MPI_COMM_NULL;
+MPI_Comm grid::ioWriterComm = MPI_COMM_NULL;
+int grid::ioAggregation[2] = {0, 0};
+
+void grid::setIOAggregation(const int aggregatorsPerNode,
+                            const int groupSize
+                           )
+{
+  /* The groups are split once, and again only if the parameters change */
+  if (ioGroupComm != MPI_COMM_NULL)
+  {
+    if (   ioAggregation[0] == aggregatorsPerNode
+        && ioAggregation[1] == groupSize
+       )
+    {
+      return;
+    }
+    MPI_Comm_free(&ioGroupComm);
+    if (ioWriterComm != MPI_COMM_NULL)
+    {
+      MPI_Comm_free(&ioWriterComm);
+    }
+  }
+  ioAggregation[0] = aggregatorsPerNode;
+  ioAggregation[1] = groupSize;
+
+  int worldRank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &worldRank);
+
+  if (groupSize > 0)
+  {
+    MPI_Comm_split(PETSC_COMM_WORLD, worldRank/groupSize, worldRank,
+                   &ioGroupComm
+                  );
+  }
+  else
+  {
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(PETSC_COMM_WORLD, MPI_COMM_TYPE_SHARED, worldRank,
+                        MPI_INFO_NULL, &nodeComm
+                       );
+    int nodeRank, nodeSize;
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    MPI_Comm_size(nodeComm, &nodeSize);
+
+    const int numGroups = std::max(1, std::min(aggregatorsPerNode, nodeSize));
+    const int group     = (nodeRank*numGroups)/nodeSize;
+    MPI_Comm_split(nodeComm, group, nodeRank, &ioGroupComm);
+    MPI_Comm_free(&nodeComm);
+  }
+
+  int groupRank;
+  MPI_Comm_rank(ioGroupComm, &groupRank);
+  MPI_Comm_split(PETSC_COMM_WORLD, (groupRank == 0) ? 0 : MPI_UNDEFINED,
+                 worldRank, &ioWriterComm
+                );
+}
+
+void grid::dumpAggregated(const std::string varsName,
+                          const std::string fileName
+                         )
+{
+  setIOAggregation(params::ioAggregatorsPerNode,
+                   params::ioAggregationGroupSize
+                  );
+  copyVarsToGlobalVec();
+
+  /* The block of each rank, in the order of the file: X3, X2, X1, var */
+  int box[6] = {kLocalStart, jLocalStart, iLocalStart,
+                N3Local,     N2Local,     N1Local
+               };
+  long long blockSize = (long long) N1Local*N2Local*N3Local*numVars;
+
+  int groupRank, groupSize;
+  MPI_Comm_rank(ioGroupComm, &groupRank);
+  MPI_Comm_size(ioGroupComm, &groupSize);
+
+  /* The blocks of a group can exceed the int counts and offsets of
+   * MPI_Gatherv(): sizes and offsets are 64 bit, and each block travels in
+   * messages of at most INT_MAX doubles, which arrive in order */
+  std::vector<int> boxes(6*groupSize);
+  std::vector<long long> blockSizes(groupSize);
+  std::vector<long long> blockOffsets(groupSize + 1, 0);
+  MPI_Gather(box, 6, MPI_INT, &boxes[0], 6, MPI_INT, 0, ioGroupComm);
+  MPI_Gather(&blockSize, 1, MPI_LONG_LONG, &blockSizes[0], 1, MPI_LONG_LONG,
+             0, ioGroupComm
+            );
+  for (int rank=0; rank < groupSize; rank++)
+  {
+    blockOffsets[rank + 1] = blockOffsets[rank] + blockSizes[rank];
+  }
+
+  std::vector<double> blocks(groupRank == 0 ? blockOffsets[groupSize] : 0);
+  double *globalVecPtr;
+  VecGetArray(globalVec, &globalVecPtr);
+  std::vector<MPI_Request> requests;
+  if (groupRank == 0)
+  {
+    std::copy(globalVecPtr, globalVecPtr + blockSize, blocks.begin());
+    for (int rank=1; rank < groupSize; rank++)
+    {
+      for (long long start=0; start < blockSizes[rank]; start += INT_MAX)
+      {
+        requests.push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(&blocks[blockOffsets[rank] + start],
+                  (int) std::min<long long>(INT_MAX, blockSizes[rank] - start),
+                  MPI_DOUBLE, rank, 0, ioGroupComm, &requests.back()
+                 );
+      }
+    }
+  }
+  else
+  {
+    for (long long start=0; start < blockSize; start += INT_MAX)
+    {
+      requests.push_back(MPI_REQUEST_NULL);
+      MPI_Isend(globalVecPtr + start,
+                (int) std::min<long long>(INT_MAX, blockSize - start),
+                MPI_DOUBLE, 0, 0, ioGroupComm, &requests.back()
+               );
+    }
+  }
+  if (requests.size() > 0)
+  {
+    MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+  }
+  VecRestoreArray(globalVec, &globalVecPtr);
+
+  if (ioWriterComm != MPI_COMM_NULL)
+  {
+    /* Pack the blocks into one contiguous buffer, in the order in which
+     * HDF5 traverses the union of the blocks in the file: X3, X2 and then
+     * the blocks along X1 in increasing iStart. Each line of a block, its
+     * N1Local x numVars zones at one (k, j), is contiguous both in the block
+     * and in the file. Empty blocks contribute nothing. */
+    int lower[3] = {N3, N2, N1}, upper[3] = {0, 0, 0};
+    std::vector<int> ranksAlongX1;
+    for (int rank=0; rank < groupSize; rank++)
+    {
+      const int *rankBox = &boxes[6*rank];
+      if (rankBox[3]*rankBox[4]*rankBox[5] == 0)
+      {
+        continue;
+      }
+      ranksAlongX1.push_back(rank);
+      for (int d=0; d < 3; d++)
+      {
+        lower[d] = std::min(lower[d], rankBox[d]);
+        upper[d] = std::max(upper[d], rankBox[d] + rankBox[3 + d]);
+      }
+    }
+    std::sort(ranksAlongX1.begin(), ranksAlongX1.end(),
+              [&boxes](const int a, const int b)
+              {
+                return boxes[6*a + 2] < boxes[6*b + 2];
+              }
+             );
+
+    std::vector<double> packed(blockOffsets[groupSize]);
+    size_t packedEnd = 0;
+    for (int k=lower[0]; k < upper[0]; k++)
+    {
+      for (int j=lower[1]; j < upper[1]; j++)
+      {
+        for (int rank : ranksAlongX1)
+        {
+          const int *rankBox = &boxes[6*rank];
+          if (   k < rankBox[0] || k >= rankBox[0] + rankBox[3]
+              || j < rankBox[1] || j >= rankBox[1] + rankBox[4]
+             )
+          {
+            continue;
+          }
+          const size_t line = (size_t) numVars*rankBox[5];
+          const double *lineStart
+            =   blocks.data() + blockOffsets[rank]
+              + line*(j - rankBox[1] + (size_t) rankBox[4]*(k - rankBox[0]));
+          std::copy(lineStart, lineStart + line, &packed[packedEnd]);
+          packedEnd += line;
+        }
+      }
+    }
+
+    /* Dimensions of the dataset, as VecView() sets them */
+    const int firstDim = 3 - dim;
+    const int dataRank = dim + (numVars > 1);
+    const hsize_t dims[4]   = {(hsize_t) N3, (hsize_t) N2, (hsize_t) N1,
+                               (hsize_t) numVars
+                              };
+    const hsize_t memDims[1] = {(hsize_t) packed.size()};
+
+    PetscViewer viewer;
+    PetscViewerHDF5Open(ioWriterComm,
+                        fileName.c_str(), FILE_MODE_WRITE, &viewer
+                       );
+    hid_t fileId;
+    PetscViewerHDF5GetFileId(viewer, &fileId);
+
+    hid_t fileSpace = H5Screate_simple(dataRank, &dims[firstDim], NULL);
+    hid_t memSpace  = H5Screate_simple(1, memDims, NULL);
+    H5Sselect_none(fileSpace);
+    for (int rank : ranksAlongX1)
+    {
+      const int *rankBox = &boxes[6*rank];
+      hsize_t start[4] = {(hsize_t) rankBox[0], (hsize_t) rankBox[1],
+                          (hsize_t) rankBox[2], 0
+                         };
+      hsize_t count[4] = {(hsize_t) rankBox[3], (hsize_t) rankBox[4],
+                          (hsize_t) rankBox[5], (hsize_t) numVars
+                         };
+      H5Sselect_hyperslab(fileSpace, H5S_SELECT_OR, &start[firstDim], NULL,
+                          &count[firstDim], NULL
+                         );
+    }
+
+    hid_t dataset = H5Dcreate2(fileId, varsName.c_str(), H5T_NATIVE_DOUBLE,
+                               fileSpace, H5P_DEFAULT, H5P_DEFAULT,
+                               H5P_DEFAULT
+                              );
+    hid_t transfer = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(transfer, H5FD_MPIO_COLLECTIVE);
+    H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memSpace, fileSpace, transfer,
+             packed.size() > 0 ? &packed[0] : NULL
+            );
+
+    H5Pclose(transfer);
+    H5Dclose(dataset);
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    PetscViewerDestroy(&viewer);
+  }
+
+  /* The file is complete once dump() returns on any rank */
+  MPI_Barrier(PETSC_COMM_WORLD);
+}
@@ -0,0 +1,310 @@
+#include "grid.hpp"
+#include <sys/stat.h>
+#include <algorithm>
+#include <cmath>
+
+void grid::setOwnershipRanges(const std::vector<PetscInt> &lx,
+                              const std::vector<PetscInt> &ly,
+                              const std::vector<PetscInt> &lz
+                             )
+{
+  ownershipRanges[0] = lx;
+  ownershipRanges[1] = ly;
+  ownershipRanges[2] = lz;
+}
+
+/* Split a line of zones into numParts contiguous pieces of about equal cost,
+ * each with at least minZones zones. Returns false if that is impossible. */
+static bool splitLine(const std::vector<double> &lineCost,
+                      const int numParts,
+                      const int minZones,
+                      std::vector<PetscInt> &ranges
+                     )
+{
+  const int N = lineCost.size();
+  if (numParts*minZones > N)
+  {
+    return false;
+  }
+
+  std::vector<double> cumulativeCost(N+1, 0.);
+  for (int i=0; i < N; i++)
+  {
+    cumulativeCost[i+1] = cumulativeCost[i] + lineCost[i];
+  }
+  const double totalCost = cumulativeCost[N];
+
+  ranges.resize(numParts);
+  int start = 0;
+  for (int part=0; part < numParts-1; part++)
+  {
+    const double target = totalCost*(part+1)/numParts;
+
+    /* Move the end of this part to the boundary closest to the target,
+     * leaving enough zones for the parts that follow */
+    int end    = start + minZones;
+    int endMax = N - (numParts - part - 1)*minZones;
+    while (   end < endMax
+           &&   fabs(cumulativeCost[end+1] - target)
+              <= fabs(cumulativeCost[end]   - target)
+          )
+    {
+      end++;
+    }
+    ranges[part] = end - start;
+    start        = end;
+  }
+  ranges[numParts-1] = N - start;
+
+  return true;
+}
+
+/* Rectilinear decomposition of the zoneCost map (natural order, i fastest)
+ * over numProcs ranks. Every factorization numProcs = m x n x p is tried;
+ * the lines along each direction are split by their summed cost, and the
+ * factorization with the cheapest most expensive rank is kept (the one with
+ * the fewest faces between ranks when that is within 0.1%). Returns the
+ * predicted imbalance (max/avg cost per rank), or 0 if no decomposition was
+ * set. */
+double grid::balanceOwnershipRanges(const std::vector<double> &zoneCost,
+                                    const int N1,
+                                    const int N2,
+                                    const int N3,
+                                    const int dim,
+                                    const int numGhost,
+                                    const int numProcs
+                                   )
+{
+  const int N[3] = {N1, (dim > 1 ? N2 : 1), (dim > 2 ? N3 : 1)};
+
+  /* Cost summed over the planes normal to each direction */
+  std::vector<double> lineCost[3];
+  double totalCost = 0.;
+  for (int d=0; d < 3; d++)
+  {
+    lineCost[d].assign(N[d], 0.);
+  }
+  for (int k=0; k < N[2]; k++)
+  {
+    for (int j=0; j < N[1]; j++)
+    {
+      for (int i=0; i < N[0]; i++)
+      {
+        double cost = zoneCost[i + N[0]*(j + N[1]*k)];
+        lineCost[0][i] += cost;
+        lineCost[1][j] += cost;
+        lineCost[2][k] += cost;
+        totalCost      += cost;
+      }
+    }
+  }
+  if (totalCost <= 0.)
+  {
+    return 0.;
+  }
+
+  double bestMaxCost = -1.;
+  double bestSurface = 0.;
+  std::vector<PetscInt> bestRanges[3];
+  for (int m=1; m <= numProcs; m++)
+  {
+    for (int n=1; m*n <= numProcs; n++)
+    {
+      if (numProcs % (m*n) != 0)
+      {
+        continue;
+      }
+      const int numParts[3] = {m, n, numProcs/(m*n)};
+      if (   (dim < 2 && numParts[1] > 1)
+          || (dim < 3 && numParts[2] > 1)
+         )
+      {
+        continue;
+      }
+
+      std::vector<PetscInt> ranges[3];
+      std::vector<int> zonePart[3];
+      bool possible = true;
+      for (int d=0; d < 3 && possible; d++)
+      {
+        const int minZones = (d < dim ? numGhost : 1);
+        possible = splitLine(lineCost[d], numParts[d], minZones, ranges[d]);
+        if (possible)
+        {
+          for (int part=0; part < numParts[d]; part++)
+          {
+            zonePart[d].insert(zonePart[d].end(), ranges[d][part], part);
+          }
+        }
+      }
+      if (!possible)
+      {
+        continue;
+      }
+
+      std::vector<double> rankCost(numProcs, 0.);
+      for (int k=0; k < N[2]; k++)
+      {
+        for (int j=0; j < N[1]; j++)
+        {
+          for (int i=0; i < N[0]; i++)
+          {
+            int rank =   zonePart[0][i]
+                       + m*(zonePart[1][j] + n*zonePart[2][k]);
+            rankCost[rank] += zoneCost[i + N[0]*(j + N[1]*k)];
+          }
+        }
+      }
+
+      double maxCost = *std::max_element(rankCost.begin(), rankCost.end());
+      double surface =   (numParts[0]-1)*(double)N[1]*N[2]
+                       + (numParts[1]-1)*(double)N[0]*N[2]
+                       + (numParts[2]-1)*(double)N[0]*N[1];
+      if (   bestMaxCost < 0.
+          || maxCost < (1. - 1.e-3)*bestMaxCost
+          || (maxCost <= (1. + 1.e-3)*bestMaxCost && surface < bestSurface)
+         )
+      {
+        bestMaxCost = maxCost;
+        bestSurface = surface;
+        for (int d=0; d < 3; d++)
+        {
+          bestRanges[d] = ranges[d];
+        }
+      }
+    }
+  }
+  if (bestMaxCost < 0.)
+  {
+    return 0.;
+  }
+
+  for (int d=dim; d < 3; d++)
+  {
+    bestRanges[d].clear();
+  }
+  setOwnershipRanges(bestRanges[0], bestRanges[1], bestRanges[2]);
+
+  return bestMaxCost/(totalCost/numProcs);
+}
+
+/* Set the ownership ranges from a cost map written by a previous run (see
+ * timeStepper::dumpZoneCost). Does nothing if the file does not exist or is
+ * for another grid. */
+void grid::loadOwnershipRanges(const std::string fileName,
+                               const int N1,
+                               const int N2,
+                               const int N3,
+                               const int dim,
+                               const int numGhost
+                              )
+{
+  struct stat fileInfo;
+  if (stat(fileName.c_str(), &fileInfo) != 0)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  Cost map %s not found, using an even decomposition\n",
+                fileName.c_str()
+               );
+    return;
+  }
+
+  /* A map for another grid, or one without the grid attributes, would be
+   * read with the wrong layout */
+  PetscInt gridSize[4] = {0, 0, 0, 0};
+  {
+    PetscViewer viewer;
+    PetscViewerHDF5Open(PETSC_COMM_WORLD,
+                        fileName.c_str(), FILE_MODE_READ, &viewer
+                       );
+    hid_t fileId;
+    PetscViewerHDF5GetFileId(viewer, &fileId);
+    if (H5Aexists_by_name(fileId, "zoneCost", "dim", H5P_DEFAULT) > 0)
+    {
+      PetscViewerHDF5ReadAttribute(viewer, "zoneCost", "N1",
+                                   PETSC_INT, &gridSize[0]
+                                  );
+      PetscViewerHDF5ReadAttribute(viewer, "zoneCost", "N2",
+                                   PETSC_INT, &gridSize[1]
+                                  );
+      PetscViewerHDF5ReadAttribute(viewer, "zoneCost", "N3",
+                                   PETSC_INT, &gridSize[2]
+                                  );
+      PetscViewerHDF5ReadAttribute(viewer, "zoneCost", "dim",
+                                   PETSC_INT, &gridSize[3]
+                                  );
+    }
+    PetscViewerDestroy(&viewer);
+  }
+  if (   gridSize[0] != N1 || gridSize[1] != N2
+      || gridSize[2] != N3 || gridSize[3] != dim
+     )
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  WARNING: cost map %s is for a %d x %d x %d grid in %dD, "
+                "not %d x %d x %d in %dD; using an even decomposition\n",
+                fileName.c_str(),
+                (int)gridSize[0], (int)gridSize[1], (int)gridSize[2],
+                (int)gridSize[3], N1, N2, N3, dim
+               );
+    return;
+  }
+
+  int rank, numProcs;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+  MPI_Comm_size(PETSC_COMM_WORLD, &numProcs);
+
+  /* Only rank 0 holds the whole map and balances it; the other ranks get
+   * the ranges it chose */
+  std::vector<double> zoneCost;
+  {
+    /* Read with PETSc's even split, before the ranges are set */
+    grid costMap(N1, N2, N3, dim, 1, numGhost, false, false, false);
+    costMap.load("zoneCost", fileName);
+    costMap.gatherToZero(0, zoneCost);
+  }
+
+  double imbalance = 0.;
+  if (rank == 0)
+  {
+    imbalance = balanceOwnershipRanges(zoneCost, N1, N2, N3, dim,
+                                       numGhost, numProcs
+                                      );
+  }
+  MPI_Bcast(&imbalance, 1, MPI_DOUBLE, 0, PETSC_COMM_WORLD);
+  if (imbalance == 0.)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  Cost map %s unusable, using an even decomposition\n",
+                fileName.c_str()
+               );
+    return;
+  }
+
+  int numRanges[3];
+  for (int d=0; d < 3; d++)
+  {
+    numRanges[d] = ownershipRanges[d].size();
+  }
+  MPI_Bcast(numRanges, 3, MPI_INT, 0, PETSC_COMM_WORLD);
+  std::vector<PetscInt> ranges[3];
+  for (int d=0; d < 3; d++)
+  {
+    ranges[d] = ownershipRanges[d];
+    ranges[d].resize(numRanges[d]);
+    if (numRanges[d] > 0)
+    {
+      MPI_Bcast(&ranges[d][0], numRanges[d], MPIU_INT, 0, PETSC_COMM_WORLD);
+    }
+  }
+  setOwnershipRanges(ranges[0], ranges[1], ranges[2]);
+
+  PetscPrintf(PETSC_COMM_WORLD,
+              "  Decomposition from %s : %i x %i x %i ranks, predicted imbalance %g (max/avg)\n",
+              fileName.c_str(),
+              (int)ownershipRanges[0].size(),
+              (int)std::max<size_t>(ownershipRanges[1].size(), 1),
+              (int)std::max<size_t>(ownershipRanges[2].size(), 1),
+              imbalance
+             );
+}
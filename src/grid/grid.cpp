@@ -1,5 +1,7 @@
 #include "grid.hpp"
 
+std::vector<PetscInt> grid::ownershipRanges[3];
+
 grid::grid(const int N1,
            const int N2,
            const int N3,
@@ -58,6 +60,18 @@ grid::grid(const int N1,
     DMBoundaryBack  = DM_BOUNDARY_PERIODIC;
   }
 
+  /* Ownership ranges along each direction, or PETSc's even split */
+  PetscInt numProcs[3]        = {PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE};
+  const PetscInt *ranges[3]   = {PETSC_NULL, PETSC_NULL, PETSC_NULL};
+  for (int d=0; d < dim; d++)
+  {
+    if (!ownershipRanges[d].empty())
+    {
+      numProcs[d] = ownershipRanges[d].size();
+      ranges[d]   = &ownershipRanges[d][0];
+    }
+  }
+
   switch (dim)
   {
     case 1:
@@ -70,7 +84,7 @@ grid::grid(const int N1,
       domainX3 = new af::seq(span);
 
       DMDACreate1d(PETSC_COMM_WORLD, DMBoundaryLeft, 
-                   N1, numVars, numGhostX1, NULL,
+                   N1, numVars, numGhostX1, ranges[0],
                    &dm
                   );
 
@@ -89,9 +103,9 @@ grid::grid(const int N1,
                    DMBoundaryLeft, DMBoundaryBottom,
                    DMDA_STENCIL_BOX,
                    N1, N2,
-                   PETSC_DECIDE, PETSC_DECIDE,
+                   numProcs[0], numProcs[1],
                    numVars, numGhostX1,
-                   PETSC_NULL, PETSC_NULL,
+                   ranges[0], ranges[1],
                    &dm
                   );
 
@@ -110,9 +124,9 @@ grid::grid(const int N1,
                    DMBoundaryLeft, DMBoundaryBottom, DMBoundaryBack,
                    DMDA_STENCIL_BOX,
                    N1, N2, N3,
-                   PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE,
+                   numProcs[0], numProcs[1], numProcs[2],
                    numVars, numGhostX1,
-                   PETSC_NULL, PETSC_NULL, PETSC_NULL,
+                   ranges[0], ranges[1], ranges[2],
                    &dm
                   );
 
@@ -303,13 +317,22 @@ void grid::copyHostPtrToVars(const double *hostPtr)
 
 void grid::communicate()
 {
+  PROFILE_SCOPE("communicate");
+  PROFILE_BEGIN("copy to PETSc");
   copyVarsToGlobalVec();
+  PROFILE_END();
 
+  PROFILE_BEGIN("DMGlobalToLocalBegin");
   DMGlobalToLocalBegin(dm, globalVec, INSERT_VALUES, localVec);
+  PROFILE_END();
+  PROFILE_BEGIN("DMGlobalToLocalEnd");
   DMGlobalToLocalEnd(dm, globalVec, INSERT_VALUES, localVec);
+  PROFILE_END();
 
   /* Now copy data from localVec to vars */
+  PROFILE_BEGIN("copy from PETSc");
   copyLocalVecToVars();
+  PROFILE_END();
 }
 
 void grid::copyVarsToGlobalVec()
@@ -364,6 +387,12 @@ coordinatesGrid::~coordinatesGrid()
 
 void grid::dump(const std::string varsName, const std::string fileName)
 {
+  PROFILE_SCOPE("dump");
+  if (params::ioAggregatorsPerNode > 0 || params::ioAggregationGroupSize > 0)
+  {
+    dumpAggregated(varsName, fileName);
+    return;
+  }
   copyVarsToGlobalVec();
 
   PetscViewer viewer;
@@ -383,6 +412,7 @@ void grid::dumpVTS(const grid &xCoords,
                    const std::string fileName
                   )
 {
+  PROFILE_SCOPE("dump VTS");
   if (havexCoordsBeenSet == 0)
   {
     DMDASetUniformCoordinates(dm,0.0,1.0,0.0,1.0,0.0,1.0);
@@ -472,6 +502,7 @@ void grid::dumpVTS(const grid &xCoords,
 
 void grid::load(const std::string varsName, const std::string fileName)
 {
+  PROFILE_SCOPE("load");
   PetscViewer viewer;
   PetscViewerHDF5Open(PETSC_COMM_WORLD, 
                       fileName.c_str(), FILE_MODE_READ, &viewer
@@ -489,6 +520,60 @@ void grid::load(const std::string varsName, const std::string fileName)
   copyLocalVecToVars();
 }
 
+void grid::gatherToAll(const int var, std::vector<double> &values)
+{
+  gatherNatural(var, true, values);
+}
+
+void grid::gatherToZero(const int var, std::vector<double> &values)
+{
+  gatherNatural(var, false, values);
+}
+
+/* Copy one variable of the whole grid, in natural (i fastest) order, to
+ * every rank (toAll) or to rank 0 */
+void grid::gatherNatural(const int var, const bool toAll,
+                         std::vector<double> &values
+                        )
+{
+  copyVarsToGlobalVec();
+
+  Vec naturalVec, allVec;
+  DMDACreateNaturalVector(dm, &naturalVec);
+  DMDAGlobalToNaturalBegin(dm, globalVec, INSERT_VALUES, naturalVec);
+  DMDAGlobalToNaturalEnd(dm, globalVec, INSERT_VALUES, naturalVec);
+
+  VecScatter scatter;
+  if (toAll)
+  {
+    VecScatterCreateToAll(naturalVec, &scatter, &allVec);
+  }
+  else
+  {
+    VecScatterCreateToZero(naturalVec, &scatter, &allVec);
+  }
+  VecScatterBegin(scatter, naturalVec, allVec, INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterEnd(scatter, naturalVec, allVec, INSERT_VALUES, SCATTER_FORWARD);
+
+  /* Empty on the ranks other than 0 without toAll */
+  PetscInt allSize;
+  VecGetLocalSize(allVec, &allSize);
+
+  const PetscScalar *allPtr;
+  VecGetArrayRead(allVec, &allPtr);
+  const int numZones = allSize/numVars;
+  values.resize(numZones);
+  for (int zone=0; zone < numZones; zone++)
+  {
+    values[zone] = allPtr[var + numVars*zone];
+  }
+  VecRestoreArrayRead(allVec, &allPtr);
+
+  VecScatterDestroy(&scatter);
+  VecDestroy(&allVec);
+  VecDestroy(&naturalVec);
+}
+
 grid::~grid()
 {
   if (hasHostPtrBeenAllocated)
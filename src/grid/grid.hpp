@@ -2,9 +2,11 @@
 #define GRIM_GRID_H_
 
 #include "../params.hpp"
+#include "../profiler/profiler.hpp"
 #include <petsc.h>
 #include <petscviewerhdf5.h>
 #include <arrayfire.h>
+#include <vector>
 
 using af::array;
 using af::span;
@@ -63,11 +65,53 @@ class grid
     void copyVarsToGlobalVec();
     void copyHostPtrToVars(const double *hostPtr);
     void dump(const std::string varsName, const std::string filename);
+    /* dump() through params::ioAggregatorsPerNode ranks per node, or one
+     * rank per params::ioAggregationGroupSize ranks, see aggregation.cpp */
+    void dumpAggregated(const std::string varsName,
+                        const std::string fileName
+                       );
+    static MPI_Comm ioGroupComm, ioWriterComm;
+    /* aggregatorsPerNode and groupSize the communicators were split with */
+    static int ioAggregation[2];
+    static void setIOAggregation(const int aggregatorsPerNode,
+                                 const int groupSize
+                                );
     void dumpVTS(const grid &xCoords,
                  const std::string *varNames,
                  const std::string filename
                 );
     void load(const std::string varsName, const std::string filename);
+    /* One variable of the whole grid in natural order, on every rank or on
+     * rank 0 only (values is left empty on the others) */
+    void gatherToAll(const int var, std::vector<double> &values);
+    void gatherToZero(const int var, std::vector<double> &values);
+    void gatherNatural(const int var, const bool toAll,
+                       std::vector<double> &values
+                      );
+
+    /* Zones owned by each rank along X1, X2 and X3 (the DMDA lx, ly, lz).
+     * When empty, PETSc splits the zones evenly. All grids must share one
+     * decomposition, so set these before the first grid is created. */
+    static std::vector<PetscInt> ownershipRanges[3];
+    static void setOwnershipRanges(const std::vector<PetscInt> &lx,
+                                   const std::vector<PetscInt> &ly,
+                                   const std::vector<PetscInt> &lz
+                                  );
+    static double balanceOwnershipRanges(const std::vector<double> &zoneCost,
+                                         const int N1,
+                                         const int N2,
+                                         const int N3,
+                                         const int dim,
+                                         const int numGhost,
+                                         const int numProcs
+                                        );
+    static void loadOwnershipRanges(const std::string fileName,
+                                    const int N1,
+                                    const int N2,
+                                    const int N3,
+                                    const int dim,
+                                    const int numGhost
+                                   );
 };
 
 class coordinatesGrid : public grid
@@ -1,3 +1,13 @@
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+cdef extern from "petsc.h":
+  ctypedef int PetscInt
+
+cdef extern from "arrayfire.h" namespace "af":
+  cdef cppclass array:
+    pass
+
 cdef extern from "grid.hpp":
   cdef enum:
     LOCATIONS_BACK   "locations::BACK"
@@ -36,10 +46,19 @@ cdef extern from "grid.hpp":
     int periodicBoundariesX2
     int periodicBoundariesX3
 
+    array *vars
     double *hostPtr
     void communicate()
     void copyVarsToHostPtr()
     void copyHostPtrToVars(const double *hostPtr)
+    void dump(const string varsName, const string filename)
+    void load(const string varsName, const string filename)
+
+  void gridSetOwnershipRanges "grid::setOwnershipRanges"(
+    const vector[PetscInt] &lx,
+    const vector[PetscInt] &ly,
+    const vector[PetscInt] &lz
+  )
 
   cdef cppclass coordinatesGrid:
     coordinatesGrid(const int N1, 
@@ -62,3 +81,8 @@ cdef extern from "grid.hpp":
     double *hostPtr
     void setXCoords(const int location)
     void copyVarsToHostPtr()
+
+# Output parameters of the problem, for tests of the aggregated dumps
+cdef extern from "params.hpp":
+  int paramsIOAggregatorsPerNode   "params::ioAggregatorsPerNode"
+  int paramsIOAggregationGroupSize "params::ioAggregationGroupSize"
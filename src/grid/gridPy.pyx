@@ -18,6 +18,8 @@ from gridHeaders cimport LOCATIONS_BACK
 from gridHeaders cimport DIRECTIONS_X1
 from gridHeaders cimport DIRECTIONS_X2
 from gridHeaders cimport DIRECTIONS_X3
+from gridHeaders cimport gridSetOwnershipRanges
+cimport gridHeaders
 
 np.import_array()
 
@@ -33,6 +35,21 @@ X1     = DIRECTIONS_X1
 X2     = DIRECTIONS_X2
 X3     = DIRECTIONS_X3
 
+def setIOAggregation(int aggregatorsPerNode, int groupSize):
+  """Aggregation parameters of dump() (see params.hpp); returns the previous
+  ones"""
+  previous = (gridHeaders.paramsIOAggregatorsPerNode,
+              gridHeaders.paramsIOAggregationGroupSize
+             )
+  gridHeaders.paramsIOAggregatorsPerNode   = aggregatorsPerNode
+  gridHeaders.paramsIOAggregationGroupSize = groupSize
+  return previous
+
+def setOwnershipRanges(lx, ly, lz):
+  """Zones owned by each rank along X1, X2 and X3 for the grids created after
+  the call; empty lists for PETSc's even split"""
+  gridSetOwnershipRanges(lx, ly, lz)
+
 cdef class gridPy(object):
 
   def __cinit__(self, const int N1 = 0,
@@ -81,6 +98,12 @@ cdef class gridPy(object):
   def communicate(self):
     self.gridPtr.communicate()
 
+  def dump(self, varsName, fileName):
+    self.gridPtr.dump(varsName.encode('utf-8'), fileName.encode('utf-8'))
+
+  def load(self, varsName, fileName):
+    self.gridPtr.load(varsName.encode('utf-8'), fileName.encode('utf-8'))
+
   cdef grid* getGridPtr(self):
     return self.gridPtr
 
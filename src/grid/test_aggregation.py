@@ -0,0 +1,119 @@
+import mpi4py, petsc4py
+import numpy as np
+import pytest
+import copy
+import os
+import shutil
+import tempfile
+import gridPy
+
+petsc4py.init()
+petscComm  = petsc4py.PETSc.COMM_WORLD
+comm = petscComm.tompi4py()
+rank = comm.Get_rank()
+numProcs = comm.Get_size()
+
+N1  = int(pytest.config.getoption('N1'))
+N2  = int(pytest.config.getoption('N2'))
+N3  = int(pytest.config.getoption('N3'))
+dim = int(pytest.config.getoption('dim'))
+numVars = 2
+periodicBoundariesX1 = True
+periodicBoundariesX2 = True
+periodicBoundariesX3 = True
+
+# Aggregation parameters (ioAggregatorsPerNode, ioAggregationGroupSize):
+# groups within the node, and groups across nodes of uneven size and larger
+# than the number of ranks
+aggregationModes = [(1, 0), (2, 0), (0, 2), (0, 3), (0, numProcs + 1)]
+
+outputDir = comm.bcast(tempfile.mkdtemp() if rank == 0 else None, root=0)
+
+def teardown_module(module):
+  comm.Barrier()
+  if rank == 0:
+    shutil.rmtree(outputDir)
+
+def makeGrid(numGhost):
+  return gridPy.gridPy(N1, N2, N3,
+                       dim, numVars, numGhost,
+                       periodicBoundariesX1,
+                       periodicBoundariesX2,
+                       periodicBoundariesX3
+                      )
+
+def domain(grid):
+  return (slice(None),
+          slice(grid.numGhostX3, grid.N3Total - grid.numGhostX3),
+          slice(grid.numGhostX2, grid.N2Total - grid.numGhostX2),
+          slice(grid.numGhostX1, grid.N1Total - grid.numGhostX1)
+         )
+
+def fillWithGlobalIndex(grid):
+  """Values unique to each zone and variable of the whole grid"""
+  i = np.arange(grid.N1Total) - grid.numGhostX1 + grid.iLocalStart
+  j = np.arange(grid.N2Total) - grid.numGhostX2 + grid.jLocalStart
+  k = np.arange(grid.N3Total) - grid.numGhostX3 + grid.kLocalStart
+  var = np.arange(numVars)
+  vars = (  var[:, None, None, None]
+          + numVars*(  i[None, None, None, :]
+                     + N1*(  j[None, None, :, None]
+                           + N2*k[None, :, None, None]
+                          )
+                    )
+          + 0.25
+         )
+  grid.setVars(vars)
+  return vars
+
+def dumpAndLoad(grid, aggregatorsPerNode, groupSize, fileName):
+  """Dump grid with the given aggregation (0, 0 for VecView()), and load
+  the file back into a new grid with the same decomposition"""
+  fileName = os.path.join(outputDir, fileName)
+  previous = gridPy.setIOAggregation(aggregatorsPerNode, groupSize)
+  try:
+    grid.dump('vars', fileName)
+  finally:
+    gridPy.setIOAggregation(*previous)
+
+  loaded = copy.copy(grid)
+  loaded.load('vars', fileName)
+  return loaded.getVars()[domain(loaded)]
+
+def checkAggregatedDumps(grid, name):
+  vars = fillWithGlobalIndex(grid)[domain(grid)]
+  reference = dumpAndLoad(grid, 0, 0, name + '_VecView.h5')
+  assert reference.tobytes() == vars.tobytes()
+
+  for aggregatorsPerNode, groupSize in aggregationModes:
+    aggregated = dumpAndLoad(grid, aggregatorsPerNode, groupSize,
+                             name + '_%d_%d.h5' % (aggregatorsPerNode,
+                                                   groupSize
+                                                  )
+                            )
+    assert aggregated.tobytes() == reference.tobytes(), \
+      'ioAggregatorsPerNode %d, ioAggregationGroupSize %d differ from VecView' \
+      % (aggregatorsPerNode, groupSize)
+
+def test_aggregated_dump():
+  checkAggregatedDumps(makeGrid(3), 'even')
+
+def test_aggregated_dump_with_empty_blocks():
+  # Every other rank along X1 owns no zones, the first aggregator included.
+  # PETSc only accepts ranks narrower than the stencil without ghost zones.
+  ownersX1 = [r for r in range(numProcs) if r % 2 == 1 or numProcs == 1]
+  lx = [0]*numProcs
+  for n, r in enumerate(ownersX1):
+    lx[r] = N1//len(ownersX1) + (n < N1 % len(ownersX1))
+  ly = [N2] if dim > 1 else []
+  lz = [N3] if dim > 2 else []
+
+  gridPy.setOwnershipRanges(lx, ly, lz)
+  try:
+    grid = makeGrid(0)
+    checkAggregatedDumps(grid, 'empty_blocks')
+  finally:
+    gridPy.setOwnershipRanges([], [], [])
+
+  if numProcs > 1:
+    assert comm.allreduce(int(grid.N1Local == 0)) > 0
@@ -10,6 +10,21 @@ int main(int argc, char **argv)
   //af::setDevice(world_rank%params::numDevices);
   af::setDevice(1);
 
+  std::string threadInfo;
+  threads::setupThreads(params::numThreads, params::pinThreads, threadInfo);
+  PetscSynchronizedPrintf(PETSC_COMM_WORLD, "  Rank %d : %s\n",
+                          world_rank, threadInfo.c_str()
+                         );
+  PetscSynchronizedFlush(PETSC_COMM_WORLD, PETSC_STDOUT);
+
+  if (params::loadBalance)
+  {
+    grid::loadOwnershipRanges(params::zoneCostFile,
+                              params::N1, params::N2, params::N3,
+                              params::dim, params::numGhost
+                             );
+  }
+
   /* Local scope so that destructors of all classes are called before
    * PetscFinalize() */
   {
@@ -26,26 +41,49 @@ int main(int argc, char **argv)
                   );
      
     PetscPrintf(PETSC_COMM_WORLD, "  Generating compute kernels...\n\n");
-    int numReads, numWrites;
-    ts.timeStep(numReads, numWrites);
+    ts.timeStep();
 
     af::sync();
 
     PetscPrintf(PETSC_COMM_WORLD, "\n  Kernel compilation complete\n");
 
+    if (params::benchmarkIdealSolver > 0)
+    {
+      ts.benchmarkIdealSolver(params::benchmarkIdealSolver);
+    }
+    if (params::benchmarkFluxTiles > 0)
+    {
+      ts.benchmarkFluxTiles(params::benchmarkFluxTiles);
+    }
+    /* Kernel compilation and benchmarks are not part of the cost map or the
+     * profile */
+    ts.resetZoneCost();
+    profiler::setup(params::profileEveryNSteps, params::profileSync,
+                    params::profileCounters,
+                    params::profileFormat, params::profileFile
+                   );
+    profiler::setupTrace(params::traceStartStep, params::traceNumSteps,
+                         params::traceFile
+                        );
+
     int n=0;
     int StopRunning = 0;
     while(ts.time<params::finalTime && StopRunning==0)
     {
       n++;
-      PetscPrintf(PETSC_COMM_WORLD, "\n|----Time step %d----|\n", n);
-      ts.timeStep(numReads, numWrites);
+      PetscPrintf(PETSC_COMM_WORLD, "\n|----Time step %d----|\n",
+                  ts.stepNumber + 1
+                 );
+      profiler::beginStep(n);
+      ts.timeStep();
       //Checkpoint if running out of time
       StopRunning = ts.CheckWallClockTermination();
+      profiler::endStep(n);
     }
+    profiler::finish();
     PetscPrintf(PETSC_COMM_WORLD, "\n===Program execution complete===\n\n");
     if(StopRunning)
-      PetscPrintf(PETSC_COMM_WORLD, "\n Termination reason: WallClock\n");
+      PetscPrintf(PETSC_COMM_WORLD, "\n Termination reason: WallClock or SIGTERM\n");
     else
       PetscPrintf(PETSC_COMM_WORLD, "\n Termination reason: Final Time\n");
   }
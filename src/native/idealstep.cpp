@@ -0,0 +1,418 @@
+#include "native.hpp"
+#include <omp.h>
+
+void native::computeConsAndSources(const grid &prim,
+                                   const geometry &geom,
+                                   grid *cons,
+                                   grid &sources
+                                  )
+{
+  const int N1Total  = prim.N1Total;
+  const int N2Total  = prim.N2Total;
+  const int N3Total  = prim.N3Total;
+  const int numZones = N1Total*N2Total*N3Total;
+
+  const bool needConnection = !geom.isFlat;
+
+  hostArrays host;
+  const double *primPtr[NUM_IDEAL_VARS];
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    primPtr[var] = host.read(prim.vars[var]);
+  }
+  geometryPtrs geomPtrs;
+  getGeometryPtrs(geom, needConnection, host, geomPtrs);
+
+  double *consPtr[NUM_IDEAL_VARS];
+  if (cons != NULL)
+  {
+    for (int var=0; var < NUM_IDEAL_VARS; var++)
+    {
+      consPtr[var] = host.write(cons->vars[var], N1Total, N2Total, N3Total);
+    }
+  }
+  double *sourcesPtr[NUM_IDEAL_VARS];
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    sourcesPtr[var] = host.write(sources.vars[var], N1Total, N2Total, N3Total);
+  }
+
+  #pragma omp parallel
+  {
+    double threadStart = omp_get_wtime();
+
+    #pragma omp for simd schedule(static) nowait
+    for (int zone=0; zone < numZones; zone++)
+    {
+      metricPoint m;
+      loadMetric(geomPtrs, zone, m);
+
+      fluidPoint f;
+      setFluidPoint(primPtr[vars::RHO][zone], primPtr[vars::U][zone],
+                    primPtr[vars::U1][zone],  primPtr[vars::U2][zone],
+                    primPtr[vars::U3][zone],
+                    primPtr[vars::B1][zone],  primPtr[vars::B2][zone],
+                    primPtr[vars::B3][zone],
+                    m, f
+                   );
+
+      if (cons != NULL)
+      {
+        double consZone[NUM_IDEAL_VARS];
+        computeFluxesPoint(f, m, 0, consZone);
+        for (int var=0; var < NUM_IDEAL_VARS; var++)
+        {
+          consPtr[var][zone] = consZone[var];
+        }
+      }
+
+      double sourcesZone[NUM_IDEAL_VARS];
+      for (int var=0; var < NUM_IDEAL_VARS; var++)
+      {
+        sourcesZone[var] = 0.;
+      }
+      if (needConnection)
+      {
+        double T[NDIM][NDIM];
+        for (int kappa=0; kappa<NDIM; kappa++)
+        {
+          for (int lamda=0; lamda<NDIM; lamda++)
+          {
+            T[kappa][lamda] = TUpDown(f, kappa, lamda);
+          }
+        }
+        for (int nu=0; nu<NDIM; nu++)
+        {
+          for (int kappa=0; kappa<NDIM; kappa++)
+          {
+            for (int lamda=0; lamda<NDIM; lamda++)
+            {
+              sourcesZone[vars::U + nu] -=
+                m.g
+              * T[kappa][lamda]
+              * geomPtrs.gammaUpDownDown[lamda][kappa][nu][zone];
+            }
+          }
+        }
+      }
+      for (int var=0; var < NUM_IDEAL_VARS; var++)
+      {
+        sourcesPtr[var][zone] = sourcesZone[var];
+      }
+    }
+
+    threads::addThreadTime(omp_get_wtime() - threadStart);
+  }
+}
+
+void native::setupFluxPencils(const grid &prim,
+                              const int dir,
+                              const geometry &geomFace,
+                              grid &fluxes,
+                              hostArrays &host,
+                              fluxPencils &pencils
+                             )
+{
+  const int N[3]      = {prim.N1Total, prim.N2Total, prim.N3Total};
+  const int stride[3] = {1, prim.N1Total, prim.N1Total*prim.N2Total};
+
+  /* Pencils along dir, enumerated by the two other directions */
+  pencils.dir        = dir;
+  pencils.lineLength = N[dir];
+  pencils.lineStride = stride[dir];
+  pencils.dirA       = (dir==directions::X1 ? directions::X2 : directions::X1);
+  pencils.dirB       = (dir==directions::X3 ? directions::X2 : directions::X3);
+  pencils.NA         = N[pencils.dirA];
+  pencils.strideA    = stride[pencils.dirA];
+  pencils.strideB    = stride[pencils.dirB];
+  pencils.numLines   = N[pencils.dirA]*N[pencils.dirB];
+
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    pencils.primPtr[var] = host.read(prim.vars[var]);
+  }
+  getGeometryPtrs(geomFace, false, host, pencils.geomFacePtrs);
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    pencils.fluxPtr[var] = host.write(fluxes.vars[var], N[0], N[1], N[2]);
+  }
+}
+
+void native::computeFluxPencils(const fluxPencils &pencils,
+                                const int lineStart,
+                                const int lineEnd,
+                                pencilScratch &scratch,
+                                std::vector<double> &faceFluxes
+                               )
+{
+  const int lineLength = pencils.lineLength;
+  const int lineStride = pencils.lineStride;
+
+  scratch.resize(lineLength + 1);
+  faceFluxes.resize(NUM_IDEAL_VARS*lineLength);
+
+  for (int line=lineStart; line < lineEnd; line++)
+  {
+    const int offset =   (line % pencils.NA)*pencils.strideA
+                       + (line / pencils.NA)*pencils.strideB;
+
+    pencilFaceFluxes(pencils.primPtr, pencils.geomFacePtrs,
+                     pencils.dir, offset, lineLength, lineStride,
+                     0, lineLength-1, scratch, &faceFluxes[0]
+                    );
+
+    for (int var=0; var < NUM_IDEAL_VARS; var++)
+    {
+      for (int i=0; i < lineLength; i++)
+      {
+        pencils.fluxPtr[var][offset + i*lineStride] =
+          faceFluxes[var*lineLength + i];
+      }
+    }
+  }
+}
+
+void native::computeFluxes(const grid &prim,
+                           const int dir,
+                           const geometry &geomFace,
+                           grid &fluxes
+                          )
+{
+  hostArrays host;
+  fluxPencils pencils;
+  setupFluxPencils(prim, dir, geomFace, fluxes, host, pencils);
+
+  #pragma omp parallel
+  {
+    double threadStart = omp_get_wtime();
+    pencilScratch scratch;
+    std::vector<double> faceFluxes;
+
+    #pragma omp for schedule(static) nowait
+    for (int line=0; line < pencils.numLines; line++)
+    {
+      computeFluxPencils(pencils, line, line+1, scratch, faceFluxes);
+    }
+
+    threads::addThreadTime(omp_get_wtime() - threadStart);
+  }
+}
+
+void native::setupDivergence(const grid &fluxesX1,
+                             const grid &fluxesX2,
+                             const grid &fluxesX3,
+                             const double dX[3],
+                             const int varStart,
+                             const int varEnd,
+                             grid &divFluxes,
+                             hostArrays &host,
+                             divergenceRows &rows
+                            )
+{
+  rows.N1Total  = fluxesX1.N1Total;
+  rows.N2Total  = fluxesX1.N2Total;
+  rows.N3Total  = fluxesX1.N3Total;
+  rows.dim      = fluxesX1.dim;
+  rows.numRows  = rows.N2Total*rows.N3Total;
+  rows.varStart = varStart;
+  rows.varEnd   = varEnd;
+
+  /* Same filter coefficients as the convolve in computeDivOfFluxes() */
+  rows.invdX[0] = 1./dX[0];
+  rows.invdX[1] = 1./dX[1];
+  rows.invdX[2] = 1./dX[2];
+
+  for (int var=varStart; var <= varEnd; var++)
+  {
+    rows.fluxX1Ptr[var] = host.read(fluxesX1.vars[var]);
+    rows.fluxX2Ptr[var] = (rows.dim > 1 ? host.read(fluxesX2.vars[var]) : NULL);
+    rows.fluxX3Ptr[var] = (rows.dim > 2 ? host.read(fluxesX3.vars[var]) : NULL);
+  }
+  for (int var=varStart; var <= varEnd; var++)
+  {
+    rows.divPtr[var] = host.write(divFluxes.vars[var],
+                                  rows.N1Total, rows.N2Total, rows.N3Total
+                                 );
+  }
+}
+
+void native::computeDivergenceRows(const divergenceRows &rows,
+                                   const int rowStart,
+                                   const int rowEnd
+                                  )
+{
+  const int N1Total  = rows.N1Total;
+  const int N2Total  = rows.N2Total;
+  const int N3Total  = rows.N3Total;
+  const int dim      = rows.dim;
+  const int strideX2 = N1Total;
+  const int strideX3 = N1Total*N2Total;
+  const double invdX1 = rows.invdX[0];
+  const double invdX2 = rows.invdX[1];
+  const double invdX3 = rows.invdX[2];
+
+  for (int row=rowStart; row < rowEnd; row++)
+  {
+    const int j = row % N2Total;
+    const int k = row / N2Total;
+
+    for (int var=rows.varStart; var <= rows.varEnd; var++)
+    {
+      const double *F1 = rows.fluxX1Ptr[var];
+      const double *F2 = rows.fluxX2Ptr[var];
+      const double *F3 = rows.fluxX3Ptr[var];
+      double *div      = rows.divPtr[var];
+
+      #pragma omp simd
+      for (int i=0; i < N1Total; i++)
+      {
+        const int zone = i + N1Total*(j + N2Total*k);
+
+        /* Zero padding at the end, as in convolve */
+        double dFluxX1_dX1 =   (i+1 < N1Total ? F1[zone+1]*invdX1 : 0.)
+                             - F1[zone]*invdX1;
+        double divergence = dFluxX1_dX1;
+
+        if (dim > 1)
+        {
+          double dFluxX2_dX2 =   (j+1 < N2Total ? F2[zone+strideX2]*invdX2 : 0.)
+                               - F2[zone]*invdX2;
+          divergence = divergence + dFluxX2_dX2;
+        }
+        if (dim > 2)
+        {
+          double dFluxX3_dX3 =   (k+1 < N3Total ? F3[zone+strideX3]*invdX3 : 0.)
+                               - F3[zone]*invdX3;
+          divergence = divergence + dFluxX3_dX3;
+        }
+
+        div[zone] = divergence;
+      }
+    }
+  }
+}
+
+void native::computeDivergence(const grid &fluxesX1,
+                               const grid &fluxesX2,
+                               const grid &fluxesX3,
+                               const double dX[3],
+                               const int varStart,
+                               const int varEnd,
+                               grid &divFluxes
+                              )
+{
+  hostArrays host;
+  divergenceRows rows;
+  setupDivergence(fluxesX1, fluxesX2, fluxesX3, dX, varStart, varEnd,
+                  divFluxes, host, rows
+                 );
+
+  #pragma omp parallel
+  {
+    double threadStart = omp_get_wtime();
+
+    #pragma omp for schedule(static) nowait
+    for (int row=0; row < rows.numRows; row++)
+    {
+      computeDivergenceRows(rows, row, row+1);
+    }
+
+    threads::addThreadTime(omp_get_wtime() - threadStart);
+  }
+}
+
+
+void native::timeStepAndInvert(const grid &consOld,
+                               const grid &divFluxes,
+                               const grid &sourcesExplicit,
+                               const geometry &geom,
+                               const double dt,
+                               grid &cons,
+                               grid &prim,
+                               array &idealSolverFailures,
+                               array &idealSolverZoneIters,
+                               int &idealSolverIters
+                              )
+{
+  const int N1Total  = prim.N1Total;
+  const int N2Total  = prim.N2Total;
+  const int N3Total  = prim.N3Total;
+  const int numZones = N1Total*N2Total*N3Total;
+
+  hostArrays host;
+  const double *consOldPtr[NUM_IDEAL_VARS];
+  const double *divPtr[NUM_IDEAL_VARS];
+  const double *sourcesPtr[NUM_IDEAL_VARS];
+  const double *primGuessPtr[NUM_IDEAL_VARS];
+  double *consPtr[NUM_IDEAL_VARS];
+  double *primPtr[NUM_IDEAL_VARS];
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    consOldPtr[var]   = host.read(consOld.vars[var]);
+    divPtr[var]       = host.read(divFluxes.vars[var]);
+    sourcesPtr[var]   = host.read(sourcesExplicit.vars[var]);
+    primGuessPtr[var] = host.read(prim.vars[var]);
+  }
+  geometryPtrs geomPtrs;
+  getGeometryPtrs(geom, false, host, geomPtrs);
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    consPtr[var] = host.write(cons.vars[var], N1Total, N2Total, N3Total);
+    primPtr[var] = host.write(prim.vars[var], N1Total, N2Total, N3Total);
+  }
+  double *failuresPtr = host.write(idealSolverFailures,
+                                   N1Total, N2Total, N3Total
+                                  );
+  double *zoneItersPtr = host.write(idealSolverZoneIters,
+                                    N1Total, N2Total, N3Total
+                                   );
+
+  int maxIters = 0;
+  #pragma omp parallel
+  {
+    double threadStart = omp_get_wtime();
+
+    #pragma omp for schedule(static) reduction(max:maxIters) nowait
+    for (int zone=0; zone < numZones; zone++)
+    {
+      double consZone[NUM_IDEAL_VARS], primZone[NUM_IDEAL_VARS];
+
+      /* timeStepFluidCons() */
+      for (int var=0; var <= vars::U3; var++)
+      {
+        consZone[var] =   consOldPtr[var][zone]
+                        - dt*(divPtr[var][zone] - sourcesPtr[var][zone]);
+        primZone[var] = primGuessPtr[var][zone];
+      }
+
+      metricPoint m;
+      loadMetric(geomPtrs, zone, m);
+
+      /* Induction equation */
+      for (int var=vars::B1; var <= vars::B3; var++)
+      {
+        consZone[var] = consOldPtr[var][zone] - dt*divPtr[var][zone];
+        primZone[var] = consZone[var]/m.g;
+      }
+
+      int iters;
+      int status = idealSolverPoint(m, consZone, primZone, iters);
+      if (iters > maxIters)
+      {
+        maxIters = iters;
+      }
+
+      for (int var=0; var < NUM_IDEAL_VARS; var++)
+      {
+        consPtr[var][zone] = consZone[var];
+        primPtr[var][zone] = primZone[var];
+      }
+      failuresPtr[zone]  = status;
+      zoneItersPtr[zone] = iters;
+    }
+
+    threads::addThreadTime(omp_get_wtime() - threadStart);
+  }
+
+  idealSolverIters = maxIters;
+}
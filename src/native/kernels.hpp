@@ -0,0 +1,573 @@
+#ifndef GRIM_NATIVE_KERNELS_H_
+#define GRIM_NATIVE_KERNELS_H_
+
+#include <cmath>
+#include <algorithm>
+#include "../params.hpp"
+
+/* Pointwise versions of the ideal MHD pieces of fluidElement, the
+ * reconstruction schemes, the Riemann solvers and the ideal solver. Every
+ * expression is written in the same order as its ArrayFire counterpart so that
+ * the native backend agrees with the ArrayFire path to round-off. If you change
+ * one, change the other. */
+namespace native
+{
+  /* RHO, U, U1, U2, U3, B1, B2, B3 */
+  const int NUM_IDEAL_VARS = 8;
+
+  struct metricPoint
+  {
+    double alpha, g;
+    double gCov[NDIM][NDIM];
+    double gCon[NDIM][NDIM];
+  };
+
+  struct fluidPoint
+  {
+    double rho, u, u1, u2, u3, B1, B2, B3;
+    double pressure, soundSpeed, bSqr;
+    double gammaLorentzFactor;
+    double uCon[NDIM], uCov[NDIM];
+    double bCon[NDIM], bCov[NDIM];
+  };
+
+  inline double delta(const int mu, const int nu)
+  {
+    return (mu==nu ? 1. : 0.);
+  }
+
+  /* fluidElement::set() */
+  inline void setFluidPoint(const double rho, const double u,
+                            const double u1, const double u2, const double u3,
+                            const double B1, const double B2, const double B3,
+                            const metricPoint &m,
+                            fluidPoint &f
+                           )
+  {
+    f.rho = std::max(rho, params::rhoFloorInFluidElement);
+    f.u   = std::max(u,   params::uFloorInFluidElement);
+    f.u1  = u1;
+    f.u2  = u2;
+    f.u3  = u3;
+    f.B1  = B1;
+    f.B2  = B2;
+    f.B3  = B3;
+
+    f.pressure   = (params::adiabaticIndex - 1.)*f.u;
+    f.soundSpeed = std::sqrt( params::adiabaticIndex*f.pressure
+                             /(f.rho+params::adiabaticIndex*f.u)
+                            );
+
+    f.gammaLorentzFactor =
+      std::sqrt(1 + m.gCov[1][1] * u1 * u1
+                  + m.gCov[2][2] * u2 * u2
+                  + m.gCov[3][3] * u3 * u3
+
+                + 2*(  m.gCov[1][2] * u1 * u2
+                     + m.gCov[1][3] * u1 * u3
+                     + m.gCov[2][3] * u2 * u3
+                    )
+               );
+
+    f.uCon[0] = f.gammaLorentzFactor/m.alpha;
+    f.uCon[1] = u1 - f.gammaLorentzFactor*m.gCon[0][1]*m.alpha;
+    f.uCon[2] = u2 - f.gammaLorentzFactor*m.gCon[0][2]*m.alpha;
+    f.uCon[3] = u3 - f.gammaLorentzFactor*m.gCon[0][3]*m.alpha;
+
+    for (int mu=0; mu < NDIM; mu++)
+    {
+      f.uCov[mu] =  m.gCov[mu][0] * f.uCon[0]
+                  + m.gCov[mu][1] * f.uCon[1]
+                  + m.gCov[mu][2] * f.uCon[2]
+                  + m.gCov[mu][3] * f.uCon[3];
+    }
+
+    f.bCon[0] =  B1*f.uCov[1] + B2*f.uCov[2] + B3*f.uCov[3];
+    f.bCon[1] = (B1 + f.bCon[0] * f.uCon[1])/f.uCon[0];
+    f.bCon[2] = (B2 + f.bCon[0] * f.uCon[2])/f.uCon[0];
+    f.bCon[3] = (B3 + f.bCon[0] * f.uCon[3])/f.uCon[0];
+
+    for (int mu=0; mu < NDIM; mu++)
+    {
+      f.bCov[mu] =  m.gCov[mu][0] * f.bCon[0]
+                  + m.gCov[mu][1] * f.bCon[1]
+                  + m.gCov[mu][2] * f.bCon[2]
+                  + m.gCov[mu][3] * f.bCon[3];
+    }
+
+    f.bSqr =  f.bCon[0]*f.bCov[0] + f.bCon[1]*f.bCov[1]
+            + f.bCon[2]*f.bCov[2] + f.bCon[3]*f.bCov[3]
+            + params::bSqrFloorInFluidElement;
+  }
+
+  /* fluidElement::TUpDown[mu][nu] */
+  inline double TUpDown(const fluidPoint &f, const int mu, const int nu)
+  {
+    return   (f.rho + f.u + f.pressure + f.bSqr)*f.uCon[mu]*f.uCov[nu]
+           + (f.pressure + 0.5*f.bSqr)*delta(mu, nu)
+           - f.bCon[mu] * f.bCov[nu];
+  }
+
+  /* fluidElement::computeFluxes(). flux[] is indexed by vars:: */
+  inline void computeFluxesPoint(const fluidPoint &f, const metricPoint &m,
+                                 const int dir, double flux[]
+                                )
+  {
+    flux[vars::RHO] = m.g*(f.rho * f.uCon[dir]);
+
+    flux[vars::U]   = m.g*TUpDown(f, dir, 0) + flux[vars::RHO];
+
+    flux[vars::U1]  = m.g*TUpDown(f, dir, 1);
+    flux[vars::U2]  = m.g*TUpDown(f, dir, 2);
+    flux[vars::U3]  = m.g*TUpDown(f, dir, 3);
+
+    flux[vars::B1]  = m.g*(f.bCon[1]*f.uCon[dir] - f.bCon[dir]*f.uCon[1]);
+    flux[vars::B2]  = m.g*(f.bCon[2]*f.uCon[dir] - f.bCon[dir]*f.uCon[2]);
+    flux[vars::B3]  = m.g*(f.bCon[3]*f.uCon[dir] - f.bCon[dir]*f.uCon[3]);
+  }
+
+  /* fluidElement::computeMinMaxCharSpeeds() without the EMHD contributions.
+   * dir is directions::X1/X2/X3. The contractions with A_mu = delta_mu^dir and
+   * B_mu = delta_mu^0 reduce to picking components. */
+  inline void computeMinMaxCharSpeedsPoint(const fluidPoint &f,
+                                           const metricPoint &m,
+                                           const int dir,
+                                           double &minSpeed,
+                                           double &maxSpeed
+                                          )
+  {
+    const int sdir = dir + 1;
+
+    double cAlvenSqr = f.bSqr/(f.rho+params::adiabaticIndex*f.u+f.bSqr);
+    double csSqr     = f.soundSpeed*f.soundSpeed;
+    double cConSqr   = 0.5*(csSqr + std::sqrt(csSqr*csSqr));
+    csSqr = cConSqr;
+
+    csSqr = csSqr + cAlvenSqr - csSqr*cAlvenSqr;
+    if (csSqr > 1.)
+    {
+      csSqr = 1.;
+    }
+
+    double ASqr  = m.gCon[sdir][sdir];
+    double BSqr  = m.gCon[0][0];
+    double ADotU = f.uCon[sdir];
+    double BDotU = f.uCon[0];
+    double ADotB = m.gCon[sdir][0];
+
+    double A = (BDotU*BDotU)   - (BSqr + BDotU*BDotU)*csSqr;
+    double B = 2.*(ADotU*BDotU - (ADotB + ADotU*BDotU)*csSqr);
+    double C = ADotU*ADotU     - (ASqr + ADotU*ADotU)*csSqr;
+    double discr = std::sqrt(std::max(B*B - 4.*A*C, 1.e-16));
+
+    minSpeed = -(-B + discr)/2./A;
+    maxSpeed = -(-B - discr)/2./A;
+
+    if (minSpeed > -1.e-15)
+    {
+      minSpeed = -1.e-15;
+    }
+    if (maxSpeed < 1.e-15)
+    {
+      maxSpeed = 1.e-15;
+    }
+  }
+
+  /* riemannSolver::solve() at one face. *Left is the state on the left of the
+   * face (i-1/2 - eps), *Right the state on the right (i-1/2 + eps). */
+  inline double riemannFluxPoint(const double fluxLeft,  const double consLeft,
+                                 const double fluxRight, const double consRight,
+                                 const double minSpeed,  const double maxSpeed
+                                )
+  {
+    if (params::riemannSolver == riemannSolvers::HLL)
+    {
+      return
+        (   maxSpeed * fluxLeft
+          - minSpeed * fluxRight
+          + minSpeed * maxSpeed
+          * (consRight - consLeft)
+        )/(maxSpeed - minSpeed);
+    }
+    else
+    {
+      return
+       0.5*(  fluxLeft
+            + fluxRight
+            - std::max(maxSpeed,-minSpeed)*(consRight - consLeft)
+           );
+    }
+  }
+
+  /* Reconstruction at a point. y points to the zone, and y[-2..2] must be
+   * valid. left is the value on the face i-1/2, right on i+1/2. */
+  inline void reconstructMMPoint(const double *y, double &left, double &right)
+  {
+    double forwardDiff  = y[1] - y[0];
+    double backwardDiff = y[0] - y[-1];
+    double centralDiff  = backwardDiff + forwardDiff;
+
+    double x = params::slopeLimTheta * backwardDiff;
+    double c = 0.5 * centralDiff;
+    double z = params::slopeLimTheta * forwardDiff;
+
+    double minOfAll = std::min(std::min(std::fabs(x), std::fabs(c)),
+                               std::fabs(z)
+                              );
+    double signx = 1.-2.*(x < 0.);
+    double signy = 1.-2.*(c < 0.);
+    double signz = 1.-2.*(z < 0.);
+    double slope = 0.25 * std::fabs(signx + signy ) * (signx + signz ) * minOfAll;
+
+    left  = y[0] - 0.5*slope;
+    right = y[0] + 0.5*slope;
+  }
+
+  inline void reconstructPPMPoint(const double *y, double &left, double &right)
+  {
+    double y0 = y[-2];
+    double y1 = y[-1];
+    double y2 = y[0];
+    double y3 = y[1];
+    double y4 = y[2];
+
+    double d0 = 2.*(y1-y0);
+    double d1 = 2.*(y2-y1);
+    double d2 = 2.*(y3-y2);
+    double d3 = 2.*(y4-y3);
+    double D1 = 0.5*(y2-y0);
+    double D2 = 0.5*(y3-y1);
+    double D3 = 0.5*(y4-y2);
+
+    double condZeroSlope1 = (d1*d0<=0.);
+    double sign1 = (D1>0.)*2.-1.;
+    double DQ1 = (1.-condZeroSlope1)*sign1*std::min(std::fabs(D1),std::min(std::fabs(d0),std::fabs(d1)));
+    double condZeroSlope2 = (d2*d1<=0.);
+    double sign2 = (D2>0.)*2.-1.;
+    double DQ2 = (1.-condZeroSlope2)*sign2*std::min(std::fabs(D2),std::min(std::fabs(d1),std::fabs(d2)));
+    double condZeroSlope3 = (d3*d2<=0.);
+    double sign3 = (D3>0.)*2.-1.;
+    double DQ3 = (1.-condZeroSlope3)*sign3*std::min(std::fabs(D3),std::min(std::fabs(d2),std::fabs(d3)));
+
+    double leftV  = 0.5*(y2+y1)-1./6.*(DQ2-DQ1);
+    double rightV = 0.5*(y3+y2)-1./6.*(DQ3-DQ2);
+
+    double corr1 = ((rightV-y2)*(y2-leftV)<=0.);
+    double qd = rightV-leftV;
+    double qe = 6.*(y2-0.5*(rightV+leftV));
+    double corr2 = (qd*(qd-qe)<0.);
+    double corr3 = (qd*(qd+qe)<0.);
+    leftV = leftV*(1.-corr1)+corr1*y2;
+    rightV = rightV*(1.-corr1)+corr1*y2;
+
+    leftV = leftV*(1.-corr2)+corr2*(3.*y2-2.*rightV);
+    rightV = rightV*corr2+(1.-corr2)*rightV*(1.-corr3)+(1.-corr2)*corr3*(3.*y2-2.*leftV);
+
+    left  = leftV;
+    right = rightV;
+  }
+
+  inline void reconstructWENO5Point(const double *y, double &left, double &right)
+  {
+    const double eps2 = 1.0e-17;
+
+    double y0 = y[-2];
+    double y1 = y[-1];
+    double y2 = y[0];
+    double y3 = y[1];
+    double y4 = y[2];
+
+    double beta1 = (( 4.0/3.0)*y0*y0 - (19.0/3.0)*y0*y1 +
+                    (25.0/3.0)*y1*y1 + (11.0/3.0)*y0*y2 -
+                    (31.0/3.0)*y1*y2 + (10.0/3.0)*y2*y2
+                   )
+                  +
+                   eps2*(1.0 + std::fabs(y0) + std::fabs(y1) + std::fabs(y2));
+    double beta2 = (( 4.0/3.0)*y1*y1 - (13.0/3.0)*y1*y2 +
+                    (13.0/3.0)*y2*y2 + ( 5.0/3.0)*y1*y3 -
+                    (13.0/3.0)*y2*y3 + ( 4.0/3.0)*y3*y3
+                   )
+                  +
+                   eps2*(1.0 + std::fabs(y1) + std::fabs(y2) + std::fabs(y3));
+    double beta3 = ((10.0/3.0)*y2*y2 - (31.0/3.0)*y2*y3 +
+                    (25.0/3.0)*y3*y3 + (11.0/3.0)*y2*y4 -
+                    (19.0/3.0)*y3*y4 + ( 4.0/3.0)*y4*y4
+                   )
+                  +
+                   eps2*(1.0 + std::fabs(y2) + std::fabs(y3) + std::fabs(y4));
+
+    double w1r = 1.0/(16.0*beta1*beta1);
+    double w2r = 5.0/( 8.0*beta2*beta2);
+    double w3r = 5.0/(16.0*beta3*beta3);
+    double w1l = 5.0/(16.0*beta1*beta1);
+    double w2l = 5.0/( 8.0*beta2*beta2);
+    double w3l = 1.0/(16.0*beta3*beta3);
+    double denl = w1l + w2l + w3l;
+    double denr = w1r + w2r + w3r;
+
+    double u1r =  0.375*y0 - 1.25*y1 + 1.875*y2;
+    double u2r = -0.125*y1 + 0.75*y2 + 0.375*y3;
+    double u3r =  0.375*y2 + 0.75*y3 - 0.125*y4;
+    double u1l = -0.125*y0 + 0.75*y1 + 0.375*y2;
+    double u2l =  0.375*y1 + 0.75*y2 - 0.125*y3;
+    double u3l =  1.875*y2 - 1.25*y3 + 0.375*y4;
+
+    left  = (w1l*u1l + w2l*u2l + w3l*u3l) / denl;
+    right = (w1r*u1r + w2r*u2r + w3r*u3r) / denr;
+  }
+
+  inline void reconstructPoint(const double *y, double &left, double &right)
+  {
+    switch (params::reconstruction)
+    {
+      case reconstructionOptions::MINMOD:
+        reconstructMMPoint(y, left, right);
+        break;
+
+      case reconstructionOptions::WENO5:
+        reconstructWENO5Point(y, left, right);
+        break;
+
+      case reconstructionOptions::PPM:
+        reconstructPPMPoint(y, left, right);
+        break;
+    }
+  }
+
+  /* pressureRho0W(), gammaFunc() and errFunc() in solve.cpp */
+  inline double pressureRho0WPoint(const double rho0, const double w)
+  {
+    return ((w - rho0)*(params::adiabaticIndex - 1.)/params::adiabaticIndex);
+  }
+
+  inline double gammaFuncPoint(const double BSqr, const double D,
+                               const double QDotB, const double QTildeSqr,
+                               const double Wp
+                              )
+  {
+    double QDotBWholeSqr = QDotB * QDotB;
+    double W     = D + Wp;
+    double WB    = W + BSqr;
+    double W2    = W*W;
+
+    double uTildeSqr = - ( (W + WB)*QDotBWholeSqr + W2*QTildeSqr )
+                       / (QDotBWholeSqr*(W + WB) + W2*(QTildeSqr - WB*WB)) ;
+
+    return std::sqrt(1 + std::fabs(uTildeSqr));
+  }
+
+  inline double errFuncPoint(const double BSqr, const double D,
+                             const double Ep, const double QDotB,
+                             const double QTildeSqr, const double Wp
+                            )
+  {
+    double W = Wp + D;
+    double gamma = gammaFuncPoint(BSqr, D, QDotB, QTildeSqr, Wp);
+    double w = W/(gamma * gamma);
+    double rho0 = D/gamma;
+    double p = pressureRho0WPoint(rho0, w);
+
+    return - Ep + Wp - p + 0.5*BSqr
+           + 0.5*(BSqr*QTildeSqr - QDotB*QDotB)
+           / ((BSqr + W)*(BSqr + W)) ;
+  }
+
+  /* timeStepper::idealSolver() at a point. cons[] and prim[] are indexed by
+   * vars::, prim[] holds the guess on entry. Returns the idealSolverStatus;
+   * failed zones are left at the guess. */
+  inline int idealSolverPoint(const metricPoint &m,
+                              const double cons[],
+                              double prim[],
+                              int &iters
+                             )
+  {
+    fluidPoint f;
+    f.rho = std::max(prim[vars::RHO], params::rhoFloorInFluidElement);
+    f.u   = std::max(prim[vars::U  ], params::uFloorInFluidElement);
+    f.pressure = (params::adiabaticIndex - 1.)*f.u;
+
+    const double B1 = prim[vars::B1];
+    const double B2 = prim[vars::B2];
+    const double B3 = prim[vars::B3];
+
+    const double lapse = m.alpha;
+    const double g     = m.g;
+    const double zero  = 0. * B1;
+
+    const double D = cons[vars::RHO] * lapse / g;
+
+    double BCon[NDIM];
+    BCon[0] = zero;
+    BCon[1] = B1 * lapse;
+    BCon[2] = B2 * lapse;
+    BCon[3] = B3 * lapse;
+
+    double BCov[NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      BCov[mu] =   m.gCov[mu][0] * BCon[0]
+                 + m.gCov[mu][1] * BCon[1]
+                 + m.gCov[mu][2] * BCon[2]
+                 + m.gCov[mu][3] * BCon[3];
+    }
+    const double BSqr =   BCov[0]*BCon[0] + BCov[1]*BCon[1]
+                        + BCov[2]*BCon[2] + BCov[3]*BCon[3];
+
+    double QCov[NDIM];
+    QCov[0] = cons[vars::U]  * lapse / g;
+    QCov[1] = cons[vars::U1] * lapse / g;
+    QCov[2] = cons[vars::U2] * lapse / g;
+    QCov[3] = cons[vars::U3] * lapse / g;
+
+    double QCon[NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      QCon[mu] =   m.gCon[mu][0] * QCov[0]
+                 + m.gCon[mu][1] * QCov[1]
+                 + m.gCon[mu][2] * QCov[2]
+                 + m.gCon[mu][3] * QCov[3];
+    }
+
+    double nCov[NDIM];
+    nCov[0] = -lapse;
+    nCov[1] = zero;
+    nCov[2] = zero;
+    nCov[3] = zero;
+
+    double nCon[NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      nCon[mu] =   m.gCon[mu][0] * nCov[0]
+                 + m.gCon[mu][1] * nCov[1]
+                 + m.gCon[mu][2] * nCov[2]
+                 + m.gCon[mu][3] * nCov[3];
+    }
+
+    const double QDotn =   QCov[0]*nCon[0] + QCov[1]*nCon[1]
+                         + QCov[2]*nCon[2] + QCov[3]*nCon[3];
+
+    const double QDotB =   QCov[0]*BCon[0] + QCov[1]*BCon[1]
+                         + QCov[2]*BCon[2] + QCov[3]*BCon[3];
+
+    const double QSqr =   QCov[0]*QCon[0] + QCov[1]*QCon[1]
+                        + QCov[2]*QCon[2] + QCov[3]*QCon[3];
+
+    double QTildeCon[NDIM];
+    for (int mu=0; mu < NDIM; mu++)
+    {
+      QTildeCon[mu] = QCon[mu] + nCon[mu]*QDotn;
+    }
+    const double QTildeSqr = QSqr + QDotn*QDotn;
+
+    const double Ep = -QDotn - D;
+
+    double uTildeCon[NDIM];
+    uTildeCon[0] = zero;
+    uTildeCon[1] = prim[vars::U1];
+    uTildeCon[2] = prim[vars::U2];
+    uTildeCon[3] = prim[vars::U3];
+
+    double uTildeCov[NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      uTildeCov[mu] =   m.gCov[mu][0] * uTildeCon[0]
+                      + m.gCov[mu][1] * uTildeCon[1]
+                      + m.gCov[mu][2] * uTildeCon[2]
+                      + m.gCov[mu][3] * uTildeCon[3];
+    }
+
+    const double uTildeSqr =  uTildeCov[0] * uTildeCon[0]
+                            + uTildeCov[1] * uTildeCon[1]
+                            + uTildeCov[2] * uTildeCon[2]
+                            + uTildeCov[3] * uTildeCon[3];
+
+    const double gammaTilde = std::sqrt(1. + std::fabs(uTildeSqr));
+
+    double Wp =   (f.rho + f.u + f.pressure)*gammaTilde*gammaTilde
+                - f.rho*gammaTilde;
+
+    /* Halley step, then secant steps until converged */
+    int status = idealSolverStatus::NOT_CONVERGED;
+    double WpOld, errOld;
+    iters = 0;
+    for (int iter=0; iter < params::maxIdealSolverIter; iter++)
+    {
+      double dW;
+      if (iter==0)
+      {
+        const double DEL = 1e-5;
+        double WpMinus = (1. - DEL)*Wp;
+        double h       = Wp - WpMinus;
+        double WpPlus  = Wp + h;
+
+        double errPlus  = errFuncPoint(BSqr, D, Ep, QDotB, QTildeSqr, WpPlus );
+        double err      = errFuncPoint(BSqr, D, Ep, QDotB, QTildeSqr, Wp     );
+        double errMinus = errFuncPoint(BSqr, D, Ep, QDotB, QTildeSqr, WpMinus);
+
+        double dErrdW   = (errPlus - errMinus)/(WpPlus - WpMinus);
+        double dErr2dW2 = (errPlus - 2.*err + errMinus)/(h*h);
+
+        double fHalley = 0.5*err*dErr2dW2/(dErrdW * dErrdW);
+        dW = -err/dErrdW/(1. - std::min(std::max(-0.3, fHalley), 0.3));
+        dW = std::max( std::min(dW, 2.0*Wp), -0.5*Wp );
+
+        errOld = err;
+      }
+      else
+      {
+        double err = errFuncPoint(BSqr, D, Ep, QDotB, QTildeSqr, Wp);
+        dW = (WpOld - Wp)*err/(err - errOld);
+        dW = std::max( std::min(dW, 2.0*Wp), -0.5*Wp );
+
+        errOld = err;
+      }
+      WpOld = Wp;
+      Wp    = Wp + dW;
+      iters = iter+1;
+
+      if (std::fabs(dW) <= params::idealSolverTol*std::fabs(Wp))
+      {
+        status = idealSolverStatus::CONVERGED;
+        break;
+      }
+    }
+
+    double gamma = gammaFuncPoint(BSqr, D, QDotB, QTildeSqr, Wp);
+    double rho0  = D/gamma;
+    double W     = Wp + D;
+    double w     = W/(gamma * gamma);
+    double P     = pressureRho0WPoint(rho0, w);
+
+    double primRecovered[vars::U3+1];
+    primRecovered[vars::RHO] = rho0;
+    primRecovered[vars::U]   = w - (rho0 + P);
+    primRecovered[vars::U1]  =   (gamma/(W + BSqr))
+                               * (QTildeCon[1] + QDotB*BCon[1]/W) ;
+    primRecovered[vars::U2]  =   (gamma/(W + BSqr))
+                               * (QTildeCon[2] + QDotB*BCon[2]/W) ;
+    primRecovered[vars::U3]  =   (gamma/(W + BSqr))
+                               * (QTildeCon[3] + QDotB*BCon[3]/W) ;
+
+    bool unphysical = (W <= 0.);
+    for (int var=0; var <= vars::U3; var++)
+    {
+      unphysical = unphysical || !std::isfinite(primRecovered[var]);
+    }
+    if (unphysical)
+    {
+      status = idealSolverStatus::UNPHYSICAL;
+    }
+
+    if (status == idealSolverStatus::CONVERGED)
+    {
+      for (int var=0; var <= vars::U3; var++)
+      {
+        prim[var] = primRecovered[var];
+      }
+    }
+
+    return status;
+  }
+};
+
+#endif /* GRIM_NATIVE_KERNELS_H_ */
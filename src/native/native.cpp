@@ -0,0 +1,202 @@
+#include "native.hpp"
+
+native::hostArrays::~hostArrays()
+{
+  release();
+  PROFILE_BYTES(bytes);
+}
+
+const double *native::hostArrays::read(const array &in)
+{
+  /* device() evaluates the array and makes it the sole owner of its buffer,
+   * copying it if it was shared */
+  inputs.push_back(&in);
+
+  return in.device<double>();
+}
+
+double *native::hostArrays::write(array &out,
+                                  const int N1Total,
+                                  const int N2Total,
+                                  const int N3Total
+                                 )
+{
+  /* An output that is not also an input of the kernel is written in its own
+   * buffer, which keeps the pages placeGrid() had the threads first touch */
+  bool isInput = false;
+  for (int n=0; n < inputs.size(); n++)
+  {
+    isInput = isInput || (inputs[n] == &out);
+  }
+  if (!isInput && out.dims() == af::dim4(N1Total, N2Total, N3Total)
+      && out.type() == f64
+     )
+  {
+    inPlace.push_back(&out);
+
+    return out.device<double>();
+  }
+
+  outputs.push_back(array(N1Total, N2Total, N3Total, f64));
+  destinations.push_back(&out);
+
+  return outputs.back().device<double>();
+}
+
+/* Every array a kernel touches passes through here once, so the bytes it
+ * moves are those of its inputs and outputs */
+void native::hostArrays::release()
+{
+  for (int n=0; n < inputs.size(); n++)
+  {
+    bytes += inputs[n]->bytes();
+    inputs[n]->unlock();
+  }
+  for (int n=0; n < inPlace.size(); n++)
+  {
+    bytes += inPlace[n]->bytes();
+    inPlace[n]->unlock();
+  }
+  for (int n=0; n < outputs.size(); n++)
+  {
+    bytes += outputs[n].bytes();
+    outputs[n].unlock();
+    *destinations[n] = outputs[n];
+  }
+
+  inputs.clear();
+  inPlace.clear();
+  outputs.clear();
+  destinations.clear();
+}
+
+/* Copy the arrays into new buffers that the OpenMP threads fill with a
+ * static schedule over the zones, the schedule of the kernels, so that each
+ * page is first touched by a thread that later works on its zones. The free
+ * buffers of ArrayFire's memory manager go back to the system first and all
+ * new buffers are allocated before any old one is released, so none of them
+ * is a recycled buffer that another thread touched before. */
+static void placeArrays(const std::vector<array *> &arrays)
+{
+  af::deviceGC();
+
+  std::vector<array> placed;
+  for (int n=0; n < arrays.size(); n++)
+  {
+    placed.push_back(array(arrays[n]->dims(), f64));
+  }
+
+  for (int n=0; n < arrays.size(); n++)
+  {
+    const double *inPtr = arrays[n]->device<double>();
+    double *placedPtr   = placed[n].device<double>();
+    const int numZones  = arrays[n]->elements();
+
+    #pragma omp parallel for schedule(static)
+    for (int i=0; i < numZones; i++)
+    {
+      placedPtr[i] = inPtr[i];
+    }
+
+    arrays[n]->unlock();
+    placed[n].unlock();
+  }
+
+  for (int n=0; n < arrays.size(); n++)
+  {
+    *arrays[n] = placed[n];
+  }
+}
+
+/* Every metric and connection entry the kernels read gets a buffer of its
+ * own, the lower triangles included: geometry::loadCache() has them share
+ * the buffers of the upper ones, and device() would copy a shared buffer on
+ * the first read, from the calling thread. Call once the geometry is final. */
+void native::placeGeometry(geometry &geom)
+{
+  if (geom.isFlat)
+  {
+    return;
+  }
+
+  std::vector<array *> arrays;
+  arrays.push_back(&geom.alpha);
+  arrays.push_back(&geom.g);
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=0; nu<NDIM; nu++)
+    {
+      arrays.push_back(&geom.gCov[mu][nu]);
+      arrays.push_back(&geom.gCon[mu][nu]);
+    }
+  }
+
+  if (geom.haveConnectionCoeffs)
+  {
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        for (int lamda=0; lamda<NDIM; lamda++)
+        {
+          arrays.push_back(&geom.gammaUpDownDown[mu][nu][lamda]);
+        }
+      }
+    }
+  }
+
+  placeArrays(arrays);
+}
+
+/* The kernels write their outputs in place when they can, see
+ * hostArrays::write(), so these buffers last until ArrayFire code assigns
+ * new arrays to them */
+void native::placeGrids(const std::vector<grid *> &grids,
+                        const std::vector<array *> &others
+                       )
+{
+  std::vector<array *> arrays(others);
+  for (int n=0; n < grids.size(); n++)
+  {
+    if (grids[n] == NULL)
+    {
+      continue;
+    }
+    for (int var=0; var < grids[n]->numVars; var++)
+    {
+      arrays.push_back(&grids[n]->vars[var]);
+    }
+  }
+
+  placeArrays(arrays);
+}
+
+void native::getGeometryPtrs(const geometry &geom,
+                             const bool needConnection,
+                             hostArrays &host,
+                             geometryPtrs &ptrs
+                            )
+{
+  /* Reading the constant arrays of a flat geometry would evaluate them */
+  ptrs.isFlat = geom.isFlat;
+  const bool readMetric = !geom.isFlat;
+
+  ptrs.alpha = readMetric ? host.read(geom.alpha) : NULL;
+  ptrs.g     = readMetric ? host.read(geom.g)     : NULL;
+
+  for (int mu=0; mu<NDIM; mu++)
+  {
+    for (int nu=0; nu<NDIM; nu++)
+    {
+      ptrs.gCov[mu][nu] = readMetric ? host.read(geom.gCov[mu][nu]) : NULL;
+      ptrs.gCon[mu][nu] = readMetric ? host.read(geom.gCon[mu][nu]) : NULL;
+
+      for (int lamda=0; lamda<NDIM; lamda++)
+      {
+        ptrs.gammaUpDownDown[mu][nu][lamda] =
+          (readMetric && needConnection)
+          ? host.read(geom.gammaUpDownDown[mu][nu][lamda]) : NULL;
+      }
+    }
+  }
+}
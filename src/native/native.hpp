@@ -0,0 +1,246 @@
+#ifndef GRIM_NATIVE_H_
+#define GRIM_NATIVE_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "../params.hpp"
+#include "../grid/grid.hpp"
+#include "../geometry/geometry.hpp"
+#include "../threads/threads.hpp"
+#include "kernels.hpp"
+
+/* Native backend for the explicit ideal MHD step. The stages are hand-fused C++
+ * loops threaded with OpenMP and vectorized with omp simd, working directly on
+ * the memory of grid::vars. Needs ArrayFire's CPU backend (ARCH CPU), where
+ * device memory is host memory. Selected at build time with BACKEND Native,
+ * which defines GRIM_NATIVE_BACKEND. */
+namespace native
+{
+  /* Host pointers into ArrayFire arrays. Inputs are locked in place. Outputs
+   * are written in place too, unless they were also read by the kernel: then
+   * they are written into fresh buffers that are only assigned to their
+   * destination in release(). Read a kernel's inputs before its outputs.
+   * The bytes of all of them are charged to the profiler on destruction,
+   * which may be outside of the OpenMP tasks that call release(). */
+  class hostArrays
+  {
+    std::vector<const array *> inputs;
+    std::vector<array *> inPlace;
+    std::deque<array> outputs;
+    std::vector<array *> destinations;
+    double bytes;
+
+    public:
+      hostArrays() : bytes(0.) {}
+      ~hostArrays();
+
+      const double *read(const array &in);
+      double *write(array &out,
+                    const int N1Total, const int N2Total, const int N3Total
+                   );
+      void release();
+  };
+
+  /* Flat geometries have no arrays to point to: all pointers are NULL and
+   * loadMetric() fills in the Minkowski metric */
+  struct geometryPtrs
+  {
+    bool isFlat;
+    const double *alpha, *g;
+    const double *gCov[NDIM][NDIM];
+    const double *gCon[NDIM][NDIM];
+    const double *gammaUpDownDown[NDIM][NDIM][NDIM];
+  };
+
+  /* Copy the metric arrays of geom, and the variables of the grids and the
+   * other arrays the kernels write, into buffers first touched by the OpenMP
+   * threads, see native.cpp */
+  void placeGeometry(geometry &geom);
+  void placeGrids(const std::vector<grid *> &grids,
+                  const std::vector<array *> &others
+                 );
+
+  void getGeometryPtrs(const geometry &geom,
+                       const bool needConnection,
+                       hostArrays &host,
+                       geometryPtrs &ptrs
+                      );
+
+  inline void loadMetric(const geometryPtrs &ptrs, const int zone,
+                         metricPoint &m
+                        )
+  {
+    if (ptrs.isFlat)
+    {
+      m.alpha = 1.;
+      m.g     = 1.;
+      for (int mu=0; mu<NDIM; mu++)
+      {
+        for (int nu=0; nu<NDIM; nu++)
+        {
+          m.gCov[mu][nu] = (mu == nu) ? 1. : 0.;
+          m.gCon[mu][nu] = (mu == nu) ? 1. : 0.;
+        }
+      }
+      m.gCov[0][0] = -1.;
+      m.gCon[0][0] = -1.;
+      return;
+    }
+
+    m.alpha = ptrs.alpha[zone];
+    m.g     = ptrs.g[zone];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      for (int nu=0; nu<NDIM; nu++)
+      {
+        m.gCov[mu][nu] = ptrs.gCov[mu][nu][zone];
+        m.gCon[mu][nu] = ptrs.gCon[mu][nu][zone];
+      }
+    }
+  }
+
+  /* elem->set(prim), elem->computeFluxes(0, cons) and
+   * elem->computeExplicitSources(sources) in one pass. cons can be NULL. */
+  void computeConsAndSources(const grid &prim,
+                             const geometry &geom,
+                             grid *cons,
+                             grid &sources
+                            );
+
+  /* Scratch for one pencil, private to a thread */
+  struct pencilScratch
+  {
+    static const int PAD = 2; /* Stencil padding on either side */
+
+    std::vector<double> primLine, primLeftLine, primRightLine;
+    std::vector<double> fluxLeftLine, consLeftLine;
+    std::vector<double> fluxRightLine, consRightLine;
+    std::vector<double> minSpeedLeft, maxSpeedLeft;
+    std::vector<double> minSpeedRight, maxSpeedRight;
+
+    void resize(const int maxZones);
+  };
+
+  /* Riemann fluxes on faces faceStart to faceEnd of the pencil that starts at
+   * offset. Face i sits between zones i-1 and i, and geomFacePtrs holds the
+   * metric on face i at zone i; face 0 takes its left state from the last
+   * zone, like the shift in riemannSolver::solve(). Output is
+   * faceFluxes[var*numFaces + face]. */
+  void pencilFaceFluxes(const double * const primPtr[],
+                        const geometryPtrs &geomFacePtrs,
+                        const int dir,
+                        const int offset,
+                        const int lineLength,
+                        const int lineStride,
+                        const int faceStart,
+                        const int faceEnd,
+                        pencilScratch &scratch,
+                        double faceFluxes[]
+                       );
+
+  /* Pointers and extents for the pencils of one direction */
+  struct fluxPencils
+  {
+    int dir, lineLength, lineStride;
+    int dirA, dirB, NA, strideA, strideB;
+    int numLines;
+    const double *primPtr[NUM_IDEAL_VARS];
+    double *fluxPtr[NUM_IDEAL_VARS];
+    geometryPtrs geomFacePtrs;
+  };
+
+  void setupFluxPencils(const grid &prim,
+                        const int dir,
+                        const geometry &geomFace,
+                        grid &fluxes,
+                        hostArrays &host,
+                        fluxPencils &pencils
+                       );
+
+  /* Fluxes on pencils lineStart to lineEnd-1. Safe to call concurrently on
+   * disjoint ranges with separate scratch. */
+  void computeFluxPencils(const fluxPencils &pencils,
+                          const int lineStart,
+                          const int lineEnd,
+                          pencilScratch &scratch,
+                          std::vector<double> &faceFluxes
+                         );
+
+  /* reconstruction::reconstruct() followed by riemann->solve() in direction
+   * dir, one pencil at a time. primLeft/primRight and the face states are
+   * never stored on the grid. */
+  void computeFluxes(const grid &prim,
+                     const int dir,
+                     const geometry &geomFace,
+                     grid &fluxes
+                    );
+
+  /* Pointers and extents for the divergence, one row of N1Total zones per
+   * (j, k) */
+  struct divergenceRows
+  {
+    int N1Total, N2Total, N3Total, dim;
+    int numRows, varStart, varEnd;
+    double invdX[3];
+    const double *fluxX1Ptr[NUM_IDEAL_VARS];
+    const double *fluxX2Ptr[NUM_IDEAL_VARS];
+    const double *fluxX3Ptr[NUM_IDEAL_VARS];
+    double *divPtr[NUM_IDEAL_VARS];
+  };
+
+  void setupDivergence(const grid &fluxesX1,
+                       const grid &fluxesX2,
+                       const grid &fluxesX3,
+                       const double dX[3],
+                       const int varStart,
+                       const int varEnd,
+                       grid &divFluxes,
+                       hostArrays &host,
+                       divergenceRows &rows
+                      );
+
+  void computeDivergenceRows(const divergenceRows &rows,
+                             const int rowStart,
+                             const int rowEnd
+                            );
+
+  /* Forward differences of the fluxes, as in computeDivOfFluxes(), for
+   * varStart to varEnd */
+  void computeDivergence(const grid &fluxesX1,
+                         const grid &fluxesX2,
+                         const grid &fluxesX3,
+                         const double dX[3],
+                         const int varStart,
+                         const int varEnd,
+                         grid &divFluxes
+                        );
+
+  /* computeFluxes() in every direction and computeDivergence(), one tile of
+   * tileSize zones at a time. The face fluxes live in tile-local scratch;
+   * only the B1, B2, B3 fluxes are written out, for constrained transport.
+   * The fluid variable entries of fluxes[] are left untouched. */
+  void computeDivOfFluxesTiled(const grid &prim,
+                               const geometry *geomFace[3],
+                               const double dX[3],
+                               const int tileSize[3],
+                               grid *fluxes[3],
+                               grid &divFluxes
+                              );
+
+  /* Induction equation, timeStepFluidCons() and idealSolver() in one pass.
+   * prim holds the guess on entry. */
+  void timeStepAndInvert(const grid &consOld,
+                         const grid &divFluxes,
+                         const grid &sourcesExplicit,
+                         const geometry &geom,
+                         const double dt,
+                         grid &cons,
+                         grid &prim,
+                         array &idealSolverFailures,
+                         array &idealSolverZoneIters,
+                         int &idealSolverIters
+                        );
+};
+
+#endif /* GRIM_NATIVE_H_ */
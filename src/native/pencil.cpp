@@ -0,0 +1,208 @@
+#include "native.hpp"
+
+void native::pencilScratch::resize(const int maxZones)
+{
+  const int padLength = maxZones + 2*PAD;
+
+  primLine.resize(NUM_IDEAL_VARS*padLength);
+  primLeftLine.resize(NUM_IDEAL_VARS*maxZones);
+  primRightLine.resize(NUM_IDEAL_VARS*maxZones);
+  fluxLeftLine.resize(NUM_IDEAL_VARS*maxZones);
+  consLeftLine.resize(NUM_IDEAL_VARS*maxZones);
+  fluxRightLine.resize(NUM_IDEAL_VARS*maxZones);
+  consRightLine.resize(NUM_IDEAL_VARS*maxZones);
+  minSpeedLeft.resize(maxZones);
+  maxSpeedLeft.resize(maxZones);
+  minSpeedRight.resize(maxZones);
+  maxSpeedRight.resize(maxZones);
+}
+
+/* Value of a pencil at index i, which may lie outside [0, lineLength).
+ * ArrayFire's convolve (MINMOD) pads with zeros, shift (PPM, WENO5) wraps
+ * around. */
+static inline double pencilValue(const double *var,
+                                 const int offset,
+                                 const int lineLength,
+                                 const int lineStride,
+                                 const int i
+                                )
+{
+  if (i >= 0 && i < lineLength)
+  {
+    return var[offset + i*lineStride];
+  }
+  else if (params::reconstruction != reconstructionOptions::MINMOD)
+  {
+    int iWrap = ((i % lineLength) + lineLength) % lineLength;
+    return var[offset + iWrap*lineStride];
+  }
+
+  return 0.;
+}
+
+void native::pencilFaceFluxes(const double * const primPtr[],
+                              const geometryPtrs &geomFacePtrs,
+                              const int dir,
+                              const int offset,
+                              const int lineLength,
+                              const int lineStride,
+                              const int faceStart,
+                              const int faceEnd,
+                              pencilScratch &scratch,
+                              double faceFluxes[]
+                             )
+{
+  /* Zones faceStart-1 to faceEnd, at positions n = 0 to numZones-1 */
+  const int numFaces  = faceEnd - faceStart + 1;
+  const int numZones  = numFaces + 1;
+  const int PAD       = pencilScratch::PAD;
+  const int padLength = numZones + 2*PAD;
+  const int zoneStart = faceStart - 1;
+
+  /* Gather */
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    double *y = &scratch.primLine[var*padLength + PAD];
+    for (int n=-PAD; n < numZones + PAD; n++)
+    {
+      y[n] = pencilValue(primPtr[var], offset, lineLength, lineStride,
+                         zoneStart + n
+                        );
+    }
+  }
+
+  /* Reconstruction */
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    const double *y = &scratch.primLine[var*padLength + PAD];
+    double *left    = &scratch.primLeftLine[var*numZones];
+    double *right   = &scratch.primRightLine[var*numZones];
+    switch (params::reconstruction)
+    {
+      case reconstructionOptions::MINMOD:
+        #pragma omp simd
+        for (int n=0; n < numZones; n++)
+        {
+          reconstructMMPoint(&y[n], left[n], right[n]);
+        }
+        break;
+
+      case reconstructionOptions::WENO5:
+        #pragma omp simd
+        for (int n=0; n < numZones; n++)
+        {
+          reconstructWENO5Point(&y[n], left[n], right[n]);
+        }
+        break;
+
+      case reconstructionOptions::PPM:
+        #pragma omp simd
+        for (int n=0; n < numZones; n++)
+        {
+          reconstructPPMPoint(&y[n], left[n], right[n]);
+        }
+        break;
+    }
+  }
+
+  /* Face 0 takes its left state from the last zone of the pencil, with that
+   * zone's own stencil */
+  if (zoneStart < 0)
+  {
+    for (int var=0; var < NUM_IDEAL_VARS; var++)
+    {
+      double y[2*PAD + 1];
+      for (int m=-PAD; m <= PAD; m++)
+      {
+        y[m + PAD] = pencilValue(primPtr[var], offset, lineLength, lineStride,
+                                 lineLength - 1 + m
+                                );
+      }
+      reconstructPoint(&y[PAD], scratch.primLeftLine[var*numZones],
+                                scratch.primRightLine[var*numZones]
+                      );
+    }
+  }
+
+  /* States on both sides of every face. primRight at zone n with the face
+   * metric of zone n+1 gives the left state of face n+1/2; primLeft at zone
+   * n with the face metric of zone n gives the right state of face n-1/2. */
+  #pragma omp simd
+  for (int n=0; n < numZones; n++)
+  {
+    const int i        = (zoneStart + n + lineLength) % lineLength;
+    const int zone     = offset + i*lineStride;
+    const int zoneNext = offset + ((i + 1) % lineLength)*lineStride;
+    metricPoint m;
+    fluidPoint f;
+    double fluxPoint[NUM_IDEAL_VARS], consPoint[NUM_IDEAL_VARS];
+
+    const double *primRight = &scratch.primRightLine[n];
+    loadMetric(geomFacePtrs, zoneNext, m);
+    setFluidPoint(primRight[vars::RHO*numZones], primRight[vars::U *numZones],
+                  primRight[vars::U1 *numZones], primRight[vars::U2*numZones],
+                  primRight[vars::U3 *numZones],
+                  primRight[vars::B1 *numZones], primRight[vars::B2*numZones],
+                  primRight[vars::B3 *numZones],
+                  m, f
+                 );
+    computeFluxesPoint(f, m, dir+1, fluxPoint);
+    computeFluxesPoint(f, m, 0,     consPoint);
+    computeMinMaxCharSpeedsPoint(f, m, dir,
+                                 scratch.minSpeedLeft[n],
+                                 scratch.maxSpeedLeft[n]
+                                );
+    for (int var=0; var < NUM_IDEAL_VARS; var++)
+    {
+      scratch.fluxLeftLine[var*numZones + n] = fluxPoint[var];
+      scratch.consLeftLine[var*numZones + n] = consPoint[var];
+    }
+
+    const double *primLeft = &scratch.primLeftLine[n];
+    loadMetric(geomFacePtrs, zone, m);
+    setFluidPoint(primLeft[vars::RHO*numZones], primLeft[vars::U *numZones],
+                  primLeft[vars::U1 *numZones], primLeft[vars::U2*numZones],
+                  primLeft[vars::U3 *numZones],
+                  primLeft[vars::B1 *numZones], primLeft[vars::B2*numZones],
+                  primLeft[vars::B3 *numZones],
+                  m, f
+                 );
+    computeFluxesPoint(f, m, dir+1, fluxPoint);
+    computeFluxesPoint(f, m, 0,     consPoint);
+    computeMinMaxCharSpeedsPoint(f, m, dir,
+                                 scratch.minSpeedRight[n],
+                                 scratch.maxSpeedRight[n]
+                                );
+    for (int var=0; var < NUM_IDEAL_VARS; var++)
+    {
+      scratch.fluxRightLine[var*numZones + n] = fluxPoint[var];
+      scratch.consRightLine[var*numZones + n] = consPoint[var];
+    }
+  }
+
+  /* Face n sits between positions n and n+1 */
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    const double *fluxLeft  = &scratch.fluxLeftLine[var*numZones];
+    const double *consLeft  = &scratch.consLeftLine[var*numZones];
+    const double *fluxRight = &scratch.fluxRightLine[var*numZones];
+    const double *consRight = &scratch.consRightLine[var*numZones];
+
+    #pragma omp simd
+    for (int n=0; n < numFaces; n++)
+    {
+      const double minSpeed = std::min(scratch.minSpeedLeft[n],
+                                       scratch.minSpeedRight[n+1]
+                                      );
+      const double maxSpeed = std::max(scratch.maxSpeedLeft[n],
+                                       scratch.maxSpeedRight[n+1]
+                                      );
+
+      faceFluxes[var*numFaces + n] =
+        riemannFluxPoint(fluxLeft[n],  consLeft[n],
+                         fluxRight[n+1], consRight[n+1],
+                         minSpeed, maxSpeed
+                        );
+    }
+  }
+}
@@ -0,0 +1,164 @@
+#include "native.hpp"
+#include <omp.h>
+
+void native::computeDivOfFluxesTiled(const grid &prim,
+                                     const geometry *geomFace[3],
+                                     const double dX[3],
+                                     const int tileSize[3],
+                                     grid *fluxes[3],
+                                     grid &divFluxes
+                                    )
+{
+  const int dim       = prim.dim;
+  const int N[3]      = {prim.N1Total, prim.N2Total, prim.N3Total};
+  const int stride[3] = {1, prim.N1Total, prim.N1Total*prim.N2Total};
+
+  int tile[3], numTiles[3];
+  for (int d=0; d < 3; d++)
+  {
+    tile[d]     = std::max(1, std::min(tileSize[d], N[d]));
+    numTiles[d] = (N[d] + tile[d] - 1)/tile[d];
+  }
+  const int totalTiles = numTiles[0]*numTiles[1]*numTiles[2];
+
+  /* Same filter coefficients as the convolve in computeDivOfFluxes() */
+  const double invdX[3] = {1./dX[0], 1./dX[1], 1./dX[2]};
+
+  hostArrays host;
+  const double *primPtr[NUM_IDEAL_VARS];
+  double *divPtr[NUM_IDEAL_VARS];
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    primPtr[var] = host.read(prim.vars[var]);
+  }
+  geometryPtrs geomFacePtrs[3];
+  for (int d=0; d < dim; d++)
+  {
+    getGeometryPtrs(*geomFace[d], false, host, geomFacePtrs[d]);
+  }
+
+  for (int var=0; var < NUM_IDEAL_VARS; var++)
+  {
+    divPtr[var] = host.write(divFluxes.vars[var], N[0], N[1], N[2]);
+  }
+  /* Only the magnetic field fluxes leave the tiles, for constrained
+   * transport */
+  double *fluxBPtr[3][NUM_IDEAL_VARS];
+  for (int d=0; d < dim; d++)
+  {
+    for (int var=vars::B1; var <= vars::B3; var++)
+    {
+      fluxBPtr[d][var] = host.write(fluxes[d]->vars[var], N[0], N[1], N[2]);
+    }
+  }
+
+  #pragma omp parallel
+  {
+    double threadStart = omp_get_wtime();
+
+    /* Tile-local scratch */
+    pencilScratch scratch;
+    scratch.resize(*std::max_element(tile, tile+3) + 2);
+    std::vector<double> faceFluxes(  NUM_IDEAL_VARS
+                                   * (*std::max_element(tile, tile+3) + 1)
+                                  );
+    std::vector<double> tileDiv(NUM_IDEAL_VARS*tile[0]*tile[1]*tile[2]);
+
+    #pragma omp for schedule(dynamic) nowait
+    for (int t=0; t < totalTiles; t++)
+    {
+      int lo[3], hi[3], length[3];
+      lo[0] = (t % numTiles[0])*tile[0];
+      lo[1] = ((t / numTiles[0]) % numTiles[1])*tile[1];
+      lo[2] = (t / (numTiles[0]*numTiles[1]))*tile[2];
+      for (int d=0; d < 3; d++)
+      {
+        hi[d]     = std::min(lo[d] + tile[d], N[d]) - 1;
+        length[d] = hi[d] - lo[d] + 1;
+      }
+      const int tileVolume     = length[0]*length[1]*length[2];
+      const int tileStride[3]  = {1, length[0], length[0]*length[1]};
+
+      for (int d=0; d < dim; d++)
+      {
+        const int dirA = (d==directions::X1 ? directions::X2 : directions::X1);
+        const int dirB = (d==directions::X3 ? directions::X2 : directions::X3);
+
+        /* Faces lo..hi+1 along d; the face past the end of the local domain
+         * is zero, as in the convolve */
+        const int faceStart = lo[d];
+        const int faceEnd   = std::min(hi[d] + 1, N[d] - 1);
+        const int numFaces  = faceEnd - faceStart + 1;
+
+        for (int b=lo[dirB]; b <= hi[dirB]; b++)
+        {
+          for (int a=lo[dirA]; a <= hi[dirA]; a++)
+          {
+            const int offset = a*stride[dirA] + b*stride[dirB];
+            const int tileOffset =   (a - lo[dirA])*tileStride[dirA]
+                                   + (b - lo[dirB])*tileStride[dirB];
+
+            pencilFaceFluxes(primPtr, geomFacePtrs[d],
+                             d, offset, N[d], stride[d],
+                             faceStart, faceEnd, scratch, &faceFluxes[0]
+                            );
+
+            for (int var=0; var < NUM_IDEAL_VARS; var++)
+            {
+              const double *F = &faceFluxes[var*numFaces];
+              double *div     = &tileDiv[var*tileVolume + tileOffset];
+
+              for (int n=0; n < length[d]; n++)
+              {
+                double dFlux_dX =   (n+1 < numFaces ? F[n+1]*invdX[d] : 0.)
+                                  - F[n]*invdX[d];
+                if (d==0)
+                {
+                  div[n*tileStride[d]] = dFlux_dX;
+                }
+                else
+                {
+                  div[n*tileStride[d]] = div[n*tileStride[d]] + dFlux_dX;
+                }
+              }
+            }
+
+            /* Every face belongs to exactly one tile */
+            for (int var=vars::B1; var <= vars::B3; var++)
+            {
+              for (int n=0; n < length[d]; n++)
+              {
+                fluxBPtr[d][var][offset + (lo[d] + n)*stride[d]] =
+                  faceFluxes[var*numFaces + n];
+              }
+            }
+          }
+        }
+      }
+
+      for (int var=0; var < NUM_IDEAL_VARS; var++)
+      {
+        for (int k=lo[2]; k <= hi[2]; k++)
+        {
+          for (int j=lo[1]; j <= hi[1]; j++)
+          {
+            const double *div =
+              &tileDiv[  var*tileVolume
+                       + (j - lo[1])*tileStride[1]
+                       + (k - lo[2])*tileStride[2]
+                      ];
+            double *divGlobal = &divPtr[var][lo[0] + j*stride[1] + k*stride[2]];
+
+            #pragma omp simd
+            for (int n=0; n < length[0]; n++)
+            {
+              divGlobal[n] = div[n];
+            }
+          }
+        }
+      }
+    }
+
+    threads::addThreadTime(omp_get_wtime() - threadStart);
+  }
+}
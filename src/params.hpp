@@ -73,6 +73,24 @@ namespace solvers
   };
 }
 
+/* Per-zone status of the ideal solver, stored in
+ * timeStepper::idealSolverFailures */
+namespace idealSolverStatus
+{
+  enum
+  {
+    CONVERGED, NOT_CONVERGED, UNPHYSICAL
+  };
+};
+
+namespace profileFormats
+{
+  enum
+  {
+    JSON, CSV
+  };
+};
+
 namespace riemannSolvers
 {
   enum
@@ -113,7 +131,13 @@ namespace params
   extern std::string restartFile;
   extern std::string restartFileName;
   extern std::string restartFileTime;
+  extern int restartWithoutInitialConditions;
+  extern int restartChangeResolution;
   extern double MaxWallTime;
+  extern int checkpointOnSignal;
+  extern int checkpointEveryNSteps;
+  extern double checkpointEveryWallTime;
+  extern int numCheckpointsKept;
 
   extern double X1Start, X1End;
   extern double X2Start, X2End;
@@ -122,6 +146,11 @@ namespace params
   extern int DerefineThetaHorizon;
   extern int DoCylindrify;
   extern double X1cyl, X2cyl;
+  extern std::string X1MapFile, X2MapFile;
+  extern int analyticConnectionCoeffs;
+  extern int checkConnectionCoeffs;
+  extern int geometryCache;
+  extern std::string geometryCacheDirectory;
 
   extern int boundaryLeft;
   extern int boundaryRight;
@@ -157,6 +186,30 @@ namespace params
   extern double linesearchfloor;
   extern int    linearSolver;
   extern int    solver;
+  extern int    maxIdealSolverIter;
+  extern double idealSolverTol;
+  extern int    benchmarkIdealSolver;
+  extern int    tiledFluxes;
+  extern int    tileSizeX1, tileSizeX2, tileSizeX3;
+  extern int    benchmarkFluxTiles;
+  extern int    fluxTasks;
+  extern int    linesPerTask;
+  extern int    numThreads;
+  extern int    pinThreads;
+  extern int    loadBalance;
+  extern std::string zoneCostFile;
+  extern int    ioAggregatorsPerNode;
+  extern int    ioAggregationGroupSize;
+  extern int    profileEveryNSteps;
+  extern int    profileSync;
+  extern int    profileCounters;
+  extern int    profileFormat;
+  extern std::string profileFile;
+  extern int    traceStartStep;
+  extern int    traceNumSteps;
+  extern std::string traceFile;
+  extern int    bandwidthProbe;
+  extern std::string bandwidthCacheFile;
 
   //Atmosphere parameters
   extern double MaxLorentzFactor;
@@ -0,0 +1,24 @@
+import pytest
+
+def pytest_addoption(parser):
+  parser.addoption("--build_path", action="store", default=None,
+                   help='set build directory path'
+                  )
+  parser.addoption("--problem", action="store", default='torus',
+                   help='problem the build was configured with'
+                  )
+  parser.addoption("--baseline", action="store", default=None,
+                   help='baseline file of the problem'
+                  )
+  parser.addoption("--tolerance", action="store", default=0.1,
+                   help='allowed relative slowdown'
+                  )
+  parser.addoption("--repeats", action="store", default=3,
+                   help='runs per check, the fastest one is compared'
+                  )
+  parser.addoption("--mpirun", action="store", default='mpirun',
+                   help='MPI launcher and its options'
+                  )
+  parser.addoption("--update_baseline", action="store_true", default=False,
+                   help='write the measured performance to the baseline file'
+                  )
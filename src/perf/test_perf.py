@@ -0,0 +1,225 @@
+"""Performance regression check of the problem the build was configured with.
+
+Runs grim_scaling (see scaling.cpp) on a fixed small configuration of the
+problem and compares the zone-cycles/sec/rank and the time per step of each
+profiler stage with the baseline file of the problem, perf/baselines/
+<problem>.csv. A drop in zone-cycles/sec/rank or a slower stage by more than
+the tolerance fails the test; the stage by stage diff is in the failure
+message and in perf_<problem>/diff.txt in the build folder.
+
+Baselines depend on the machine: record them on the machine that runs the
+checks, from a build of a known good version,
+
+  py.test perf/test_perf.py --build_path=<build> --problem=torus \\
+          --baseline=perf/baselines/torus.csv --update_baseline
+
+and commit the file. A configured problem without a baseline fails; problems
+without a configuration below are skipped. A baseline with a
+'note,provisional' row, or without stage times, has not been recorded on the
+reference machine: the run and the diff still happen, but the test is
+reported as xfail with reason "provisional baseline" rather than passing.
+The committed baselines are provisional.
+"""
+import csv
+import os
+import subprocess
+import pytest
+
+buildPath      = pytest.config.getoption('build_path')
+problem        = pytest.config.getoption('problem')
+baselineFile   = pytest.config.getoption('baseline')
+tolerance      = float(pytest.config.getoption('tolerance'))
+numRepeats     = int(pytest.config.getoption('repeats'))
+mpirun         = pytest.config.getoption('mpirun')
+updateBaseline = pytest.config.getoption('update_baseline')
+
+# Fixed configurations, small enough for a test but large enough that the
+# step is not dominated by launch overheads. Changing one needs new baselines.
+configs = {'torus'       : {'ranks' : 2, 'dim' : 2, 'N' : (96, 96, 1),
+                            'steps' : 10
+                           },
+           'orzag_tang'  : {'ranks' : 2, 'dim' : 2, 'N' : (128, 128, 1),
+                            'steps' : 20
+                           },
+           'shock_tests' : {'ranks' : 2, 'dim' : 1, 'N' : (1024, 1, 1),
+                            'steps' : 50
+                           }
+          }
+
+# Stages below this fraction of the step time are in the noise
+minStageFraction = 0.02
+# Stages deeper than this are not compared
+maxStageDepth = 2
+
+def runOnce(config, outPath, n):
+  profileFile = os.path.join(outPath, 'profile_%d.csv' % n)
+  summaryFile = os.path.join(outPath, 'summary_%d.csv' % n)
+  for fileName in (profileFile, summaryFile):
+    if os.path.exists(fileName):
+      os.remove(fileName)
+
+  N = ','.join([str(Ni) for Ni in config['N'][:config['dim']]])
+  command = mpirun.split() + ['-np', str(config['ranks']),
+                              os.path.join(buildPath, 'grim_scaling'),
+                              '-scaling_N', N,
+                              '-scaling_dim', str(config['dim']),
+                              '-scaling_steps', str(config['steps']),
+                              '-scaling_profile', profileFile,
+                              '-scaling_file', summaryFile
+                             ]
+  with open(os.path.join(outPath, 'log_%d.txt' % n), 'w') as log:
+    returnCode = subprocess.call(command, stdout=log,
+                                 stderr=subprocess.STDOUT
+                                )
+  assert returnCode == 0, \
+    'grim_scaling failed, see %s' % os.path.join(outPath, 'log_%d.txt' % n)
+
+  with open(summaryFile) as summary:
+    rate = float(list(csv.DictReader(summary))[-1]['zoneCyclesPerSecPerRank'])
+
+  with open(profileFile) as profile:
+    rows = list(csv.DictReader(profile))
+  lastStep = rows[-1]['step']
+  stageTimes = {}
+  for row in rows:
+    if row['step'] == lastStep and int(row['depth']) <= maxStageDepth:
+      stageTimes[row['region']] = float(row['avg'])
+
+  return rate, stageTimes
+
+def measure(config):
+  """Fastest of numRepeats runs: the largest rate, and the smallest time of
+  each stage."""
+  outPath = os.path.join(buildPath, 'perf_' + problem)
+  if not os.path.isdir(outPath):
+    os.makedirs(outPath)
+
+  bestRate = 0.
+  bestTimes = {}
+  for n in range(numRepeats):
+    rate, stageTimes = runOnce(config, outPath, n)
+    bestRate = max(bestRate, rate)
+    for stage, time in stageTimes.items():
+      bestTimes[stage] = min(time, bestTimes.get(stage, time))
+
+  return bestRate, bestTimes, outPath
+
+def configRows(config):
+  return [('ranks', config['ranks']), ('dim', config['dim']),
+          ('N1', config['N'][0]), ('N2', config['N'][1]),
+          ('N3', config['N'][2]), ('steps', config['steps'])
+         ]
+
+def writeBaseline(fileName, config, rate, stageTimes):
+  with open(fileName, 'w') as baseline:
+    writer = csv.writer(baseline)
+    writer.writerow(['kind', 'name', 'value'])
+    for name, value in configRows(config):
+      writer.writerow(['config', name, value])
+    writer.writerow(['rate', 'zoneCyclesPerSecPerRank', '%.6e' % rate])
+    for stage in sorted(stageTimes):
+      writer.writerow(['time', stage, '%.6e' % stageTimes[stage]])
+
+def readBaseline(fileName):
+  baselineConfig = {}
+  rate = 0.
+  stageTimes = {}
+  notes = []
+  with open(fileName) as baseline:
+    for row in csv.DictReader(baseline):
+      if row['kind'] == 'note':
+        notes.append('%s: %s' % (row['name'], row['value']))
+      elif row['kind'] == 'config':
+        baselineConfig[row['name']] = int(row['value'])
+      elif row['kind'] == 'rate':
+        rate = float(row['value'])
+      elif row['kind'] == 'time':
+        stageTimes[row['name']] = float(row['value'])
+  return baselineConfig, rate, stageTimes, notes
+
+def compare(baselineRate, baselineTimes, rate, stageTimes):
+  """Returns the diff, a list of lines, and the regressions in it."""
+  lines = []
+  regressions = []
+
+  change = rate/baselineRate - 1.
+  status = 'REGRESSED' if change < -tolerance else 'ok'
+  lines.append('  %-40s %12.4e %12.4e %+8.1f%%  %s'
+               % ('zone-cycles/sec/rank', baselineRate, rate, 100.*change,
+                  status
+                 )
+              )
+  if status != 'ok':
+    regressions.append('zone-cycles/sec/rank')
+
+  stepTime = max(baselineTimes.get('step', 0.), stageTimes.get('step', 0.))
+  for stage in sorted(set(baselineTimes) | set(stageTimes)):
+    if stage not in stageTimes:
+      lines.append('  %-40s %12.4e %12s %9s  not run'
+                   % (stage, baselineTimes[stage], '-', '')
+                  )
+      continue
+    if stage not in baselineTimes:
+      lines.append('  %-40s %12s %12.4e %9s  new'
+                   % (stage, '-', stageTimes[stage], '')
+                  )
+      continue
+    change = stageTimes[stage]/baselineTimes[stage] - 1.
+    status = 'ok'
+    if change > tolerance:
+      if max(baselineTimes[stage], stageTimes[stage]) < minStageFraction*stepTime:
+        status = 'slower, below noise floor'
+      else:
+        status = 'REGRESSED'
+        regressions.append(stage)
+    lines.append('  %-40s %12.4e %12.4e %+8.1f%%  %s'
+                 % (stage, baselineTimes[stage], stageTimes[stage],
+                    100.*change, status
+                   )
+                )
+
+  header = ['  %s, tolerance %g%%' % (problem, 100.*tolerance),
+            '  %-40s %12s %12s %9s' % ('', 'baseline', 'current', 'change')
+           ]
+  return header + lines, regressions
+
+def test_performance():
+  if problem not in configs:
+    pytest.skip('no performance configuration for problem ' + problem)
+  config = configs[problem]
+
+  if updateBaseline:
+    rate, stageTimes, outPath = measure(config)
+    writeBaseline(baselineFile, config, rate, stageTimes)
+    return
+
+  assert baselineFile is not None and os.path.exists(baselineFile), \
+    'no baseline %s for problem %s, record one with --update_baseline' \
+    % (baselineFile, problem)
+
+  baselineConfig, baselineRate, baselineTimes, notes = \
+    readBaseline(baselineFile)
+  assert baselineConfig == dict(configRows(config)), \
+    'baseline %s was recorded with another configuration, record it again' \
+    % baselineFile
+
+  provisional = any([note.startswith('provisional:') for note in notes]) \
+                or len(baselineTimes) == 0
+
+  rate, stageTimes, outPath = measure(config)
+  lines, regressions = compare(baselineRate, baselineTimes, rate, stageTimes)
+  if len(baselineTimes) == 0:
+    lines.append('  baseline has no stage times')
+  lines += ['  ' + note for note in notes]
+  diff = '\n'.join(lines)
+  with open(os.path.join(outPath, 'diff.txt'), 'w') as diffFile:
+    diffFile.write(diff + '\n')
+  print(diff)
+
+  if provisional:
+    pytest.xfail('provisional baseline %s, not recorded on the reference '
+                 'machine: nothing is checked' % baselineFile
+                )
+
+  assert len(regressions) == 0, \
+    'performance regression in %s:\n%s' % (', '.join(regressions), diff)
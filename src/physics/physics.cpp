@@ -1,9 +1,7 @@
 #include "physics.hpp"
 
 fluidElement::fluidElement(const grid &prim,
-                           geometry &geom_,
-                           int &numReads,
-                           int &numWrites
+                           geometry &geom_
                           )
 {
   this->geom = &geom_;
@@ -42,7 +40,7 @@ fluidElement::fluidElement(const grid &prim,
     q0 = zero;
   }
 
-  set(prim, *geom, numReads, numWrites);
+  set(prim, *geom);
 }
 
 fluidElement::~fluidElement()
@@ -51,9 +49,7 @@ fluidElement::~fluidElement()
 }
 
 void fluidElement::set(const grid &prim,
-                       geometry &geom_,
-                       int &numReads,
-                       int &numWrites
+                       geometry &geom_
                       )
 {
   this->geom = &geom_;
@@ -73,41 +69,69 @@ void fluidElement::set(const grid &prim,
                          /(rho+params::adiabaticIndex*u)
                         );
   
-  gammaLorentzFactor =
-    af::sqrt(1 + geom->gCov[1][1] * u1 * u1
-               + geom->gCov[2][2] * u2 * u2
-               + geom->gCov[3][3] * u3 * u3
-
-             + 2*(  geom->gCov[1][2] * u1 * u2
-                  + geom->gCov[1][3] * u1 * u3
-                  + geom->gCov[2][3] * u2 * u3
-                 )
-            );
-
-  uCon[0] = gammaLorentzFactor/geom->alpha;
-  uCon[1] = u1 - gammaLorentzFactor*geom->gCon[0][1]*geom->alpha;
-  uCon[2] = u2 - gammaLorentzFactor*geom->gCon[0][2]*geom->alpha;
-  uCon[3] = u3 - gammaLorentzFactor*geom->gCon[0][3]*geom->alpha;
-
-  for (int mu=0; mu < NDIM; mu++)
+  if (geom->isFlat)
   {
-    uCov[mu] =  geom->gCov[mu][0] * uCon[0]
-              + geom->gCov[mu][1] * uCon[1]
-              + geom->gCov[mu][2] * uCon[2]
-              + geom->gCov[mu][3] * uCon[3];
-  } 
-
-  bCon[0] =  B1*uCov[1] + B2*uCov[2] + B3*uCov[3];
-  bCon[1] = (B1 + bCon[0] * uCon[1])/uCon[0];
-  bCon[2] = (B2 + bCon[0] * uCon[2])/uCon[0];
-  bCon[3] = (B3 + bCon[0] * uCon[3])/uCon[0];
-
-  for (int mu=0; mu < NDIM; mu++)
+    /* Minkowski: alpha = 1, no shift, gCov = diag(-1, 1, 1, 1) */
+    gammaLorentzFactor = af::sqrt(1 + u1*u1 + u2*u2 + u3*u3);
+
+    uCon[0] =  gammaLorentzFactor;
+    uCon[1] =  u1;
+    uCon[2] =  u2;
+    uCon[3] =  u3;
+
+    uCov[0] = -gammaLorentzFactor;
+    uCov[1] =  u1;
+    uCov[2] =  u2;
+    uCov[3] =  u3;
+
+    bCon[0] =  B1*u1 + B2*u2 + B3*u3;
+    bCon[1] = (B1 + bCon[0] * u1)/gammaLorentzFactor;
+    bCon[2] = (B2 + bCon[0] * u2)/gammaLorentzFactor;
+    bCon[3] = (B3 + bCon[0] * u3)/gammaLorentzFactor;
+
+    bCov[0] = -bCon[0];
+    bCov[1] =  bCon[1];
+    bCov[2] =  bCon[2];
+    bCov[3] =  bCon[3];
+  }
+  else
   {
-    bCov[mu] =  geom->gCov[mu][0] * bCon[0]
-              + geom->gCov[mu][1] * bCon[1]
-              + geom->gCov[mu][2] * bCon[2]
-              + geom->gCov[mu][3] * bCon[3];
+    gammaLorentzFactor =
+      af::sqrt(1 + geom->gCov[1][1] * u1 * u1
+                 + geom->gCov[2][2] * u2 * u2
+                 + geom->gCov[3][3] * u3 * u3
+
+               + 2*(  geom->gCov[1][2] * u1 * u2
+                    + geom->gCov[1][3] * u1 * u3
+                    + geom->gCov[2][3] * u2 * u3
+                   )
+              );
+
+    uCon[0] = gammaLorentzFactor/geom->alpha;
+    uCon[1] = u1 - gammaLorentzFactor*geom->gCon[0][1]*geom->alpha;
+    uCon[2] = u2 - gammaLorentzFactor*geom->gCon[0][2]*geom->alpha;
+    uCon[3] = u3 - gammaLorentzFactor*geom->gCon[0][3]*geom->alpha;
+
+    for (int mu=0; mu < NDIM; mu++)
+    {
+      uCov[mu] =  geom->gCov[mu][0] * uCon[0]
+                + geom->gCov[mu][1] * uCon[1]
+                + geom->gCov[mu][2] * uCon[2]
+                + geom->gCov[mu][3] * uCon[3];
+    } 
+
+    bCon[0] =  B1*uCov[1] + B2*uCov[2] + B3*uCov[3];
+    bCon[1] = (B1 + bCon[0] * uCon[1])/uCon[0];
+    bCon[2] = (B2 + bCon[0] * uCon[2])/uCon[0];
+    bCon[3] = (B3 + bCon[0] * uCon[3])/uCon[0];
+
+    for (int mu=0; mu < NDIM; mu++)
+    {
+      bCov[mu] =  geom->gCov[mu][0] * bCon[0]
+                + geom->gCov[mu][1] * bCon[1]
+                + geom->gCov[mu][2] * bCon[2]
+                + geom->gCov[mu][3] * bCon[3];
+    }
   }
 
   bSqr =  bCon[0]*bCov[0] + bCon[1]*bCov[1]
@@ -175,9 +199,6 @@ void fluidElement::set(const grid &prim,
       }
     }
   }
-
-  numReads  = 42;
-  numWrites = 38;
   
   /*std::vector<af::array *> arraysThatNeedEval{
       &gammaLorentzFactor,
@@ -200,26 +221,18 @@ void fluidElement::set(const grid &prim,
   if (params::conduction)
   {
     //arraysThatNeedEval.push_back(&q);
-
-    numReads  += 1;
-    numWrites += 1;
   }
 
   if (params::viscosity)
   {
     //arraysThatNeedEval.push_back(&deltaP);
-
-    numReads  += 1;
-    numWrites += 1;
   }
 
   //af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
 }
 
 void fluidElement::computeFluxes(const int dir,
-                                 grid &flux,
-                                 int &numReads,
-                                 int &numWrites
+                                 grid &flux
                                 )
 {
   array g = geom->g;
@@ -246,23 +259,17 @@ void fluidElement::computeFluxes(const int dir,
                 &flux.vars[vars::B2],  
                 &flux.vars[vars::B3]  
               };*/
-  numReads  = 12;
-  numWrites = 8;
 
   if (params::conduction)
   {
     flux.vars[vars::Q] = g*(uCon[dir] * qTilde);
     //arraysThatNeedEval.push_back(&flux.vars[vars::Q]);
-    numReads++;
-    numWrites++;
   }
 
   if (params::viscosity)
   {
     flux.vars[vars::DP] = g*(uCon[dir] * deltaPTilde);
     //arraysThatNeedEval.push_back(&flux.vars[vars::DP]);
-    numReads++;
-    numWrites++;
   }
 
   //af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
@@ -271,17 +278,13 @@ void fluidElement::computeFluxes(const int dir,
 void fluidElement::computeTimeDerivSources(const fluidElement &elemOld,
                                            const fluidElement &elemNew,
                                            const double dt,
-                                           grid &sources,
-                                           int &numReads,
-                                           int &numWrites
+                                           grid &sources
                                           )
 {
   for (int var=0; var<vars::dof; var++)
   {
     sources.vars[var] = 0.;
   }
-  numReads = 0;
-  numWrites = vars::dof;
 
   if (params::conduction || params::viscosity)
   {
@@ -368,6 +371,7 @@ void fluidElement::computeTimeDerivSources(const fluidElement &elemOld,
       arraysThatNeedEval.push_back(&sources.vars[vars::Q]);
     } /* End of conduction */
 
+    PROFILE_BYTES(profiler::arrayBytes(arraysThatNeedEval));
     af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
 
   } /* End of EMHD: viscosity || conduction */
@@ -376,9 +380,7 @@ void fluidElement::computeTimeDerivSources(const fluidElement &elemOld,
 
 
 void fluidElement::computeImplicitSources(grid &sources,
-                                          array &tauDamp,
-                                          int &numReads,
-                                          int &numWrites
+                                          array &tauDamp
                                          )
 {
   for (int var=0; var<vars::dof; var++)
@@ -386,9 +388,6 @@ void fluidElement::computeImplicitSources(grid &sources,
     sources.vars[var] = 0.;
   }
 
-  numReads = 0;
-  numWrites = 0;
-
   if (params::conduction || params::viscosity)
   {
     std::vector<af::array *> arraysThatNeedEval;
@@ -416,14 +415,13 @@ void fluidElement::computeImplicitSources(grid &sources,
       arraysThatNeedEval.push_back(&sources.vars[vars::Q]);
     } /* End of conduction */
 
+    PROFILE_BYTES(profiler::arrayBytes(arraysThatNeedEval));
     af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
   }
 }
 
 void fluidElement::computeExplicitSources(const double dX[3],
-                                          grid &sources,
-                                          int &numReads,
-                                          int &numWrites
+                                          grid &sources
                                          )
 {
   for (int var=0; var<vars::dof; var++)
@@ -434,8 +432,7 @@ void fluidElement::computeExplicitSources(const double dX[3],
   //Note on sign: residual computation places
   // the source terms on the LHS of the equation!
   // All ideal MHD terms are treated explicitly.
-  numReads = 0; numWrites = 0;
-  if (params::metric != metrics::MINKOWSKI)
+  if (!geom->isFlat)
   {
     for (int nu=0; nu<NDIM; nu++)
     {
@@ -470,13 +467,7 @@ void fluidElement::computeExplicitSources(const double dX[3],
     // shared by conduction and viscosity, i.e. 
     // u_{\mu;\nu} and u^{\mu}_{;\mu}
     // First computer derivatives using computeEMHDGradients
-    int numReadsEMHDGradients, numWritesEMHDGradients;
-    computeEMHDGradients(dX,
-                         numReadsEMHDGradients,
-                         numWritesEMHDGradients
-                        );
-    numReads  += numReadsEMHDGradients;
-    numWrites += numWritesEMHDGradients;
+    computeEMHDGradients(dX);
 
     // Compute divergence. We could compute it from the derivatives of uCon,
     //    but we already have u_{\mu;\nu}, so let's make use of it
@@ -573,50 +564,33 @@ void fluidElement::computeExplicitSources(const double dX[3],
 
   } /* End of EMHD: viscosity || conduction */
 
+  PROFILE_BYTES(profiler::arrayBytes(arraysThatNeedEval));
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
 }
 
-void fluidElement::computeEMHDGradients(const double dX[3],
-                                        int &numReads,
-                                        int &numWrites
-                                       )
+void fluidElement::computeEMHDGradients(const double dX[3])
 {
   double dX1 = dX[directions::X1];
   double dX2 = dX[directions::X2];
   double dX3 = dX[directions::X3];
-  
-  numReads = 0, numWrites = 0;
   for(int mu=0;mu<NDIM;mu++)
   {
     //Time derivative needs to be reset for reach residual computation,
     // so not computed here.
     graduCov[0][mu] = 0.;
   
-    int numReadsTmp, numWritesTmp;
-    graduCov[1][mu] = reconstruction::slope(directions::X1,dX1,uCov[mu],
-                                            numReadsTmp, numWritesTmp
-                                           );
-    numReads  += numReadsTmp;
-    numWrites += numWritesTmp;
+    graduCov[1][mu] = reconstruction::slope(directions::X1,dX1,uCov[mu]);
 
     graduCov[2][mu] = 0.;
     if(params::dim>1)
     {
-      graduCov[2][mu] = reconstruction::slope(directions::X2,dX2,uCov[mu],
-                                              numReadsTmp, numWritesTmp
-                                             );
-      numReads  += numReadsTmp;
-      numWrites += numWritesTmp;
+      graduCov[2][mu] = reconstruction::slope(directions::X2,dX2,uCov[mu]);
     }
   
     graduCov[3][mu] = 0.;
     if(params::dim>2)
     {
-      graduCov[3][mu] = reconstruction::slope(directions::X3,dX3,uCov[mu],
-                                              numReadsTmp, numWritesTmp
-                                             );
-      numReads  += numReadsTmp;
-      numWrites += numWritesTmp;
+      graduCov[3][mu] = reconstruction::slope(directions::X3,dX3,uCov[mu]);
     }
 
     for(int nu=0;nu<NDIM;nu++)
@@ -637,6 +611,7 @@ void fluidElement::computeEMHDGradients(const double dX[3],
           &graduCov[3][0], &graduCov[3][1],
           &graduCov[3][2], &graduCov[3][3]
           };
+  PROFILE_BYTES(profiler::arrayBytes(arraysThatNeedEval));
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
   
   if(params::conduction)
@@ -644,31 +619,18 @@ void fluidElement::computeEMHDGradients(const double dX[3],
     /* Time derivative not computed here */
     gradT[0] = 0.;
 
-    int numReadsTmp, numWritesTmp;
-    gradT[1] = reconstruction::slope(directions::X1,dX1,temperature,
-                                     numReadsTmp, numWritesTmp
-                                    );
-    numReads  += numReadsTmp;
-    numWrites += numWritesTmp;
+    gradT[1] = reconstruction::slope(directions::X1,dX1,temperature);
 
     gradT[2] = 0.;
     if(params::dim>1)
     {
-      gradT[2] = reconstruction::slope(directions::X2,dX2,temperature,
-                                       numReadsTmp, numWritesTmp
-                                      );
-      numReads  += numReadsTmp;
-      numWrites += numWritesTmp;
+      gradT[2] = reconstruction::slope(directions::X2,dX2,temperature);
     }  
 
     gradT[3] = 0.;
     if(params::dim>2)
     {
-      gradT[3] = reconstruction::slope(directions::X3,dX3,temperature,
-                                       numReadsTmp, numWritesTmp
-                                      );
-      numReads  += numReadsTmp;
-      numWrites += numWritesTmp;
+      gradT[3] = reconstruction::slope(directions::X3,dX3,temperature);
     }
   } /* End of conduction specific terms */
 }
@@ -13,10 +13,7 @@ inline int DELTA(int const &mu, int const &nu)
 
 class fluidElement
 {
-  void computeEMHDGradients(const double dX[3],
-                            int &numReads,
-                            int &numWrites
-                           );     
+  void computeEMHDGradients(const double dX[3]);
   public:
     array zero, one;
 
@@ -44,49 +41,35 @@ class fluidElement
     array bNorm;
 
     fluidElement(const grid &prim,
-                 geometry &geom,
-                 int &numReads,
-                 int &numWrites
+                 geometry &geom
                 );
     ~fluidElement();
 
     void set(const grid &prim,
-             geometry &geom,
-             int &numReads,
-             int &numWrites
+             geometry &geom
             );
     void setFluidElementParameters();
     void computeFluxes(const int direction,
-                       grid &flux,
-                       int &numReads,
-                       int &numWrites
+                       grid &flux
                       );                                
 
     void computeMinMaxCharSpeeds(const int dir,
                                  array &MinSpeed,
-                                 array &MaxSpeed,
-                                 int &numReads,
-                                 int &numWrites
+                                 array &MaxSpeed
                                 );
 
     void computeTimeDerivSources(const fluidElement &elemOld,
                                  const fluidElement &elemNew,
                                  const double dt,
-                                 grid &sources,
-                                 int &numReads,
-                                 int &numWrites
+                                 grid &sources
                                 );
 
     void computeImplicitSources(grid &sources,
-                                array &tauDamp,
-                                int &numReads,
-                                int &numWrites
+                                array &tauDamp
                                );
 
     void computeExplicitSources(const double dX[3],
-                                grid &sources,
-                                int &numReads,
-                                int &numWrites
+                                grid &sources
                                );
     
     void constructTetrads();
@@ -114,6 +97,8 @@ class riemannSolver
 
     grid *fluxLeft, *fluxRight;
     grid *consLeft, *consRight;
+    /* primRight shifted by one zone onto the face it was reconstructed at */
+    grid *primFace;
 
     array minSpeedLeft,  maxSpeedLeft;
     array minSpeedRight, maxSpeedRight;
@@ -123,12 +108,9 @@ class riemannSolver
 
     void solve(const grid &primLeft,
                const grid &primRight,
-               geometry &geomLeft,
-               geometry &geomRight,
+               geometry &geomFace,
                const int dir,
-               grid &flux,
-               int &numReads,
-               int &numWrites
+               grid &flux
               );
 };
 
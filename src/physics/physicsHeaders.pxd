@@ -4,12 +4,11 @@ from geometryHeaders cimport geometry
 cdef extern from "physics.hpp":
   cdef cppclass fluidElement:
     fluidElement(const grid &prim,
-                 const geometry &geom,
-                 int &numReads,
-                 int &numWrites
+                 const geometry &geom
                 )
+    void set(const grid &prim,
+             geometry &geom
+            )
     void computeFluxes(const int direction,
-                       grid &flux,
-                       int &numReads,
-                       int &numWrites
+                       grid &flux
                       )
@@ -15,8 +15,6 @@ cdef class fluidElementPy(object):
   def __cinit__(self, gridPy prim = gridPy(),
                       geometryPy geom = geometryPy()
                ):
-    cdef int numReads  = 0
-    cdef int numWrites = 0
     if (prim.usingExternalPtr):
       self.usingExternalPtr = 1
       self.elemPtr = NULL
@@ -24,21 +22,16 @@ cdef class fluidElementPy(object):
       
     self.usingExternalPtr = 0
     self.elemPtr = new fluidElement(prim.getGridPtr()[0],
-                                    geom.getGeometryPtr()[0],
-                                    numReads, numWrites
+                                    geom.getGeometryPtr()[0]
                                    )
 
   def computeFluxes(self, geometryPy geom,
                           const int direction,
                           gridPy flux
                    ):
-    cdef int numReads  = 0
-    cdef int numWrites = 0
     self.elemPtr.computeFluxes(direction,
-                               flux.getGridPtr()[0],
-                               numReads, numWrites
+                               flux.getGridPtr()[0]
                               )
-    return numReads, numWrites
 
   def __dealloc__(self):
     if (self.usingExternalPtr):
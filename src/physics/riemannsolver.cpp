@@ -32,10 +32,12 @@ riemannSolver::riemannSolver(const grid &prim,
                        false, false, false
                       );
 
-  int numReads, numWrites;
-  elemFace  = new fluidElement(prim, geom,
-                               numReads, numWrites
-                              );
+  primFace  = new grid(N1, N2, N3,
+                       dim, numVars, numGhost,
+                       false, false, false
+                      );
+
+  elemFace  = new fluidElement(prim, geom);
 
   /* Allocate space for the wavespeeds using elemFace->one */
   minSpeedLeft  = elemFace->one;
@@ -48,52 +50,28 @@ riemannSolver::~riemannSolver()
 {
   delete fluxLeft, fluxRight;
   delete consLeft, consRight;
+  delete primFace;
   delete elemFace;
 }
 
 void fluidElement::computeMinMaxCharSpeeds(const int dir,
                                            array &minSpeed,
-                                           array &maxSpeed,
-                                           int &numReads,
-                                           int &numWrites
+                                           array &maxSpeed
                                           )
 {
   array zero = 0.*one;
-  numReads = 0;
-  numWrites = 0;
   
   /* Alven speed */
   array cAlvenSqr = bSqr/(rho+params::adiabaticIndex*u+bSqr);
-  numReads += 3;
-  /* Reads:
-   * -----
-   *  bSqr, rho, u : 3
-   *
-   * Writes: 0
-   * ------ */
 
   /* Hydro sound speed */
   array csSqr = soundSpeed*soundSpeed;
-  numReads += 1;
-  /* Reads:
-   * -----
-   *  soundSpeed : 1
-   *
-   * Writes: 0
-   * ------ */
 
   /* Approximate contribution from dP */
   array cVisSqr = zero;
   if (params::viscosity)
   {
     cVisSqr = 4./3./(rho+params::adiabaticIndex*u)*rho*nu_emhd/tau;
-    numReads += 2;
-    /* Reads:
-     * -----
-     *  nu_emhd, tau : 2
-     *
-     * Writes: 0
-     * ------ */
   }
 
   /* Approximate contribution from Q */
@@ -101,14 +79,6 @@ void fluidElement::computeMinMaxCharSpeeds(const int dir,
   if (params::conduction)
   {
     cConSqr = (params::adiabaticIndex-1.)*chi_emhd/tau;
-    numReads += 1;
-    /* Reads:
-     * -----
-     *  nu_emhd : 1
-     *  (Not counting tau since it is already read if params::viscosity==1)
-     *
-     * Writes: 0
-     * ------ */
   }
   cConSqr = 0.5*(csSqr+cConSqr+af::sqrt(csSqr*csSqr+cConSqr*cConSqr));
   csSqr = cConSqr + cVisSqr;
@@ -132,47 +102,53 @@ void fluidElement::computeMinMaxCharSpeeds(const int dir,
       sdir=3; break;
   }
 
-  array ACov[NDIM], ACon[NDIM];
-  array BCov[NDIM], BCon[NDIM];
-  for (int mu=0; mu<NDIM; mu++)
+  /* Products of A_mu = delta_mu^dir and B_mu = delta_mu^0 */
+  array ASqr, BSqr, ADotU, BDotU, ADotB;
+  if (geom->isFlat)
   {
-    ACov[mu] = zero;
-    BCov[mu] = zero;
+    ASqr  = one;
+    BSqr  = -one;
+    ADotU = uCon[sdir];
+    BDotU = uCon[0];
+    ADotB = zero;
   }
-  ACov[sdir] = one;
-  BCov[0]    = one;
-  for (int mu=0; mu<NDIM; mu++)
+  else
   {
-    ACon[mu] = zero;
-    BCon[mu] = zero;
+    array ACov[NDIM], ACon[NDIM];
+    array BCov[NDIM], BCon[NDIM];
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      ACov[mu] = zero;
+      BCov[mu] = zero;
+    }
+    ACov[sdir] = one;
+    BCov[0]    = one;
+    for (int mu=0; mu<NDIM; mu++)
+    {
+      ACon[mu] = zero;
+      BCon[mu] = zero;
+
+      for(int nu=0;nu<NDIM; nu++)
+      {
+        ACon[mu] += geom->gCon[mu][nu]*ACov[nu];
+        BCon[mu] += geom->gCon[mu][nu]*BCov[nu];
+      }
+    }
 
-    for(int nu=0;nu<NDIM; nu++)
+    ASqr  = zero;
+    BSqr  = zero;
+    ADotU = zero;
+    BDotU = zero;
+    ADotB = zero;
+    for (int mu=0; mu<NDIM; mu++)
     {
-      ACon[mu] += geom->gCon[mu][nu]*ACov[nu];
-      BCon[mu] += geom->gCon[mu][nu]*BCov[nu];
+      ASqr += ACov[mu]*ACon[mu];
+      BSqr += BCov[mu]*BCon[mu];
+      ADotU += ACov[mu]*uCon[mu];
+      BDotU += BCov[mu]*uCon[mu];
+      ADotB += ACov[mu]*BCon[mu];
     }
   }
-  numReads += 16;
-  /* Reads:
-   * -----
-   * geom.gCon[mu][nu] : 16
-   *
-   * Writes: 0
-   * ------ */
-
-  array ASqr = zero;
-  array BSqr = zero;
-  array ADotU = zero;
-  array BDotU = zero;
-  array ADotB = zero;
-  for (int mu=0; mu<NDIM; mu++)
-  {
-    ASqr += ACov[mu]*ACon[mu];
-    BSqr += BCov[mu]*BCon[mu];
-    ADotU += ACov[mu]*uCon[mu];
-    BDotU += BCov[mu]*uCon[mu];
-    ADotB += ACov[mu]*BCon[mu];
-  }
 
   array A = (BDotU*BDotU)   - (BSqr + BDotU*BDotU)*csSqr;
   array B = 2.*(ADotU*BDotU - (ADotB + ADotU*BDotU)*csSqr);
@@ -191,23 +167,16 @@ void fluidElement::computeMinMaxCharSpeeds(const int dir,
   maxSpeed  = maxSpeed*(1-condition)+1.e-15*condition;
 
   //af::eval(minSpeed, maxSpeed);
-  numWrites += 2;
-  /* Reads: 0
-   * -----
-   *
-   * Writes:
-   * minSpeed, maxSpeed : 2
-   * ------ */
 }
 
+/* Fluxes on the left face i-1/2 of every zone. geomFace is the geometry on
+ * the left faces in direction dir; the right face of zone i is the left face
+ * of zone i+1, so one face geometry serves both states. */
 void riemannSolver::solve(const grid &primLeft,
                           const grid &primRight,
-                          geometry &geomLeft,
-                          geometry &geomRight,
+                          geometry &geomFace,
                           const int dir,
-                          grid &flux,
-                          int &numReads,
-                          int &numWrites
+                          grid &flux
                          )
 {
   int shiftX1, shiftX2, shiftX3;
@@ -236,61 +205,34 @@ void riemannSolver::solve(const grid &primLeft,
       break;
   }
 
-  int numReadsElemSet, numWritesElemSet;
-  int numReadsComputeFluxes, numWritesComputeFluxes;
-  int numReadsCharSpeeds, numWritesCharSpeeds;
-
-  /* Compute fluxes and cons at i+1/2 - eps : left flux on right face */
-  elemFace->set(primRight, geomRight,
-                numReadsElemSet, numWritesElemSet
-               );
-  elemFace->computeFluxes(fluxDirection, *fluxLeft,
-                          numReadsComputeFluxes, numWritesComputeFluxes
-                         );
-  elemFace->computeFluxes(0,             *consLeft,
-                          numReadsComputeFluxes, numWritesComputeFluxes
-                         );
+
+  /* primRight[i] is reconstructed at i+1/2. Shift it by a single point to
+   * the right so that primFace[i] is the left state at i-1/2. */
+  for (int var=0; var < primRight.numVars; var++)
+  {
+    primFace->vars[var] = af::shift(primRight.vars[var],
+                                    shiftX1, shiftX2, shiftX3
+                                   );
+  }
+
+  /* Compute fluxes and cons at i-1/2 - eps : left flux on left face */
+  elemFace->set(*primFace, geomFace);
+  elemFace->computeFluxes(fluxDirection, *fluxLeft);
+  elemFace->computeFluxes(0,             *consLeft);
   elemFace->computeMinMaxCharSpeeds(dir, 
-                                    minSpeedLeft, maxSpeedLeft,
-                                    numReadsCharSpeeds, numWritesCharSpeeds
+                                    minSpeedLeft, maxSpeedLeft
                                    );
 
   /* Compute fluxes and cons at i-1/2 + eps : right flux on left face */
-  elemFace->set(primLeft, geomLeft,
-                numReadsElemSet, numWritesElemSet
-               );
-  elemFace->computeFluxes(fluxDirection, *fluxRight,
-                          numReadsComputeFluxes, numWritesComputeFluxes
-                         );
-  elemFace->computeFluxes(0,             *consRight,
-                          numReadsComputeFluxes, numWritesComputeFluxes
-                         );
+  elemFace->set(primLeft, geomFace);
+  elemFace->computeFluxes(fluxDirection, *fluxRight);
+  elemFace->computeFluxes(0,             *consRight);
   elemFace->computeMinMaxCharSpeeds(dir, 
-                                    minSpeedRight, maxSpeedRight,
-                                    numReadsCharSpeeds, numWritesCharSpeeds
+                                    minSpeedRight, maxSpeedRight
                                    );
 
-  numReads = 2*(  numReadsElemSet + 2*numReadsComputeFluxes 
-                + numReadsCharSpeeds
-               );
-  numWrites = 2*(numWritesElemSet + 2*numWritesComputeFluxes
-                 + numWritesCharSpeeds
-                );
-
-  /* The fluxes are requested on the left-face i-1/2.
-   * Hence, we need to shift elemLeft,fluxLeft,consLeft by a single point to the right
-   * (elemLeft[i] refers to values at i+1/2, we want values at i-1/2) */
-  minSpeedLeft = af::shift(minSpeedLeft,shiftX1, shiftX2, shiftX3);
-  maxSpeedLeft = af::shift(maxSpeedLeft,shiftX1, shiftX2, shiftX3);
   minSpeedLeft = af::min(minSpeedLeft, minSpeedRight);
   maxSpeedLeft = af::max(maxSpeedLeft, maxSpeedRight);
-  numReads += 4;
-  /* Reads:
-   * -----
-   *  minSpeedLeft, minSpeedRight, maxSpeedLeft, maxSpeedRight : 4
-   *
-   * Writes: 0
-   * ------ */
 
   //std::vector<af::array *> arraysThatNeedEval;
   for (int var=0; var < primLeft.numVars; var++)
@@ -298,22 +240,22 @@ void riemannSolver::solve(const grid &primLeft,
     if (params::riemannSolver == riemannSolvers::HLL)
     {
       flux.vars[var] = 
-        (   maxSpeedLeft * af::shift(fluxLeft->vars[var], shiftX1, shiftX2, shiftX3) 
+        (   maxSpeedLeft * fluxLeft->vars[var]
           - minSpeedLeft * fluxRight->vars[var]
           + minSpeedLeft * maxSpeedLeft 
           * (  consRight->vars[var]
-             - af::shift(consLeft->vars[var], shiftX1, shiftX2, shiftX3)
+             - consLeft->vars[var]
             )
         )/(maxSpeedLeft - minSpeedLeft);
     }
     else if (params::riemannSolver == riemannSolvers::LOCAL_LAX_FRIEDRICH)
     {
       flux.vars[var] =
-       0.5*(af::shift(fluxLeft->vars[var], shiftX1, shiftX2, shiftX3)
+       0.5*(fluxLeft->vars[var]
             + fluxRight->vars[var]
             - af::max(maxSpeedLeft,-minSpeedLeft)*
             (  consRight->vars[var] 
-             - af::shift(consLeft->vars[var], shiftX1, shiftX2, shiftX3)
+             - consLeft->vars[var]
             )
            );
     }
@@ -321,13 +263,4 @@ void riemannSolver::solve(const grid &primLeft,
     //arraysThatNeedEval.push_back(&flux.vars[var]);
   }
   //af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
-  /* Reads:
-   * -----
-   *  fluxLeft[var], fluxRight[var], consLeft[var], consRight[var] : 4*numVars
-   *
-   * Writes:
-   * ------
-   * flux[var] : numVars */
-  numReads  += 4*primLeft.numVars;
-  numWrites +=   primLeft.numVars;
 }
@@ -7,10 +7,16 @@ void fluidElement::setFluidElementParameters()
   nu_emhd  = soundSpeed*soundSpeed*tau;
 }
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
 }
 
+/* The filter above leaves the fluid fluxes alone */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return false;
+}
+
 double FuncT(const double T, const double R, const double C1, const double C2)
 {
   double nPoly = 1./(params::adiabaticIndex-1.);
@@ -57,7 +63,7 @@ double SolveT(const double R, const double C1, const double C2)
   return Th;
 }
 
-void timeStepper::initialConditions(int &numReads,int &numWrites)
+void timeStepper::initialConditions()
 {
   const double nPoly = 1./(params::adiabaticIndex-1.);
   const double Rc = params::sonicRadius; 
@@ -145,18 +151,18 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
   af::sync();
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
   printf("halfStepDiagnostics\n");
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
   printf("fullStepDiagnostics: Time = %e\n",params::Time);
   //af_print(primOld->varsOld->vars[vars::RHO],8.);
 }
 
-void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
+void timeStepper::setProblemSpecificBCs()
 {
   for (int var=0; var<vars::dof; var++) 
     {
@@ -20,7 +20,7 @@ void fluidElement::setFluidElementParameters()
   tau      = 1.2 * chi_emhd/ (soundSpeed * soundSpeed);
 }
 
-void timeStepper::initialConditions(int &numReads, int &numWrites)
+void timeStepper::initialConditions()
 {
   PetscPrintf(PETSC_COMM_WORLD, "Setting up atmosphere...");
 
@@ -210,7 +210,7 @@ void timeStepper::initialConditions(int &numReads, int &numWrites)
   af::seq domainX2 = *primOld->domainX2;
   af::seq domainX3 = *primOld->domainX3;
   
-  computeDivB(*primOld, numReads, numWrites);
+  computeDivB(*primOld);
   double divBNorm = 
     af::norm(af::flat(divB->vars[0](domainX1, domainX2, domainX3)), AF_NORM_VECTOR_1);
   printf("divB = %g\n", divBNorm);
@@ -218,10 +218,7 @@ void timeStepper::initialConditions(int &numReads, int &numWrites)
 
 
 
-void timeStepper::setProblemSpecificBCs(
-                                        int &numReads, 
-                                        int &numWrites
-                                       )
+void timeStepper::setProblemSpecificBCs()
 {
   int numGhost = params::numGhost;
   // 1) Choose which primitive variables are corrected.
@@ -329,11 +326,11 @@ void timeStepper::setProblemSpecificBCs(
 
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
    bool WriteData = (floor(time/params::WriteDataEveryDt) != floor((time-dt)/params::WriteDataEveryDt));
   if(WriteData)
@@ -342,20 +339,24 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
     if(WriteIdx==0)
     {
       PetscPrintf(PETSC_COMM_WORLD, "Printing gCov\n");
-      geomCenter->gCovGrid->dump("gCov","gCovCenter.h5");
-      geomCenter->gConGrid->dump("gCon","gConCenter.h5");
-      geomCenter->gGrid->dump("sqrtDetg","sqrtDetgCenter.h5");
-      geomCenter->xCoordsGrid->dump("xCoords","xCoordsCenter.h5");
-
-      geomLeft->gCovGrid->dump("gCov","gCovLeft.h5");
-      geomLeft->gConGrid->dump("gCon","gConLeft.h5");
-      geomLeft->gGrid->dump("sqrtDetg","sqrtDetgLeft.h5");
-      geomLeft->xCoordsGrid->dump("xCoords","xCoordsLeft.h5");
-
-      geomBottom->gCovGrid->dump("gCov","gCovBottom.h5");
-      geomBottom->gConGrid->dump("gCon","gConBottom.h5");
-      geomBottom->gGrid->dump("sqrtDetg","sqrtDetgBottom.h5");
-      geomBottom->xCoordsGrid->dump("xCoords","xCoordsBottom.h5");
+      geomCenter->getgCovGrid()->dump("gCov","gCovCenter.h5");
+      geomCenter->getgConGrid()->dump("gCon","gConCenter.h5");
+      geomCenter->getgGrid()->dump("sqrtDetg","sqrtDetgCenter.h5");
+      geomCenter->getxCoordsGrid()->dump("xCoords","xCoordsCenter.h5");
+
+      geomFaces[directions::X1]->getgCovGrid()->dump("gCov","gCovLeft.h5");
+      geomFaces[directions::X1]->getgConGrid()->dump("gCon","gConLeft.h5");
+      geomFaces[directions::X1]->getgGrid()->dump("sqrtDetg","sqrtDetgLeft.h5");
+      geomFaces[directions::X1]->getxCoordsGrid()->dump("xCoords","xCoordsLeft.h5");
+
+      geomFaces[directions::X2]->getgCovGrid()->dump("gCov","gCovBottom.h5");
+      geomFaces[directions::X2]->getgConGrid()->dump("gCon","gConBottom.h5");
+      geomFaces[directions::X2]->getgGrid()->dump("sqrtDetg","sqrtDetgBottom.h5");
+      geomFaces[directions::X2]->getxCoordsGrid()->dump("xCoords","xCoordsBottom.h5");
+
+      geomCenter->releaseGrids();
+      geomFaces[directions::X1]->releaseGrids();
+      geomFaces[directions::X2]->releaseGrids();
     }
       
     std::string filename   = "primVarsT";
@@ -397,18 +398,25 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
       varNames[vars::DP]  = "dP";
     }
 
-    primOld->dumpVTS(*geomCenter->xCoordsGrid, varNames, filenameVTS);
+    primOld->dumpVTS(*geomCenter->getxCoordsGrid(), varNames, filenameVTS);
+    geomCenter->releaseGrids();
 
   }
 
-//  computeDivB(*primOld, numReads, numWrites);
+//  computeDivB(*primOld);
 //  double divBNorm = 
 //    af::norm(af::flat(divB->vars[0](domainX1, domainX2, domainX3)), AF_NORM_VECTOR_1);
 //  printf("divB = %g\n", divBNorm);
 
 }
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
 
 }
+
+/* The filter above leaves the fluid fluxes alone */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return false;
+}
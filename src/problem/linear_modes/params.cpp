@@ -23,6 +23,16 @@ namespace params
   std::string restartFile = "restartFile.h5";
   std::string restartFileName = "restartFileName.txt";
   std::string restartFileTime = "restartFileTime.txt";
+  // Generate the initial conditions before loading a checkpoint
+  int restartWithoutInitialConditions = 0;
+  // Only accept checkpoints of this resolution
+  int restartChangeResolution = 0;
+  // Checkpoints are only written by the torus problem; these are unused
+  double MaxWallTime = 1e30;
+  int checkpointOnSignal = 0;
+  int checkpointEveryNSteps = 0;
+  double checkpointEveryWallTime = 0.;
+  int numCheckpointsKept = 2;
 
   double X1Start = 0., X1End = 1.;
   double X2Start = 0., X2End = 1.;
@@ -78,6 +88,64 @@ namespace params
   int DoCylindrify = 1;
   double X1cyl = 0.;
   double X2cyl = 1./N2;
+
+  // Ideal solver: iterations and relative tolerance per zone, and the
+  // startup benchmark (0: off)
+  int maxIdealSolverIter = 8;
+  double idealSolverTol = 1.e-10;
+  int benchmarkIdealSolver = 0;
+
+  // Native backend flux tiling, and its startup benchmark (0: off)
+  int tiledFluxes = 0;
+  int tileSizeX1 = 32, tileSizeX2 = 8, tileSizeX3 = 8;
+  int benchmarkFluxTiles = 0;
+
+  // Native fluxes as an OpenMP task graph, linesPerTask pencils per task
+  int fluxTasks = 0;
+  int linesPerTask = 64;
+
+  // OpenMP threads per rank (0: OMP_NUM_THREADS), pinned to the rank's cores
+  int numThreads = 0;
+  int pinThreads = 1;
+
+  // Balance the decomposition with the cost map of the previous run
+  int loadBalance = 1;
+  std::string zoneCostFile = "zoneCost.h5";
+
+  // Profiler: region times every N steps (0: off), see torus/params.cpp
+  int profileEveryNSteps = 0;
+  int profileSync = 0;
+  int profileFormat = profileFormats::JSON;
+  std::string profileFile = "profile.json";
+
+  // Chrome trace of traceNumSteps steps from traceStartStep (0: off)
+  int traceStartStep = 1;
+  int traceNumSteps = 0;
+  std::string traceFile = "trace";
+
+  // Hardware counters per profiler region (perf_event)
+  int profileCounters = 0;
+
+  // Memory bandwidth for the roofline column: 0 reads the cache only
+  int bandwidthProbe = 0;
+  std::string bandwidthCacheFile = "bandwidth.txt";
+
+  // Closed form connection coefficients; 1 also compares with finite
+  // differences
+  int analyticConnectionCoeffs = 1;
+  int checkConnectionCoeffs = 0;
+
+  // Geometry cache on disk, keyed by the code and parameters (0: off)
+  int geometryCache = 0;
+  std::string geometryCacheDirectory = "geometryCache";
+
+  // Tables of r(X1) and theta(X2), for MODIFIED_KERR_SCHILD only
+  std::string X1MapFile = "";
+  std::string X2MapFile = "";
+
+  // Output through every rank (see torus/params.cpp for aggregation)
+  int ioAggregatorsPerNode = 0;
+  int ioAggregationGroupSize = 0;
 };
 
 namespace vars
@@ -7,7 +7,7 @@ void fluidElement::setFluidElementParameters()
   nu_emhd  = soundSpeed*soundSpeed*tau;
 }
 
-void timeStepper::initialConditions(int &numReads,int &numWrites)
+void timeStepper::initialConditions()
 {
   array xCoords[3];
   for(int d=0;d<3;d++)
@@ -110,12 +110,12 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
   af::sync();
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
 
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
   /* Compute the errors for the different modes */
 
@@ -179,7 +179,7 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
                             - params::Aw*sphi*0.016758537530754618
                            ) * exp(params::Gamma*time);
   
-  elemOld->set(*primOld, *geomCenter, numReads, numWrites);
+  elemOld->set(*primOld, *geomCenter);
 
   double errorRho = af::norm(af::flat(elemOld->rho     - rhoAnalytic));
   double errorU   = af::norm(af::flat(elemOld->u       - uAnalytic));
@@ -212,16 +212,22 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
   PetscPrintf(PETSC_COMM_WORLD, "     Error in B2  = %e\n", errorB2 );
 }
 
-void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
+void timeStepper::setProblemSpecificBCs()
 {
 
 }
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
 
 }
 
+/* The filter above leaves the fluid fluxes alone */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return false;
+}
+
 
 int timeStepper::CheckWallClockTermination()
 {
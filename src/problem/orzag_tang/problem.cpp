@@ -1,6 +1,6 @@
 #include "../problem.hpp"
 
-void timeStepper::initialConditions(int &numReads, int &numWrites)
+void timeStepper::initialConditions()
 {
   double X1Center = (params::X1Start + params::X1End)/2.;
   double X2Center = (params::X2Start + params::X2End)/2.;
@@ -40,22 +40,28 @@ void fluidElement::setFluidElementParameters()
   nu_emhd  = 0.01 * one;
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
 
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
 
 }
 
-void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
+void timeStepper::setProblemSpecificBCs()
 {
 
 }
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
 
 }
+
+/* The filter above leaves the fluid fluxes alone */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return false;
+}
@@ -17,7 +17,7 @@ void fluidElement::setFluidElementParameters()
   nu_emhd  = params::ViscosityAlpha  * soundSpeed*soundSpeed*tau;
 }
 
-void timeStepper::initialConditions(int &numReads,int &numWrites)
+void timeStepper::initialConditions()
 {
   double X1Center = (params::X1Start + params::X1End)/2.;
 
@@ -385,15 +385,15 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
   }
   af::sync();
 
-  fullStepDiagnostics(numReads, numWrites);
+  fullStepDiagnostics();
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
 
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
   bool WriteData  = 
     (floor(time/params::WriteDataEveryDt) != 
@@ -406,10 +406,11 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
       {
         PetscPrintf(PETSC_COMM_WORLD, "\n");
         PetscPrintf(PETSC_COMM_WORLD, "  Printing metric at zone CENTER...");
-        geomCenter->gCovGrid->dump("gCov","gCov.h5");
-        geomCenter->gConGrid->dump("gCon","gCon.h5");
-        geomCenter->gGrid->dump("sqrtDetg","sqrtDetg.h5");
-        geomCenter->xCoordsGrid->dump("xCoords","xCoords.h5");
+        geomCenter->getgCovGrid()->dump("gCov","gCov.h5");
+        geomCenter->getgConGrid()->dump("gCon","gCon.h5");
+        geomCenter->getgGrid()->dump("sqrtDetg","sqrtDetg.h5");
+        geomCenter->getxCoordsGrid()->dump("xCoords","xCoords.h5");
+        geomCenter->releaseGrids();
         PetscPrintf(PETSC_COMM_WORLD, "done\n\n");
       }
       std::string filename = "primVarsT";
@@ -443,7 +444,7 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
 
   if (params::shockTest == "stationary_shock_BVP_input")
   {
-    elemOld->set(*primOld, *geomCenter, numReads, numWrites);
+    elemOld->set(*primOld, *geomCenter);
     double errorRho = 
       af::norm(af::flat(elemOld->rho - primIC->vars[vars::RHO])(domainX1, span, span));
 
@@ -475,7 +476,7 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
   }
 }
 
-void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
+void timeStepper::setProblemSpecificBCs()
 {
   if (params::shockTest == "stationary_shock_BVP_input")
   {
@@ -516,11 +517,17 @@ void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
 
 }
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
 
 }
 
+/* The filter above leaves the fluid fluxes alone */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return false;
+}
+
 int timeStepper::CheckWallClockTermination()
 {
 
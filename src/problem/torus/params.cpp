@@ -20,9 +20,24 @@ namespace params
   int restart = 0;
   std::string restartFile = "restartFile.h5";
   std::string restartFileName = "restartFileName.txt";
+  // Only read for checkpoints without restart attributes
   std::string restartFileTime = "restartFileTime.txt";
+  // Restart from the checkpoint alone, without generating the initial
+  // conditions first. Set to 0 for problems whose boundaries use primIC
+  int restartWithoutInitialConditions = 1;
+  // Accept checkpoints of another resolution (same dimension and domain),
+  // prolonged or restricted onto this grid conserving the volume integrals
+  // of the primitives (not of the conserved variables), see prolongation.cpp
+  int restartChangeResolution = 0;
   // Maximum run time, in seconds
   double MaxWallTime = 3600*23.5;
+  // Checkpoint on SIGUSR1, and checkpoint and stop on SIGTERM
+  int checkpointOnSignal = 1;
+  // Also checkpoint every N steps and/or every so many seconds (0: never)
+  int checkpointEveryNSteps = 0;
+  double checkpointEveryWallTime = 0.;
+  // Older restartVarsStep*.h5 checkpoints in the run directory are deleted
+  int numCheckpointsKept = 2;
   
   // Observation / checkpointing intervals
   double ObserveEveryDt = .1;
@@ -84,6 +99,22 @@ namespace params
   int DoCylindrify = 0;
   double X1cyl = log(8.*Rin);
   double X2cyl = 1./N2;
+  // Tables of r(X1) and theta(X2), one "X x" pair per line, used instead of
+  // the maps above when set. The logical grid stays uniform in X1 and X2, so
+  // X1Start, X1End, X2Start and X2End are then table values of X
+  std::string X1MapFile = "";
+  std::string X2MapFile = "";
+  // Connection coefficients in closed form (1) or by finite differences of
+  // the metric (0). checkConnectionCoeffs = 1 computes both and prints the
+  // largest difference
+  int analyticConnectionCoeffs = 1;
+  int checkConnectionCoeffs = 0;
+
+  // Keep the geometry of each rank in geometryCacheDirectory, under a hash of
+  // the metric, grid and decomposition, and load it at the next start or
+  // restart with the same parameters instead of recomputing it
+  int geometryCache = 0;
+  std::string geometryCacheDirectory = "geometryCache";
 
   // Boundary Conditions
   // Radial
@@ -120,6 +151,68 @@ namespace params
 
   // Solver option
   int solver = solvers::IDEAL;
+  // Ideal solver: max iterations and relative tolerance on W, per zone
+  int maxIdealSolverIter = 8;
+  double idealSolverTol = 1.e-10;
+  // Number of evaluations for the ideal solver benchmark at startup (0: off)
+  int benchmarkIdealSolver = 0;
+  // Cache-blocked fluxes in the native backend: reconstruction, Riemann and
+  // divergence per tile. Only the B fluxes are stored, so the startup
+  // aborts when the flux filter changes the fluid fluxes (torus does).
+  int tiledFluxes = 0;
+  int tileSizeX1 = 32, tileSizeX2 = 8, tileSizeX3 = 8;
+  // Number of evaluations for the flux tiling benchmark at startup (0: off)
+  int benchmarkFluxTiles = 0;
+  // Native pencil fluxes as an OpenMP task graph with blocks of linesPerTask
+  // pencils, the blocks of all three directions running concurrently
+  int fluxTasks = 0;
+  int linesPerTask = 64;
+
+  // Hybrid MPI+OpenMP: run one rank per NUMA domain (e.g. mpirun --map-by
+  // numa --bind-to numa) with numThreads OpenMP threads each (0: use
+  // OMP_NUM_THREADS), pinned to the cores of the rank's domain. Not yet
+  // compared with flat MPI.
+  int numThreads = 0;
+  int pinThreads = 1;
+
+  // Domain decomposition: 0 splits the zones evenly, 1 balances the ranks
+  // using the cost map written with the restart files of the previous run
+  int loadBalance = 1;
+  std::string zoneCostFile = "zoneCost.h5";
+
+  // Output: 0 has every rank write its block through PETSc. N > 0 gathers
+  // the blocks on N ranks per node, which alone open the file and write;
+  // the files are the same either way
+  int ioAggregatorsPerNode = 0;
+  // N > 0 gathers on one rank per N consecutive ranks instead, across node
+  // boundaries, for runs with few ranks per node
+  int ioAggregationGroupSize = 0;
+
+  // Profiler (needs PROFILER ON in CMakeLists.txt): write per-region times,
+  // min/avg/max over ranks, every N steps (0: off). profileSync waits for
+  // the device at region boundaries; without it times of asynchronous
+  // ArrayFire work land in whichever region next waits for it.
+  int profileEveryNSteps = 0;
+  int profileSync = 0;
+  // Also count cycles, instructions, LLC misses and flops per region with
+  // perf_event (Linux; see /proc/sys/kernel/perf_event_paranoid), over all
+  // threads of the rank. Like the times, counts of asynchronous ArrayFire
+  // work need profileSync to land in their own region.
+  int profileCounters = 0;
+  int profileFormat = profileFormats::JSON;
+  std::string profileFile = "profile.json";
+  // Timeline of the profiler regions and MPI calls for traceNumSteps steps
+  // from traceStartStep (traceNumSteps = 0: off), one Chrome trace file per
+  // rank
+  int traceStartStep = 1;
+  int traceNumSteps = 0;
+  std::string traceFile = "trace";
+  // Memory bandwidth per rank that the profiler's roofline column refers
+  // to, cached per node (host name and ranks on the node) in
+  // bandwidthCacheFile. bandwidthProbe: 0 only reads the cache, 1 also
+  // measures nodes missing from it, 2 measures again.
+  int bandwidthProbe = 0;
+  std::string bandwidthCacheFile = "bandwidth.txt";
 
 };
 
@@ -140,7 +140,7 @@ double computeLnOfh(double a, double r, double theta)
 
 }
 
-void timeStepper::initialConditions(int &numReads,int &numWrites)
+void timeStepper::initialConditions()
 {
   PetscPrintf(PETSC_COMM_WORLD, "  Generating torus initial conditions...");
   // Random number generator from PeTSC
@@ -406,7 +406,7 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
   // Need to set fluid element to get b^2...
   double BFactor;
   {
-    elemOld->set(*primOld,*geomCenter,numReads,numWrites);
+    elemOld->set(*primOld,*geomCenter);
     const array& bSqr = elemOld->bSqr;
     const array& Pgas = elemOld->pressure;
     array PlasmaBeta = 2.*(Pgas+1.e-13)/(bSqr+1.e-18);
@@ -454,7 +454,7 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
     primOld->vars[vars::DP].eval();
   }
 
-  applyFloor(primOld,elemOld,geomCenter,numReads,numWrites);
+  applyFloor(primOld,elemOld,geomCenter);
 
   for (int var=0; var<vars::dof; var++) 
   {
@@ -468,10 +468,10 @@ void timeStepper::initialConditions(int &numReads,int &numWrites)
   PetscPrintf(PETSC_COMM_WORLD,"      rhoMax = %e\n",rhoMax);
   PetscPrintf(PETSC_COMM_WORLD,"      Bfactor = %e\n",BFactor);
 
-  fullStepDiagnostics(numReads,numWrites);
+  fullStepDiagnostics();
 }
 
-void applyFloor(grid* prim, fluidElement* elem, geometry* geom, int &numReads,int &numWrites)
+void applyFloor(grid* prim, fluidElement* elem, geometry* geom)
 {
   array xCoords[3];
   geom->getxCoords(xCoords);
@@ -495,7 +495,7 @@ void applyFloor(grid* prim, fluidElement* elem, geometry* geom, int &numReads,in
   usefloor = af::max(condition,usefloor);
   prim->vars[vars::U] = condition*minU+(1.-condition)*prim->vars[vars::U];
 
-  elem->set(*prim,*geom,numReads,numWrites);
+  elem->set(*prim,*geom);
   const array& bSqr = elem->bSqr;
   condition = bSqr>params::BsqrOverRhoMax*prim->vars[vars::RHO];
   usefloor = af::max(condition,usefloor);
@@ -596,7 +596,7 @@ void applyFloor(grid* prim, fluidElement* elem, geometry* geom, int &numReads,in
   
 
   // Reset element to get Lorentz factor
-  elem->set(*prim, *geom, numReads,numWrites);
+  elem->set(*prim, *geom);
   const array& lorentzFactor = elem->gammaLorentzFactor;
   array lorentzFactorSqr = lorentzFactor*lorentzFactor;
 
@@ -616,7 +616,7 @@ void applyFloor(grid* prim, fluidElement* elem, geometry* geom, int &numReads,in
       prim->vars[vars::U3].eval();
     }  
 
-  elem->set(*prim, *geom, numReads,numWrites);
+  elem->set(*prim, *geom);
   
   if(params::conduction)
     {
@@ -640,17 +640,17 @@ void applyFloor(grid* prim, fluidElement* elem, geometry* geom, int &numReads,in
   (condition/af::max(deltaP/dPmaxPlus,1.)+(1.-condition)/af::max(deltaP/dPmaxMinus,1.));
       prim->vars[vars::DP].eval();
     }
-  if(params::conduction || params::viscosity) elem->set(*prim, *geom, numReads,numWrites);
+  if(params::conduction || params::viscosity) elem->set(*prim, *geom);
 }
 
-void timeStepper::halfStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::halfStepDiagnostics()
 {
-  applyFloor(primHalfStep,elemHalfStep,geomCenter,numReads,numWrites);
+  applyFloor(primHalfStep,elemHalfStep,geomCenter);
 }
 
-void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
+void timeStepper::fullStepDiagnostics()
 {
-  applyFloor(primOld,elemOld,geomCenter,numReads,numWrites);
+  applyFloor(primOld,elemOld,geomCenter);
 
   int world_rank;
   MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
@@ -678,6 +678,24 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
 	volElem*=XCoords->dX3;
       ComputeEnergyIntegrals(elemOld,primOld,geomCenter,volElem);
       ComputeBoundaryFluxes(elemOld,primOld,geomCenter,volElem);
+
+      // Zones where the ideal solver failed in the last step (fixed up from
+      // their converged neighbours)
+      double numFailures = af::count<double>(idealSolverFailures(domainX1, domainX2, domainX3));
+      if (world_rank == 0) 
+	{
+	  double temp; 
+	  for(int i=1;i<world_size;i++)
+	    {
+	      MPI_Recv(&temp, 1, MPI_DOUBLE, i, i, PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
+	      numFailures += temp;
+	    }
+	}
+      else
+	{
+	  MPI_Send(&numFailures, 1, MPI_DOUBLE, 0, world_rank, PETSC_COMM_WORLD);
+	}
+      PetscPrintf(PETSC_COMM_WORLD,"Ideal solver failures = %g\n",numFailures);
     }
   if(WriteData)
     {
@@ -686,10 +704,11 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
       {
         PetscPrintf(PETSC_COMM_WORLD, "\n");
         PetscPrintf(PETSC_COMM_WORLD, "  Printing metric at zone CENTER...");
-        geomCenter->gCovGrid->dump("gCov","gCov.h5");
-        geomCenter->gConGrid->dump("gCon","gCon.h5");
-        geomCenter->gGrid->dump("sqrtDetg","sqrtDetg.h5");
-        geomCenter->xCoordsGrid->dump("xCoords","xCoords.h5");
+        geomCenter->getgCovGrid()->dump("gCov","gCov.h5");
+        geomCenter->getgConGrid()->dump("gCon","gCon.h5");
+        geomCenter->getgGrid()->dump("sqrtDetg","sqrtDetg.h5");
+        geomCenter->getxCoordsGrid()->dump("xCoords","xCoords.h5");
+        geomCenter->releaseGrids();
         PetscPrintf(PETSC_COMM_WORLD, "done\n\n");
       }
       std::string filename = "primVarsT";
@@ -722,41 +741,18 @@ void timeStepper::fullStepDiagnostics(int &numReads,int &numWrites)
       {
         varNames[vars::DP]  = "dP";
       }
-      primOld->dumpVTS(*geomCenter->xCoordsGrid, varNames, filenameVTS);
+      primOld->dumpVTS(*geomCenter->getxCoordsGrid(), varNames, filenameVTS);
+      geomCenter->releaseGrids();
     }
 }
 
 int timeStepper::CheckWallClockTermination()
 {
-  TimeStamp tStep;
-  double ElapsedTime = tStep-TimeWhenExecutableStarted();
-  int StopRunning = (ElapsedTime>=params::MaxWallTime ? 1 : 0);
-  // Need communication to make sure that all processes agree on the measured time!
-  MPI_Bcast(&StopRunning,1,MPI_INT,0,PETSC_COMM_WORLD);
-  if(StopRunning)
-    {
-      long long int WriteIdx = floor(time*100);
-      std::string filename = "restartVarsT";
-      std::string s_idx = std::to_string(WriteIdx);
-      for(int i=0;i<8-s_idx.size();i++)
-	{
-	  filename=filename+"0";
-	}
-      filename=filename+s_idx;
-      filename=filename+".h5";
-      primOld->dump("primitives",filename);
-      std::ofstream fName(params::restartFileName.c_str());
-      fName<<filename<<std::endl;
-      fName.close();
-      std::ofstream fTime(params::restartFileTime.c_str());
-      fTime<<time<<std::endl;
-      fTime.close();
-    }
-  return StopRunning;
+  return checkpointIfDue();
 }
 
 void dampedOutflowBC(grid& primBC, 
-         const geometry& geom, int &numReads,int &numWrites)
+         const geometry& geom)
 {
   const int numGhost = params::numGhost;
   if(primBC.iLocalStart == 0)
@@ -788,7 +784,7 @@ void dampedOutflowBC(grid& primBC,
 }
 
 void inflowCheck(grid& primBC,fluidElement& elemBC,
-     geometry& geom, int &numReads,int &numWrites)
+     geometry& geom)
 {
   const int numGhost = params::numGhost;
   if(primBC.iLocalEnd == primBC.N1)
@@ -796,7 +792,7 @@ void inflowCheck(grid& primBC,fluidElement& elemBC,
       af::seq domainX1RightBoundary(primBC.N1Local+numGhost,
             primBC.N1Local+2*numGhost-1
             );
-      elemBC.set(primBC,geom,numReads,numWrites);
+      elemBC.set(primBC,geom);
       
       // Prefactor the lorentz factor
       primBC.vars[vars::U1](domainX1RightBoundary,span,span)
@@ -841,14 +837,14 @@ void inflowCheck(grid& primBC,fluidElement& elemBC,
       *newLorentzFactor;
     primBC.vars[vars::U1+i].eval();
   }
-      elemBC.set(primBC,geom,numReads,numWrites);
+      elemBC.set(primBC,geom);
     }
   if(primBC.iLocalStart == 0)
     {
       af::seq domainX1LeftBoundary(0,
                                     numGhost-1
                                     );
-      elemBC.set(primBC,geom,numReads,numWrites);
+      elemBC.set(primBC,geom);
 
       // Prefactor the lorentz factor
       primBC.vars[vars::U1](domainX1LeftBoundary,span,span)
@@ -888,11 +884,11 @@ void inflowCheck(grid& primBC,fluidElement& elemBC,
       *newLorentzFactor;
     primBC.vars[vars::U1+i].eval();
   }
-      elemBC.set(primBC,geom,numReads,numWrites);
+      elemBC.set(primBC,geom);
     }
 }
 
-void fixPoles(grid& primBC, const geometry& geom, int &numReads,int &numWrites)
+void fixPoles(grid& primBC, const geometry& geom)
 {
   const int numGhost = params::numGhost;
   if(primBC.jLocalStart == 0)
@@ -1063,7 +1059,7 @@ void fixPoles(grid& primBC, const geometry& geom, int &numReads,int &numWrites)
     }
 }
 
-void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
+void timeStepper::setProblemSpecificBCs()
 {
   // 1) Choose which primitive variables are corrected.
   grid* primBC;
@@ -1078,18 +1074,16 @@ void timeStepper::setProblemSpecificBCs(int &numReads,int &numWrites)
       primBC = primHalfStep;
       elemBC = elemHalfStep;
     }
-  //dampedOutflowBC(*primBC,*geomCenter,
-  //      numReads,numWrites);
+  //dampedOutflowBC(*primBC,*geomCenter);
   // 2) Check that there is no inflow at the radial boundaries
-  inflowCheck(*primBC,*elemBC,*geomCenter,
-          numReads,numWrites);
+  inflowCheck(*primBC,*elemBC,*geomCenter);
 
   // 3) 'Fix' the polar regions by correcting the first
   // two active zones
-  fixPoles(*primBC,*geomCenter,numReads,numWrites);
+  fixPoles(*primBC,*geomCenter);
 };
 
-void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
+void timeStepper::applyProblemSpecificFluxFilter()
 {
   const int numGhost = params::numGhost;
   // Prevents matter from flowing into the computational domain
@@ -1132,3 +1126,9 @@ void timeStepper::applyProblemSpecificFluxFilter(int &numReads,int &numWrites)
       fluxesX1->vars[vars::B2].eval();
     }
 }
+
+/* The inflow clamp and the polar axis act on the fluid fluxes */
+bool timeStepper::fluxFilterChangesFluid()
+{
+  return true;
+}
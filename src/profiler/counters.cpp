@@ -0,0 +1,187 @@
+#include "counters.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace profiler
+{
+  namespace counters
+  {
+    const char *names[NUM_COUNTERS] =
+      {"cycles", "instructions", "LLC misses", "backend stall cycles",
+       "FP scalar", "FP 128-bit", "FP 256-bit", "FP 512-bit"
+      };
+    bool available[NUM_COUNTERS];
+
+    /* File descriptors, [task*NUM_COUNTERS + counter], -1 if not open */
+    static std::vector<int> fds;
+    static int numTasks = 0;
+  };
+};
+
+void profiler::counters::open()
+{
+  close();
+
+#ifdef __linux__
+  /* The double precision FP_ARITH_INST_RETIRED umasks of event 0xc7 are
+   * Intel specific (Broadwell and later); elsewhere the same raw codes mean
+   * something else, so they are not tried */
+  bool intel = false;
+  std::ifstream cpuInfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuInfo, line))
+  {
+    if (line.find("GenuineIntel") != std::string::npos)
+    {
+      intel = true;
+      break;
+    }
+  }
+
+  const unsigned int types[NUM_COUNTERS] =
+    {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+     PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+     PERF_TYPE_RAW, PERF_TYPE_RAW, PERF_TYPE_RAW, PERF_TYPE_RAW
+    };
+  const unsigned long long configs[NUM_COUNTERS] =
+    {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+     PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_STALLED_CYCLES_BACKEND,
+     0x01c7, 0x04c7, 0x10c7, 0x40c7
+    };
+
+  /* Every thread of the process, not only the OpenMP ones: the ArrayFire
+   * CPU backend runs its kernels on threads of its own, and MPI may have
+   * progress threads. perf_event_open() with a thread id as pid counts that
+   * thread only; inherit adds the threads it creates after this point. */
+  std::vector<int> tasks;
+  DIR *taskDir = opendir("/proc/self/task");
+  if (taskDir != NULL)
+  {
+    struct dirent *entry;
+    while ((entry = readdir(taskDir)) != NULL)
+    {
+      if (entry->d_name[0] != '.')
+      {
+        tasks.push_back(atoi(entry->d_name));
+      }
+    }
+    closedir(taskDir);
+  }
+  numTasks = tasks.size();
+  fds.assign(numTasks*NUM_COUNTERS, -1);
+
+  /* Threads that exited since the listing are skipped */
+  std::vector<bool> exited(numTasks, false);
+  for (int task=0; task < numTasks; task++)
+  {
+    for (int counter=0; counter < NUM_COUNTERS; counter++)
+    {
+      if (types[counter] == PERF_TYPE_RAW && !intel)
+      {
+        continue;
+      }
+
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size           = sizeof(attr);
+      attr.type           = types[counter];
+      attr.config         = configs[counter];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.inherit        = 1;
+      attr.read_format    =   PERF_FORMAT_TOTAL_TIME_ENABLED
+                            | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      fds[task*NUM_COUNTERS + counter] =
+        syscall(__NR_perf_event_open, &attr, tasks[task], -1, -1, 0);
+      if (fds[task*NUM_COUNTERS + counter] < 0 && errno == ESRCH)
+      {
+        exited[task] = true;
+      }
+    }
+  }
+#else
+  std::vector<bool> exited;
+#endif
+
+  for (int counter=0; counter < NUM_COUNTERS; counter++)
+  {
+    available[counter] = (numTasks > 0);
+    for (int task=0; task < numTasks; task++)
+    {
+      if (fds[task*NUM_COUNTERS + counter] < 0 && !exited[task])
+      {
+        available[counter] = false;
+      }
+    }
+    if (!available[counter])
+    {
+      disable(counter);
+    }
+  }
+}
+
+void profiler::counters::disable(const int counter)
+{
+  available[counter] = false;
+  for (int task=0; task < numTasks; task++)
+  {
+    int &fd = fds[task*NUM_COUNTERS + counter];
+    if (fd >= 0)
+    {
+#ifdef __linux__
+      ::close(fd);
+#endif
+      fd = -1;
+    }
+  }
+}
+
+/* Counts since open(), summed over the threads of the process. Counters
+ * multiplexed with others are scaled up to the time they were enabled. */
+void profiler::counters::read(double values[NUM_COUNTERS])
+{
+  for (int counter=0; counter < NUM_COUNTERS; counter++)
+  {
+    values[counter] = 0.;
+    if (!available[counter])
+    {
+      continue;
+    }
+
+#ifdef __linux__
+    for (int task=0; task < numTasks; task++)
+    {
+      const int fd = fds[task*NUM_COUNTERS + counter];
+      /* value, time enabled, time running (of the thread and the threads it
+       * created) */
+      unsigned long long buffer[3];
+      if (   fd >= 0 && ::read(fd, buffer, sizeof(buffer)) == sizeof(buffer)
+          && buffer[2] > 0
+         )
+      {
+        values[counter] += (double)buffer[0]*buffer[1]/buffer[2];
+      }
+    }
+#endif
+  }
+}
+
+void profiler::counters::close()
+{
+  for (int counter=0; counter < NUM_COUNTERS; counter++)
+  {
+    disable(counter);
+  }
+  fds.clear();
+  numTasks = 0;
+}
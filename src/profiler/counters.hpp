@@ -0,0 +1,31 @@
+#ifndef GRIM_PROFILER_COUNTERS_H_
+#define GRIM_PROFILER_COUNTERS_H_
+
+#include <string>
+
+/* Hardware counters through Linux perf_event_open(). open() attaches a set
+ * to every thread of the process, OpenMP, ArrayFire and MPI threads alike,
+ * inherited by the threads they create later; read() sums them. Counters
+ * that cannot be opened (no Linux, no such event on this CPU,
+ * perf_event_paranoid too strict) are marked unavailable and read as 0. */
+namespace profiler
+{
+  namespace counters
+  {
+    enum
+    {
+      CYCLES, INSTRUCTIONS, LLC_MISSES, BACKEND_STALLS,
+      FP_SCALAR, FP_128, FP_256, FP_512, NUM_COUNTERS
+    };
+
+    extern const char *names[NUM_COUNTERS];
+    extern bool available[NUM_COUNTERS];
+
+    void open();
+    void disable(const int counter);
+    void read(double values[NUM_COUNTERS]);
+    void close();
+  };
+};
+
+#endif /* GRIM_PROFILER_COUNTERS_H_ */
@@ -0,0 +1,642 @@
+#include "profiler.hpp"
+#include "counters.hpp"
+#include <petsc.h>
+#include <arrayfire.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace profiler
+{
+  bool enabled = false;
+
+  struct region
+  {
+    const char *name;
+    std::string path;
+    std::vector<int> children;
+    double start, time, bytes;
+    int calls;
+    double startCounts[counters::NUM_COUNTERS];
+    double counts[counters::NUM_COUNTERS];
+  };
+
+  /* Regions in order of creation; a parent always comes before its
+   * children. openRegions is the current nesting. */
+  static std::vector<region> regions;
+  static std::vector<int> rootRegions;
+  static std::vector<int> openRegions;
+
+  static bool aggregate = false;
+  static bool counting = false;
+  static int everyNSteps, syncRegions, format;
+  static int stepsSinceWrite;
+  static std::string fileName;
+  static double peakBandwidth = 0.;
+
+  /* Timeline of steps [traceStartStep, traceEndStep), as begin/end events
+   * on a monotonic clock whose zero is a barrier at the first traced step */
+  struct traceEvent
+  {
+    const char *name;
+    char phase;
+    double time;
+  };
+
+  static bool tracing = false;
+  static int traceStartStep = 0, traceEndStep = 0;
+  static std::string traceFileName;
+  static std::vector<traceEvent> traceEvents;
+  static std::chrono::steady_clock::time_point traceZero;
+
+  static inline void addTraceEvent(const char *name, const char phase)
+  {
+    traceEvent event;
+    event.name  = name;
+    event.phase = phase;
+    event.time  = std::chrono::duration<double, std::micro>
+                    (std::chrono::steady_clock::now() - traceZero).count();
+    traceEvents.push_back(event);
+  }
+};
+
+void profiler::setup(const int everyNSteps,
+                     const int syncRegions,
+                     const int hardwareCounters,
+                     const int format,
+                     const std::string fileName
+                    )
+{
+  profiler::everyNSteps = everyNSteps;
+  profiler::syncRegions = syncRegions;
+  profiler::format      = format;
+  profiler::fileName    = fileName;
+  stepsSinceWrite = 0;
+  aggregate = (everyNSteps > 0);
+  enabled   = aggregate || (traceEndStep > traceStartStep);
+
+  int world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+
+  counting = aggregate && hardwareCounters;
+  if (counting)
+  {
+    /* Keep only the counters that every rank has, so that the sums over
+     * ranks in write() are complete */
+    counters::open();
+    int localAvailable[counters::NUM_COUNTERS];
+    int allAvailable[counters::NUM_COUNTERS];
+    for (int counter=0; counter < counters::NUM_COUNTERS; counter++)
+    {
+      localAvailable[counter] = counters::available[counter];
+    }
+    MPI_Allreduce(localAvailable, allAvailable, counters::NUM_COUNTERS,
+                  MPI_INT, MPI_MIN, PETSC_COMM_WORLD
+                 );
+
+    std::string unavailable;
+    for (int counter=0; counter < counters::NUM_COUNTERS; counter++)
+    {
+      if (!allAvailable[counter])
+      {
+        counters::disable(counter);
+        unavailable += std::string(unavailable.empty() ? "" : ", ")
+                       + counters::names[counter];
+      }
+    }
+    if (!unavailable.empty())
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "Profiler: hardware counters unavailable: %s\n",
+                  unavailable.c_str()
+                 );
+    }
+    if (!counters::available[counters::CYCLES])
+    {
+      counters::close();
+      counting = false;
+    }
+  }
+
+  if (aggregate && world_rank == 0)
+  {
+    std::ofstream file(fileName.c_str());
+    if (format == profileFormats::CSV)
+    {
+      file << "step,steps,region,depth,calls,min,avg,max,imbalance,"
+           << "bytes,bandwidth,roofline";
+      if (counting)
+      {
+        file << ",cycles,instructions,ipc,llcMissesPerKiloInstruction,"
+             << "backendStallFraction,flops,vectorFraction,intensity";
+      }
+      file << "\n";
+    }
+  }
+}
+
+/* Trace steps startStep to startStep+numSteps-1 (numSteps = 0: off) */
+void profiler::setupTrace(const int startStep,
+                          const int numSteps,
+                          const std::string fileName
+                         )
+{
+  traceStartStep = startStep;
+  traceEndStep   = startStep + std::max(numSteps, 0);
+  traceFileName  = fileName;
+  traceEvents.reserve(1 << 16);
+  enabled = aggregate || (traceEndStep > traceStartStep);
+}
+
+/* Memory bandwidth in GB/sec that the regions are measured against */
+void profiler::setPeakBandwidth(const double gigabytesPerSec)
+{
+  peakBandwidth = gigabytesPerSec;
+}
+
+void profiler::begin(const char *name)
+{
+  if (syncRegions)
+  {
+    af::sync();
+  }
+  if (tracing)
+  {
+    addTraceEvent(name, 'B');
+  }
+  if (!aggregate)
+  {
+    return;
+  }
+
+  std::vector<int> &siblings =
+    openRegions.empty() ? rootRegions : regions[openRegions.back()].children;
+
+  int index = -1;
+  for (int n=0; n < siblings.size(); n++)
+  {
+    const char *siblingName = regions[siblings[n]].name;
+    if (siblingName == name || strcmp(siblingName, name) == 0)
+    {
+      index = siblings[n];
+      break;
+    }
+  }
+
+  if (index < 0)
+  {
+    region newRegion;
+    newRegion.name  = name;
+    newRegion.path  =   openRegions.empty()
+                      ? std::string(name)
+                      : regions[openRegions.back()].path + "/" + name;
+    newRegion.time  = 0.;
+    newRegion.bytes = 0.;
+    newRegion.calls = 0;
+    std::fill(newRegion.counts, newRegion.counts + counters::NUM_COUNTERS, 0.);
+
+    index = regions.size();
+    /* siblings may be invalidated by the push_back */
+    if (openRegions.empty())
+    {
+      rootRegions.push_back(index);
+    }
+    else
+    {
+      regions[openRegions.back()].children.push_back(index);
+    }
+    regions.push_back(newRegion);
+  }
+
+  openRegions.push_back(index);
+  if (counting)
+  {
+    counters::read(regions[index].startCounts);
+  }
+  regions[index].start = MPI_Wtime();
+}
+
+void profiler::end()
+{
+  if (syncRegions)
+  {
+    af::sync();
+  }
+  if (tracing)
+  {
+    addTraceEvent(NULL, 'E');
+  }
+  if (!aggregate || openRegions.empty())
+  {
+    return;
+  }
+
+  region &current = regions[openRegions.back()];
+  current.time  += MPI_Wtime() - current.start;
+  current.calls += 1;
+  if (counting)
+  {
+    double counts[counters::NUM_COUNTERS];
+    counters::read(counts);
+    for (int counter=0; counter < counters::NUM_COUNTERS; counter++)
+    {
+      current.counts[counter] += counts[counter] - current.startCounts[counter];
+    }
+  }
+  openRegions.pop_back();
+}
+
+/* Bytes read and written, charged to every open region */
+void profiler::addBytes(const double bytes)
+{
+  if (!aggregate)
+  {
+    return;
+  }
+
+  for (int n=0; n < openRegions.size(); n++)
+  {
+    regions[openRegions[n]].bytes += bytes;
+  }
+}
+
+double profiler::arrayBytes(const std::vector<af::array *> &arrays)
+{
+  double bytes = 0.;
+  for (int n=0; n < arrays.size(); n++)
+  {
+    bytes += arrays[n]->bytes();
+  }
+
+  return bytes;
+}
+
+double profiler::arrayBytes(const int numArrays, const af::array arrays[])
+{
+  double bytes = 0.;
+  for (int n=0; n < numArrays; n++)
+  {
+    bytes += arrays[n].bytes();
+  }
+
+  return bytes;
+}
+
+/* Call at the start and end of every time step, on all ranks */
+void profiler::beginStep(const int step)
+{
+  if (step == traceStartStep && traceEndStep > traceStartStep)
+  {
+    /* Common time origin for all ranks, up to the barrier exit skew */
+    MPI_Barrier(PETSC_COMM_WORLD);
+    traceZero = std::chrono::steady_clock::now();
+    traceEvents.clear();
+    tracing = true;
+  }
+}
+
+void profiler::endStep(const int step)
+{
+  if (tracing && step + 1 >= traceEndStep)
+  {
+    writeTrace();
+  }
+  if (!aggregate)
+  {
+    return;
+  }
+
+  stepsSinceWrite++;
+  if (stepsSinceWrite >= everyNSteps)
+  {
+    write(step);
+  }
+}
+
+/* Reduce the region times of the last stepsSinceWrite steps over all ranks
+ * and append them to the profile on rank 0: min, avg and max over the ranks
+ * of the time per step, and the calls in the interval. Regions with traffic
+ * also get the avg bytes per step, the bandwidth per rank in GB/sec and its
+ * fraction of the peak (avg over ranks). With hardware counters, the
+ * counts summed over all threads and ranks per step, the instructions per
+ * cycle, LLC misses per 1000 instructions, the fraction of cycles stalled in
+ * the backend (mostly waiting on memory), the double precision flops, the
+ * fraction of them in SIMD instructions and the arithmetic intensity in
+ * flops per byte of the accounted traffic. Collective. */
+void profiler::write(const int step)
+{
+  int world_rank, world_size;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+  MPI_Comm_size(PETSC_COMM_WORLD, &world_size);
+
+  /* Ranks may have opened different regions (e.g. only some touch the
+   * poles): collect the union of all paths, in order of first appearance */
+  std::string localPaths;
+  for (int n=0; n < regions.size(); n++)
+  {
+    localPaths += regions[n].path + "\n";
+  }
+  int localLength = localPaths.size();
+  std::vector<int> lengths(world_size), offsets(world_size, 0);
+  MPI_Allgather(&localLength, 1, MPI_INT,
+                &lengths[0],  1, MPI_INT, PETSC_COMM_WORLD
+               );
+  for (int rank=1; rank < world_size; rank++)
+  {
+    offsets[rank] = offsets[rank-1] + lengths[rank-1];
+  }
+  std::vector<char> allPaths(offsets[world_size-1] + lengths[world_size-1] + 1);
+  MPI_Allgatherv(&localPaths[0], localLength, MPI_CHAR,
+                 &allPaths[0], &lengths[0], &offsets[0], MPI_CHAR,
+                 PETSC_COMM_WORLD
+                );
+
+  std::vector<std::string> paths;
+  std::map<std::string, int> pathIndex;
+  std::string path;
+  for (int n=0; n < allPaths.size()-1; n++)
+  {
+    if (allPaths[n] != '\n')
+    {
+      path += allPaths[n];
+      continue;
+    }
+    if (pathIndex.find(path) == pathIndex.end())
+    {
+      pathIndex[path] = paths.size();
+      paths.push_back(path);
+    }
+    path.clear();
+  }
+
+  const int numRegions = paths.size();
+  std::vector<double> localTime(numRegions, 0.), localCalls(numRegions, 0.);
+  std::vector<double> localBytes(numRegions, 0.);
+  std::vector<double> localCounts(numRegions*counters::NUM_COUNTERS, 0.);
+  for (int n=0; n < regions.size(); n++)
+  {
+    const int index = pathIndex[regions[n].path];
+    localTime[index]  = regions[n].time;
+    localCalls[index] = regions[n].calls;
+    localBytes[index] = regions[n].bytes;
+    std::copy(regions[n].counts, regions[n].counts + counters::NUM_COUNTERS,
+              &localCounts[index*counters::NUM_COUNTERS]
+             );
+  }
+
+  std::vector<double> minTime(numRegions), maxTime(numRegions);
+  std::vector<double> sumTime(numRegions), maxCalls(numRegions);
+  std::vector<double> sumBytes(numRegions);
+  std::vector<double> sumCounts(numRegions*counters::NUM_COUNTERS);
+  double sumPeakBandwidth = 0.;
+  if (numRegions > 0)
+  {
+    MPI_Reduce(&localTime[0], &minTime[0], numRegions, MPI_DOUBLE, MPI_MIN,
+               0, PETSC_COMM_WORLD
+              );
+    MPI_Reduce(&localTime[0], &maxTime[0], numRegions, MPI_DOUBLE, MPI_MAX,
+               0, PETSC_COMM_WORLD
+              );
+    MPI_Reduce(&localTime[0], &sumTime[0], numRegions, MPI_DOUBLE, MPI_SUM,
+               0, PETSC_COMM_WORLD
+              );
+    MPI_Reduce(&localCalls[0], &maxCalls[0], numRegions, MPI_DOUBLE, MPI_MAX,
+               0, PETSC_COMM_WORLD
+              );
+    MPI_Reduce(&localBytes[0], &sumBytes[0], numRegions, MPI_DOUBLE, MPI_SUM,
+               0, PETSC_COMM_WORLD
+              );
+    if (counting)
+    {
+      MPI_Reduce(&localCounts[0], &sumCounts[0],
+                 numRegions*counters::NUM_COUNTERS, MPI_DOUBLE, MPI_SUM,
+                 0, PETSC_COMM_WORLD
+                );
+    }
+  }
+  MPI_Reduce(&peakBandwidth, &sumPeakBandwidth, 1, MPI_DOUBLE, MPI_SUM,
+             0, PETSC_COMM_WORLD
+            );
+
+  /* Times are per step */
+  const int numSteps = stepsSinceWrite;
+  if (world_rank == 0 && numSteps > 0)
+  {
+    std::ofstream file(fileName.c_str(), std::ios::app);
+    file.precision(6);
+    file << std::scientific;
+
+    if (format == profileFormats::JSON)
+    {
+      /* One JSON object per line */
+      file << "{\"step\": " << step << ", \"steps\": " << numSteps
+           << ", \"ranks\": " << world_size << ", \"regions\": [";
+    }
+    for (int n=0; n < numRegions; n++)
+    {
+      int depth = std::count(paths[n].begin(), paths[n].end(), '/');
+      double avgTime   = sumTime[n]/world_size;
+      double imbalance = (avgTime > 0. ? maxTime[n]/avgTime : 1.);
+      double avgBytes  = sumBytes[n]/world_size;
+      double bandwidth = (sumTime[n] > 0. ? sumBytes[n]/sumTime[n]/1e9 : 0.);
+      double roofline  =   sumPeakBandwidth > 0.
+                         ? bandwidth/(sumPeakBandwidth/world_size) : 0.;
+
+      const double *counts = &sumCounts[n*counters::NUM_COUNTERS];
+      const bool *available = counters::available;
+      double cycles       = counts[counters::CYCLES];
+      double instructions = counts[counters::INSTRUCTIONS];
+      double vectorOps    =   counts[counters::FP_128]
+                            + counts[counters::FP_256]
+                            + counts[counters::FP_512];
+      double flops        =   counts[counters::FP_SCALAR]
+                            + 2.*counts[counters::FP_128]
+                            + 4.*counts[counters::FP_256]
+                            + 8.*counts[counters::FP_512];
+      bool hasInstructions = counting && available[counters::INSTRUCTIONS]
+                             && instructions > 0.;
+      bool hasStalls   = counting && available[counters::BACKEND_STALLS]
+                         && cycles > 0.;
+      bool hasFlops    = counting && available[counters::FP_SCALAR]
+                         && available[counters::FP_128]
+                         && available[counters::FP_256]
+                         && available[counters::FP_512];
+      bool hasVector   =    hasFlops
+                         && counts[counters::FP_SCALAR] + vectorOps > 0.;
+      bool hasIntensity = hasFlops && sumBytes[n] > 0.;
+
+      if (format == profileFormats::CSV)
+      {
+        file << step << "," << numSteps << "," << paths[n] << ","
+             << depth << "," << (long)maxCalls[n] << ","
+             << minTime[n]/numSteps << "," << avgTime/numSteps << ","
+             << maxTime[n]/numSteps << "," << imbalance << ",";
+        if (avgBytes > 0.)
+        {
+          file << avgBytes/numSteps << "," << bandwidth << "," << roofline;
+        }
+        else
+        {
+          file << ",,";
+        }
+        if (counting)
+        {
+          file << "," << cycles/numSteps << ",";
+          if (hasInstructions)
+          {
+            file << instructions/numSteps << ","
+                 << (cycles > 0. ? instructions/cycles : 0.) << ",";
+            if (available[counters::LLC_MISSES])
+            {
+              file << 1000.*counts[counters::LLC_MISSES]/instructions;
+            }
+          }
+          else
+          {
+            file << ",,";
+          }
+          file << ",";
+          if (hasStalls)
+          {
+            file << counts[counters::BACKEND_STALLS]/cycles;
+          }
+          file << ",";
+          if (hasFlops)
+          {
+            file << flops/numSteps;
+          }
+          file << ",";
+          if (hasVector)
+          {
+            file << vectorOps/(counts[counters::FP_SCALAR] + vectorOps);
+          }
+          file << ",";
+          if (hasIntensity)
+          {
+            file << flops/sumBytes[n];
+          }
+        }
+        file << "\n";
+      }
+      else
+      {
+        file << (n > 0 ? ", " : "")
+             << "{\"region\": \"" << paths[n] << "\""
+             << ", \"depth\": " << depth
+             << ", \"calls\": " << (long)maxCalls[n]
+             << ", \"min\": " << minTime[n]/numSteps
+             << ", \"avg\": " << avgTime/numSteps
+             << ", \"max\": " << maxTime[n]/numSteps
+             << ", \"imbalance\": " << imbalance;
+        if (avgBytes > 0.)
+        {
+          file << ", \"bytes\": " << avgBytes/numSteps
+               << ", \"bandwidth\": " << bandwidth
+               << ", \"roofline\": " << roofline;
+        }
+        if (counting)
+        {
+          file << ", \"cycles\": " << cycles/numSteps;
+        }
+        if (hasInstructions)
+        {
+          file << ", \"instructions\": " << instructions/numSteps
+               << ", \"ipc\": " << (cycles > 0. ? instructions/cycles : 0.);
+          if (available[counters::LLC_MISSES])
+          {
+            file << ", \"llcMissesPerKiloInstruction\": "
+                 << 1000.*counts[counters::LLC_MISSES]/instructions;
+          }
+        }
+        if (hasStalls)
+        {
+          file << ", \"backendStallFraction\": "
+               << counts[counters::BACKEND_STALLS]/cycles;
+        }
+        if (hasFlops)
+        {
+          file << ", \"flops\": " << flops/numSteps;
+        }
+        if (hasVector)
+        {
+          file << ", \"vectorFraction\": "
+               << vectorOps/(counts[counters::FP_SCALAR] + vectorOps);
+        }
+        if (hasIntensity)
+        {
+          file << ", \"intensity\": " << flops/sumBytes[n];
+        }
+        file << "}";
+      }
+    }
+    if (format == profileFormats::JSON)
+    {
+      file << "]}\n";
+    }
+  }
+
+  for (int n=0; n < regions.size(); n++)
+  {
+    regions[n].time  = 0.;
+    regions[n].bytes = 0.;
+    regions[n].calls = 0;
+    std::fill(regions[n].counts, regions[n].counts + counters::NUM_COUNTERS,
+              0.
+             );
+  }
+  stepsSinceWrite = 0;
+}
+
+/* Write this rank's timeline to <traceFile>.<rank>.json in the Chrome trace
+ * event format (chrome://tracing, ui.perfetto.dev), with the rank as the
+ * process id. The files of all ranks share a time origin and merge by
+ * concatenating their traceEvents, e.g.
+ *   jq -s '{traceEvents: map(.traceEvents) | add}' trace.*.json */
+void profiler::writeTrace()
+{
+  tracing = false;
+
+  int world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+
+  std::string rankFileName = traceFileName + "." + std::to_string(world_rank)
+                             + ".json";
+  std::ofstream file(rankFileName.c_str());
+  file.precision(3);
+  file << std::fixed;
+
+  file << "{\"traceEvents\": [\n";
+  file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << world_rank
+       << ", \"tid\": 0, \"args\": {\"name\": \"rank " << world_rank << "\"}}";
+  for (int n=0; n < traceEvents.size(); n++)
+  {
+    const traceEvent &event = traceEvents[n];
+    file << ",\n{";
+    if (event.phase == 'B')
+    {
+      file << "\"name\": \"" << event.name << "\", ";
+    }
+    file << "\"ph\": \"" << event.phase << "\", \"ts\": " << event.time
+         << ", \"pid\": " << world_rank << ", \"tid\": 0}";
+  }
+  file << "\n]}\n";
+
+  traceEvents.clear();
+}
+
+/* Flush a timeline cut short by the end of the run */
+void profiler::finish()
+{
+  if (tracing)
+  {
+    writeTrace();
+  }
+  if (counting)
+  {
+    counters::close();
+    counting = false;
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef GRIM_PROFILER_H_
+#define GRIM_PROFILER_H_
+
+#include "../params.hpp"
+#include <arrayfire.h>
+#include <vector>
+
+/* Nested timing regions. PROFILE_SCOPE("name") times the rest of the
+ * enclosing block; PROFILE_BEGIN("name") ... PROFILE_END() time straight-line
+ * code. Regions nest in call order, so "riemann" opened inside "fluxes"
+ * inside "half step" is reported as "step/half step/fluxes/riemann". Only
+ * open regions outside of OpenMP parallel regions.
+ *
+ * PROFILE_BYTES(bytes) charges memory traffic to the open regions, which are
+ * then reported as achieved bandwidth against the peak of
+ * timeStepper::bandwidthTest(). The traffic is accounted explicitly where it
+ * is known: the native kernels count every array they lock (see
+ * native::hostArrays), the ArrayFire path counts the arrays materialized at
+ * its af::eval() sites and the grids those expressions read. Geometry and
+ * intermediates fused into a JIT kernel are not seen, so the ArrayFire
+ * figures are lower bounds.
+ *
+ * With hardware counters on, every region also reads the perf_event
+ * counters of all OpenMP threads (see counters.hpp) at its begin and end, and
+ * the profile reports IPC, cache misses, flops and arithmetic intensity next
+ * to its time. Counters the machine does not grant are left out.
+ *
+ * The same regions feed two outputs: aggregate times over ranks every N
+ * steps (setup()), and a per-rank timeline of a few steps (setupTrace()).
+ *
+ * Without GRIM_PROFILER (PROFILER OFF in CMakeLists.txt) the macros are
+ * empty. With it, and both outputs off, a region costs one branch. */
+namespace profiler
+{
+  extern bool enabled;
+
+  void setup(const int everyNSteps,
+             const int syncRegions,
+             const int hardwareCounters,
+             const int format,
+             const std::string fileName
+            );
+  void setupTrace(const int startStep,
+                  const int numSteps,
+                  const std::string fileName
+                 );
+  void setPeakBandwidth(const double gigabytesPerSec);
+  void begin(const char *name);
+  void end();
+  void addBytes(const double bytes);
+  double arrayBytes(const std::vector<af::array *> &arrays);
+  double arrayBytes(const int numArrays, const af::array arrays[]);
+  void beginStep(const int step);
+  void endStep(const int step);
+  void write(const int step);
+  void writeTrace();
+  void finish();
+
+  class scope
+  {
+    bool active;
+
+    public:
+      scope(const char *name) : active(enabled)
+      {
+        if (active) begin(name);
+      }
+      ~scope()
+      {
+        if (active) end();
+      }
+  };
+};
+
+#ifdef GRIM_PROFILER
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+  profiler::scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_BEGIN(name) \
+  do { if (profiler::enabled) profiler::begin(name); } while (0)
+#define PROFILE_END() \
+  do { if (profiler::enabled) profiler::end(); } while (0)
+#define PROFILE_BYTES(bytes) \
+  do { if (profiler::enabled) profiler::addBytes(bytes); } while (0)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+#define PROFILE_BYTES(bytes)
+#endif
+
+#endif /* GRIM_PROFILER_H_ */
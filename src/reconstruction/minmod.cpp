@@ -1,9 +1,7 @@
 #include "reconstruction.hpp"
 
 
-array reconstruction::minmod(array &x, array &y, array &z,
-                             int &numReads, int &numWrites
-                            )
+array reconstruction::minmod(array &x, array &y, array &z)
 {
   array minOfAll = af::min(af::min(af::abs(x), af::abs(y)), 
 		                       af::abs(z)
@@ -19,10 +17,7 @@ array reconstruction::minmod(array &x, array &y, array &z,
   return result;
 }
 
-array reconstruction::slopeMM(const int dir,const double dX, const array& in,
-                              int &numReads,
-                              int &numWrites
-                             )
+array reconstruction::slopeMM(const int dir,const double dX, const array& in)
 {
   double filter1D[]  = {1,-1, 0, // Forward difference
                         0, 1,-1  // Backward difference 
@@ -55,10 +50,7 @@ array reconstruction::slopeMM(const int dir,const double dX, const array& in,
   array center = 0.5 * centralDiff;
   array right  = slopeLimTheta * forwardDiff;
   
-  int numReadsMinMod, numWritesMinMod;
-  array result = minmod(left, center, right,
-                        numReadsMinMod, numWritesMinMod
-                       );
+  array result = minmod(left, center, right);
 
   return result;
 }
@@ -66,27 +58,25 @@ array reconstruction::slopeMM(const int dir,const double dX, const array& in,
 void reconstruction::reconstructMM(const grid &prim,
                 	                 const int dir,
                           		     grid &primLeft,
-          		                     grid &primRight,
-                                   int &numReads,
-                                   int &numWrites
+          		                     grid &primRight
                           		    )
 {
-  int numReadsMinMod, numWritesMinMod;
   std::vector<af::array *> arraysThatNeedEval;
   for(int var=0; var<prim.numVars; var++)
   {
   	//Note: we set dX=1., because the 1/dX in slope
   	//exactly cancels the dX in the computation of the
   	//value on cell faces...
-  	array slope = slopeMM(dir,1.,prim.vars[var],
-                          numReadsMinMod, numWritesMinMod
-                         );
+  	array slope = slopeMM(dir,1.,prim.vars[var]);
   	primLeft.vars[var]  = prim.vars[var] - 0.5*slope;
   	primRight.vars[var] = prim.vars[var] + 0.5*slope;
 
     arraysThatNeedEval.push_back(&primLeft.vars[var]);
     arraysThatNeedEval.push_back(&primRight.vars[var]);
   }
+  PROFILE_BYTES(  profiler::arrayBytes(arraysThatNeedEval)
+                + profiler::arrayBytes(prim.numVars, prim.vars)
+               );
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
 }
 
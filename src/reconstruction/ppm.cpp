@@ -1,8 +1,6 @@
 #include "reconstruction.hpp"
 
-array reconstruction::slopePPM(const int dir,const double dX, const array& in,
-			       int &numReads, int &numWrites
-			       )
+array reconstruction::slopePPM(const int dir,const double dX, const array& in)
 {
  // Construct stencil
   int x0Shift, y0Shift, z0Shift;
@@ -85,9 +83,7 @@ array reconstruction::slopePPM(const int dir,const double dX, const array& in,
 void reconstruction::reconstructPPM(const grid &prim,
 				    const int dir,
 				    grid &primLeft,
-				    grid &primRight,
-				    int &numReads,
-                                    int &numWrites
+				    grid &primRight
 				    )
 {
   // Construct stencil
@@ -173,6 +169,7 @@ void reconstruction::reconstructPPM(const grid &prim,
     std::vector<af::array *> toEval{};
     toEval.push_back(&primLeft.vars[var]);
     toEval.push_back(&primRight.vars[var]);
+    PROFILE_BYTES(profiler::arrayBytes(toEval) + prim.vars[var].bytes());
     af::eval(toEval.size(), &toEval[0]);
   }
 }
@@ -3,34 +3,26 @@
 void reconstruction::reconstruct(const grid &prim,
                                  const int dir,
                                  grid &primLeft,
-                                 grid &primRight,
-                                 int &numReads,
-                                 int &numWrites
+                                 grid &primRight
                                 )
 {
   switch (params::reconstruction)
   {
     case reconstructionOptions::MINMOD:
 
-      reconstruction::reconstructMM(prim, dir, primLeft, primRight,
-                                    numReads, numWrites
-                                   );
+      reconstruction::reconstructMM(prim, dir, primLeft, primRight);
 
       break;
 
     case reconstructionOptions::WENO5:
 
-      reconstruction::reconstructWENO5(prim, dir, primLeft, primRight,
-                                       numReads, numWrites
-                                      );
+      reconstruction::reconstructWENO5(prim, dir, primLeft, primRight);
 
       break;
 
   case reconstructionOptions::PPM:
 
-      reconstruction::reconstructPPM(prim, dir, primLeft, primRight,
-                                       numReads, numWrites
-                                      );
+      reconstruction::reconstructPPM(prim, dir, primLeft, primRight);
 
       break;
   }
@@ -38,23 +30,21 @@ void reconstruction::reconstruct(const grid &prim,
 }
 
 array reconstruction::slope(const int dir, const double dX,
-			                      const array& in,
-                            int &numReads,
-                            int &numWrites
+			                      const array& in
                            )
 {
   switch (params::reconstruction)
   {
     case reconstructionOptions::MINMOD:
 
-      return reconstruction::slopeMM(dir,dX,in, numReads, numWrites);
+      return reconstruction::slopeMM(dir,dX,in);
 
     case reconstructionOptions::WENO5:
 
-      return reconstruction::slopeWENO5(dir,dX,in, numReads, numWrites);
+      return reconstruction::slopeWENO5(dir,dX,in);
 
     case reconstructionOptions::PPM:
 
-      return reconstruction::slopePPM(dir,dX,in, numReads, numWrites);
+      return reconstruction::slopePPM(dir,dX,in);
    }
 }
@@ -6,64 +6,46 @@
 /* Reconstruction routines */
 namespace reconstruction
 {
-  array minmod(array &x, array &y, array &z,
-               int &numReads, int &numWrites
-              );
+  array minmod(array &x, array &y, array &z);
   
   array slopeMM(const int dir,const double dX,
-		            const array& in,
-                int &numReads,
-                int &numWrites
+		            const array& in
                );
 
   array slopeWENO5(const int dir,const double dX,
-		               const array& in,
-                   int &numReads,
-                   int &numWrites
+		               const array& in
                   );
 
   array slopePPM(const int dir,const double dX,
-		               const array& in,
-                   int &numReads,
-                   int &numWrites
+		               const array& in
                   );
 
   array slope(const int dir,const double dX,
-		          const array& in,
-              int &numReads,
-              int &numWrites
+		          const array& in
              );
 
   void reconstructMM(const grid &prim,
                      const int dir,
 	              		 grid &primLeft,
-                     grid &primRight,
-                     int &numReads,
-                     int &numWrites
+                     grid &primRight
                     );
 
   void reconstructWENO5(const grid &prim,
                   			const int dir,
                   			grid &primLeft,
-                  			grid &primRight,
-                        int &numReads,
-                        int &numWrites
+                  			grid &primRight
                   		 );
 
   void reconstructPPM(const grid &prim,
                   			const int dir,
                   			grid &primLeft,
-                  			grid &primRight,
-                        int &numReads,
-                        int &numWrites
+                  			grid &primRight
                   		 );
 
   void reconstruct(const grid &prim,
                    const int dir,
                    grid &primLeft,
-                   grid &primRight,
-                   int &numReads,
-                   int &numWrites
+                   grid &primRight
                   );
 }
 
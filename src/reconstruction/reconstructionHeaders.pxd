@@ -4,21 +4,15 @@ cdef extern from "reconstruction.hpp" namespace "reconstruction":
   void reconstruct(const grid &prim,
               const int dir,
               grid &primLeft,
-              grid &primRight,
-              int &numReads,
-              int &numWrites
+              grid &primRight
              )
   void reconstructMM(const grid &prim,
                 const int dir,
                 grid &primLeft,
-                grid &primRight,
-                int &numReads,
-                int &numWrites
+                grid &primRight
                )
   void reconstructWENO5(const grid &prim,
                         const int dir,
                         grid &primLeft,
-                        grid &primRight,
-                        int &numReads,
-                        int &numWrites
+                        grid &primRight
                        )
@@ -11,38 +11,26 @@ def reconstructPy(gridPy prim,
                   gridPy primLeft,
                   gridPy primRight
                  ):
-  cdef int numReads = 0
-  cdef int numWrites = 0
   reconstruct(prim.getGridPtr()[0], 
               dir,
               primLeft.getGridPtr()[0],
-              primRight.getGridPtr()[0],
-              numReads, numWrites
+              primRight.getGridPtr()[0]
              )
-  return numReads, numWrites
 
 def reconstructMinModPy(gridPy prim, 
                         int dir,
                         gridPy primLeft,
                         gridPy primRight
                        ):
-  cdef int numReads  = 0
-  cdef int numWrites = 0
   reconstructMM(prim.getGridPtr()[0],
                 dir,
                 primLeft.getGridPtr()[0],
-                primRight.getGridPtr()[0],
-                numReads, numWrites
+                primRight.getGridPtr()[0]
                )
-  return numReads, numWrites
 
 def reconstructWENO5Py(gridPy prim, dir, gridPy primLeft, gridPy primRight):
-  cdef int numReads  = 0
-  cdef int numWrites = 0
   reconstructWENO5(prim.getGridPtr()[0],
                    dir,
                    primLeft.getGridPtr()[0],
-                   primRight.getGridPtr()[0],
-                   numReads, numWrites
+                   primRight.getGridPtr()[0]
                   )
-  return numReads, numWrites
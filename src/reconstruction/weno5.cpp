@@ -1,8 +1,6 @@
 #include "reconstruction.hpp"
 
-array reconstruction::slopeWENO5(const int dir,const double dX, const array& in,
-                                 int &numReads, int &numWrites
-                                )
+array reconstruction::slopeWENO5(const int dir,const double dX, const array& in)
 {
   //WENO5 algorithm, copied from SpEC (up to some left/right conventions, and
   //the use of AF...)
@@ -41,26 +39,11 @@ array reconstruction::slopeWENO5(const int dir,const double dX, const array& in,
   array y2 = in;
   array y3 = af::shift(in, x3Shift, y3Shift, z3Shift);
   array y4 = af::shift(in, x4Shift, y4Shift, z4Shift);
-  /* Reads:
-   * -----
-   * shift -2, -1, 1, 2: 4
-   *
-   * Writes:
-   * ------
-   * y0, y1, y3, y4 : 4 */
 
   //temporary formula : smooth 5pt stencil
   array ans = (-y4+8.*y3-8.*y1+y0)/12./dX;
+  PROFILE_BYTES(ans.bytes() + in.bytes());
   ans.eval();
-  /* Reads:
-   * -----
-   *  y4, y3, y1, y0 : 4
-   *
-   * Writes:
-   * ------
-   * ans : 1 */
-  numReads  = 8;
-  numWrites = 5;
   
   return ans;
 
@@ -111,9 +94,7 @@ array reconstruction::slopeWENO5(const int dir,const double dX, const array& in,
 void reconstruction::reconstructWENO5(const grid &prim,
                                       const int dir,
                                       grid &primLeft,
-                                      grid &primRight,
-                                      int &numReads,
-                                      int &numWrites
+                                      grid &primRight
                                      )
 {
   //WENO5 algorithm, copied from SpEC (up to some left/right conventions, and
@@ -155,13 +136,6 @@ void reconstruction::reconstructWENO5(const grid &prim,
     array y2 = prim.vars[var];
     array y3 = af::shift(prim.vars[var], x3Shift, y3Shift, z3Shift);
     array y4 = af::shift(prim.vars[var], x4Shift, y4Shift, z4Shift);
-    /* Reads:
-     * -----
-     * shift -2, -1, 1, 2: 4*prim.numVars
-     *
-     * Writes:
-     * ------
-     * y0, y1, y3, y4 : 4*prim.numvars */
 
   	//Compute smoothness operators
   	array beta1 = (( 4.0/3.0)*y0*y0 - (19.0/3.0)*y0*y1 +
@@ -170,14 +144,8 @@ void reconstruction::reconstructWENO5(const grid &prim,
                   )
                  +
                   eps2*(1.0 + af::abs(y0) + af::abs(y1) + af::abs(y2));
+    PROFILE_BYTES(beta1.bytes() + prim.vars[var].bytes());
     beta1.eval();
-    /* Reads:
-     * -----
-     * y0, y1, y2: 3*prim.numVars
-     *
-     * Writes:
-     * ------
-     * beta1: prim.numvars */
 
   	array beta2 = (( 4.0/3.0)*y1*y1 - (13.0/3.0)*y1*y2 +
 	                 (13.0/3.0)*y2*y2 + ( 5.0/3.0)*y1*y3 -
@@ -185,14 +153,8 @@ void reconstruction::reconstructWENO5(const grid &prim,
                   ) 
                  +
               	  eps2*(1.0 + af::abs(y1) + af::abs(y2) + af::abs(y3));
+    PROFILE_BYTES(beta2.bytes() + prim.vars[var].bytes());
     beta2.eval();
-    /* Reads:
-     * -----
-     * y1, y2, y3: 3*prim.numVars
-     *
-     * Writes:
-     * ------
-     * beta2: prim.numvars */
 
 	  array beta3 = ((10.0/3.0)*y2*y2 - (31.0/3.0)*y2*y3 +
 	                 (25.0/3.0)*y3*y3 + (11.0/3.0)*y2*y4 -
@@ -200,14 +162,8 @@ void reconstruction::reconstructWENO5(const grid &prim,
                   ) 
                  + 
               	  eps2*(1.0 + af::abs(y2) + af::abs(y3) + af::abs(y4));
+    PROFILE_BYTES(beta3.bytes() + prim.vars[var].bytes());
     beta3.eval();
-    /* Reads:
-     * -----
-     * y2, y3, y4: 3*prim.numVars
-     *
-     * Writes:
-     * ------
-     * beta3: prim.numvars */
 
   	//Compute weights
   	array w1r = 1.0/(16.0*beta1*beta1);
@@ -231,28 +187,12 @@ void reconstruction::reconstructWENO5(const grid &prim,
   	primLeft.vars[var] = (w1l*u1l + w2l*u2l + w3l*u3l) / denl;
   	primRight.vars[var] = (w1r*u1r + w2r*u2r + w3r*u3r) / denr;
 
+    PROFILE_BYTES(  primLeft.vars[var].bytes() + primRight.vars[var].bytes()
+                  + beta1.bytes() + beta2.bytes() + beta3.bytes()
+                  + prim.vars[var].bytes()
+                 );
     primLeft.vars[var].eval();
-    /* Reads:
-     * -----
-     * beta1, beta2, beta3, y0, y1, y2, y3, y4: 7*prim.numVars
-     *
-     * Writes:
-     * ------
-     * primLeft: prim.numvars */
-
     primRight.vars[var].eval();
-    /* Reads:
-     * -----
-     * beta1, beta2, beta3, y0, y1, y2, y3, y4: 7*prim.numVars
-     *
-     * Writes:
-     * ------
-     * primRight: prim.numvars */
   }
-  /* Total reads : 27*prim.numVars
-   * Total writes: 9*prim.numVars */ 
-
-  numReads  = 27*prim.numVars;
-  numWrites = 9*prim.numVars;
 }
   
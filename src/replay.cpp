@@ -0,0 +1,213 @@
+#include "grim.hpp"
+#include "params.hpp"
+#include <cstring>
+
+/* grim_replay: repeat one stage of the half step on a snapshot of a real run
+ * (timeStepper::replay()), under the profiler, to optimize an expensive
+ * production step offline.
+ *
+ *   mpirun -np 1 ./grim_replay -replay_file primVarsT000042.h5 \
+ *                              -replay_stage solve -replay_evals 10
+ *
+ * -replay_file  : primVarsT*.h5 dump or restartVarsT*.h5 file (required).
+ *                 N1, N2, N3, dim and the physics in params.cpp must be those
+ *                 of the run that wrote it; any number of ranks will do.
+ * -replay_stage : fluxes (computeDivOfFluxes), solve (the half step solver)
+ *                 or floors (halfStepDiagnostics, the floors in the torus)
+ * -replay_evals : repetitions (default 10)
+ * -replay_time  : time of the snapshot, for time dependent problems
+ * -replay_compare_tol : with BACKEND Native, run the half step once with
+ *                 each backend instead, from the snapshot or else from the
+ *                 initial conditions, and fail if the divergence of the
+ *                 fluxes or the primitives differ by more than this relative
+ *                 tolerance, or if the residual of the native primitives
+ *                 exceeds that of ArrayFire by more than it. The
+ *                 divergence of the fluxes from the flux task graph is also
+ *                 compared with the serial native sweeps (the ctest
+ *                 backends_* tests)
+ * -replay_dim, -replay_N : dimension and zones along each direction, in
+ *                 place of those of params.cpp, without -replay_file
+ *
+ * The profile goes to params::profileFile, with one record over all
+ * repetitions unless profileEveryNSteps is set; traceNumSteps > 0 also
+ * writes a timeline of the repetitions. */
+int main(int argc, char **argv)
+{
+  PetscInitialize(&argc, &argv, NULL, help);
+
+  int world_rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+  //af::setDevice(world_rank%params::numDevices);
+  af::setDevice(1);
+
+  std::string threadInfo;
+  threads::setupThreads(params::numThreads, params::pinThreads, threadInfo);
+  PetscSynchronizedPrintf(PETSC_COMM_WORLD, "  Rank %d : %s\n",
+                          world_rank, threadInfo.c_str()
+                         );
+  PetscSynchronizedFlush(PETSC_COMM_WORLD, PETSC_STDOUT);
+
+  char fileName[PETSC_MAX_PATH_LEN];
+  char stageName[PETSC_MAX_PATH_LEN] = "solve";
+  PetscInt numEvals = 10;
+  PetscReal time = params::Time;
+  PetscReal compareTol = 0.;
+  PetscInt dim = params::dim;
+  PetscInt N[3] = {params::N1, params::N2, params::N3};
+  PetscInt numN = 3;
+  PetscBool fileSet, compareSet, isSet;
+  PetscOptionsGetString(NULL, NULL, "-replay_file", fileName,
+                        PETSC_MAX_PATH_LEN, &fileSet
+                       );
+  PetscOptionsGetString(NULL, NULL, "-replay_stage", stageName,
+                        PETSC_MAX_PATH_LEN, &isSet
+                       );
+  PetscOptionsGetInt(NULL, NULL, "-replay_evals", &numEvals, &isSet);
+  PetscOptionsGetReal(NULL, NULL, "-replay_time", &time, &isSet);
+  PetscOptionsGetReal(NULL, NULL, "-replay_compare_tol", &compareTol,
+                      &compareSet
+                     );
+  PetscOptionsGetInt(NULL, NULL, "-replay_dim", &dim, &isSet);
+  PetscOptionsGetIntArray(NULL, NULL, "-replay_N", N, &numN, &isSet);
+  if (isSet && numN < dim)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "-replay_N needs %d sizes\n", (int)dim);
+    PetscFinalize();
+    return(1);
+  }
+
+  /* The physics and the problem read these too */
+  params::dim = dim;
+  params::N1  = N[0];
+  params::N2  = (dim > 1 ? N[1] : 1);
+  params::N3  = (dim > 2 ? N[2] : 1);
+
+  int stage = -1;
+  if (strcmp(stageName, "fluxes") == 0)
+  {
+    stage = replayStages::DIV_OF_FLUXES;
+  }
+  else if (strcmp(stageName, "solve") == 0)
+  {
+    stage = replayStages::SOLVE;
+  }
+  else if (strcmp(stageName, "floors") == 0)
+  {
+    stage = replayStages::FLOORS;
+  }
+  if ((!fileSet && !compareSet) || stage < 0)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "Usage: grim_replay -replay_file <file.h5> "
+                "[-replay_stage fluxes|solve|floors] [-replay_evals N] "
+                "[-replay_time t]\n"
+                "       grim_replay [-replay_file <file.h5>] "
+                "-replay_compare_tol tol\n"
+                "       [-replay_dim d -replay_N n1,n2,n3]\n"
+               );
+    PetscFinalize();
+    return(1);
+  }
+
+  /* The snapshot replaces the initial conditions; no restart lookup,
+   * geometry cache, checkpoints or signal handlers */
+  params::restart                 = 0;
+  params::restartFileName         = "";
+  params::restartFileTime         = "";
+  params::geometryCache           = 0;
+  params::checkpointOnSignal      = 0;
+  params::checkpointEveryNSteps   = 0;
+  params::checkpointEveryWallTime = 0.;
+  params::MaxWallTime             = 1e30;
+
+  int exitStatus = 0;
+  /* Local scope so that destructors of all classes are called before
+   * PetscFinalize() */
+  {
+    timeStepper ts(params::N1, params::N2, params::N3,
+                   params::dim, vars::dof, params::numGhost,
+                   time, params::InitialDt,
+                   params::boundaryLeft,  params::boundaryRight,
+                   params::boundaryTop,   params::boundaryBottom,
+                   params::boundaryFront, params::boundaryBack,
+                   params::metric, params::blackHoleSpin, params::hSlope,
+                   params::X1Start, params::X1End,
+                   params::X2Start, params::X2End,
+                   params::X3Start, params::X3End
+                  );
+
+    if (fileSet)
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "\n  Loading %s\n", fileName);
+      ts.primOld->load("primitives", fileName);
+    }
+
+    if (compareSet)
+    {
+      int status = 1;
+#ifdef GRIM_NATIVE_BACKEND
+      double divFluxesError, primError, nativeResidual, arrayFireResidual;
+      if (ts.compareBackends(divFluxesError, primError,
+                             nativeResidual, arrayFireResidual
+                            )
+         )
+      {
+        PetscPrintf(PETSC_COMM_WORLD,
+                    "  Native vs ArrayFire : divFluxes %g, prim %g "
+                    "(relative), residual %g vs %g\n",
+                    divFluxesError, primError,
+                    nativeResidual, arrayFireResidual
+                   );
+        status = (   divFluxesError <= compareTol
+                  && primError      <= compareTol
+                  && nativeResidual <= arrayFireResidual + compareTol
+                 ) ? 0 : 1;
+
+        double tasksError;
+        ts.compareFluxTasks(tasksError);
+        PetscPrintf(PETSC_COMM_WORLD,
+                    "  Flux tasks vs serial sweeps : divFluxes %g "
+                    "(relative)\n", tasksError
+                   );
+        if (tasksError > compareTol)
+        {
+          status = 1;
+        }
+      }
+      else
+      {
+        PetscPrintf(PETSC_COMM_WORLD,
+                    "  The native backend does not cover this problem\n"
+                   );
+      }
+#else
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "  -replay_compare_tol needs BACKEND Native\n"
+                 );
+#endif
+      PetscPrintf(PETSC_COMM_WORLD, "  Backend comparison %s\n",
+                  status == 0 ? "passed" : "FAILED"
+                 );
+      exitStatus = status;
+    }
+    else
+    {
+      /* Untimed pass that generates the compute kernels */
+      PetscPrintf(PETSC_COMM_WORLD, "  Generating compute kernels...\n\n");
+      ts.replay(stage, 1);
+
+      profiler::setup(  params::profileEveryNSteps > 0
+                      ? params::profileEveryNSteps : numEvals,
+                      params::profileSync, params::profileCounters,
+                      params::profileFormat, params::profileFile
+                     );
+      profiler::setupTrace(params::traceStartStep, params::traceNumSteps,
+                           params::traceFile
+                          );
+      ts.replay(stage, numEvals);
+      profiler::finish();
+    }
+  }
+  PetscFinalize();
+  return(exitStatus);
+}
@@ -0,0 +1,169 @@
+#include "grim.hpp"
+#include "params.hpp"
+#include <omp.h>
+#include <fstream>
+
+/* grim_scaling: a fixed number of time steps of the problem set in
+ * params.cpp, with observers, data dumps and restarts off, for scaling
+ * studies (see scaling.py, which runs it at a series of rank counts).
+ *
+ *   mpirun -np 4 ./grim_scaling -scaling_N 256,256 -scaling_steps 10
+ *   mpirun -np 4 ./grim_scaling -scaling_local 64,64 -scaling_steps 10
+ *
+ * -scaling_N       : global zones (strong scaling, default params::N1..N3)
+ * -scaling_local   : zones per rank (weak scaling). The ranks are arranged
+ *                    in a dim-dimensional grid (MPI_Dims_create) and the
+ *                    global size follows.
+ * -scaling_dim     : dimensions (default params::dim)
+ * -scaling_steps   : timed steps (default 10), after one untimed step that
+ *                    generates the compute kernels
+ * -scaling_profile : profiler output for the timed steps, CSV
+ *                    (default scaling_profile.csv)
+ * -scaling_file    : one summary line per run is appended here
+ *                    (default scaling.csv)
+ *
+ * The summary has the slowest rank's wall time per step and the
+ * zone-cycles/sec/rank, zones advanced by one step per second per rank. */
+int main(int argc, char **argv)
+{
+  PetscInitialize(&argc, &argv, NULL, help);
+
+  int world_rank, world_size;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &world_rank);
+  MPI_Comm_size(PETSC_COMM_WORLD, &world_size);
+  //af::setDevice(world_rank%params::numDevices);
+  af::setDevice(1);
+
+  std::string threadInfo;
+  threads::setupThreads(params::numThreads, params::pinThreads, threadInfo);
+  PetscSynchronizedPrintf(PETSC_COMM_WORLD, "  Rank %d : %s\n",
+                          world_rank, threadInfo.c_str()
+                         );
+  PetscSynchronizedFlush(PETSC_COMM_WORLD, PETSC_STDOUT);
+
+  PetscInt N[3]     = {params::N1, params::N2, params::N3};
+  PetscInt local[3] = {1, 1, 1};
+  PetscInt numN = 3, numLocal = 3;
+  PetscInt dim = params::dim, numSteps = 10;
+  char profileFile[PETSC_MAX_PATH_LEN] = "scaling_profile.csv";
+  char fileName[PETSC_MAX_PATH_LEN]    = "scaling.csv";
+  PetscBool weakScaling, isSet;
+  PetscOptionsGetIntArray(NULL, NULL, "-scaling_N", N, &numN, &isSet);
+  PetscOptionsGetIntArray(NULL, NULL, "-scaling_local", local, &numLocal,
+                          &weakScaling
+                         );
+  PetscOptionsGetInt(NULL, NULL, "-scaling_dim", &dim, &isSet);
+  PetscOptionsGetInt(NULL, NULL, "-scaling_steps", &numSteps, &isSet);
+  PetscOptionsGetString(NULL, NULL, "-scaling_profile", profileFile,
+                        PETSC_MAX_PATH_LEN, &isSet
+                       );
+  PetscOptionsGetString(NULL, NULL, "-scaling_file", fileName,
+                        PETSC_MAX_PATH_LEN, &isSet
+                       );
+
+  if (weakScaling)
+  {
+    int numProcs[3] = {0, 0, 0};
+    MPI_Dims_create(world_size, dim, numProcs);
+
+    std::vector<PetscInt> ranges[3];
+    for (int d=0; d < dim; d++)
+    {
+      ranges[d].assign(numProcs[d], local[d]);
+      N[d] = numProcs[d]*local[d];
+    }
+    grid::setOwnershipRanges(ranges[0], ranges[1], ranges[2]);
+  }
+
+  /* The physics and the problem read these too */
+  params::dim = dim;
+  params::N1  = N[0];
+  params::N2  = (dim > 1 ? N[1] : 1);
+  params::N3  = (dim > 2 ? N[2] : 1);
+
+  /* Nothing but the steps: no observers, dumps, restarts, geometry cache,
+   * checkpoints or signal handlers */
+  params::ObserveEveryDt          = 1e30;
+  params::WriteDataEveryDt        = 1e30;
+  params::restart                 = 0;
+  params::restartFileName         = "";
+  params::restartFileTime         = "";
+  params::geometryCache           = 0;
+  params::checkpointOnSignal      = 0;
+  params::checkpointEveryNSteps   = 0;
+  params::checkpointEveryWallTime = 0.;
+  params::MaxWallTime             = 1e30;
+
+  PetscPrintf(PETSC_COMM_WORLD, "  Scaling run : %s, %i ranks, %i x %i x %i zones, %i steps\n\n",
+              weakScaling ? "weak" : "strong", world_size,
+              params::N1, params::N2, params::N3, numSteps
+             );
+
+  /* Local scope so that destructors of all classes are called before
+   * PetscFinalize() */
+  {
+    timeStepper ts(params::N1, params::N2, params::N3,
+                   params::dim, vars::dof, params::numGhost,
+                   params::Time, params::InitialDt,
+                   params::boundaryLeft,  params::boundaryRight,
+                   params::boundaryTop,   params::boundaryBottom,
+                   params::boundaryFront, params::boundaryBack,
+                   params::metric, params::blackHoleSpin, params::hSlope,
+                   params::X1Start, params::X1End,
+                   params::X2Start, params::X2End,
+                   params::X3Start, params::X3End
+                  );
+
+    PetscPrintf(PETSC_COMM_WORLD, "  Generating compute kernels...\n\n");
+    ts.timeStep();
+    af::sync();
+
+    /* One profile record covering all timed steps */
+    profiler::setup(numSteps, params::profileSync, params::profileCounters,
+                    profileFormats::CSV, profileFile
+                   );
+
+    MPI_Barrier(PETSC_COMM_WORLD);
+    double startTime = MPI_Wtime();
+    for (int n=1; n <= numSteps; n++)
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "\n|----Time step %d----|\n", n);
+      profiler::beginStep(n);
+      ts.timeStep();
+      profiler::endStep(n);
+    }
+    af::sync();
+    double timePerStep = (MPI_Wtime() - startTime)/numSteps;
+    MPI_Allreduce(MPI_IN_PLACE, &timePerStep, 1, MPI_DOUBLE, MPI_MAX,
+                  PETSC_COMM_WORLD
+                 );
+    profiler::finish();
+
+    const double numZones = (double)params::N1*params::N2*params::N3;
+    const double zoneCyclesPerSecPerRank = numZones/timePerStep/world_size;
+    PetscPrintf(PETSC_COMM_WORLD, "\n  Time per step : %g sec\n", timePerStep);
+    PetscPrintf(PETSC_COMM_WORLD, "  Zone-cycles   : %g /sec/rank\n\n",
+                zoneCyclesPerSecPerRank
+               );
+
+    if (world_rank == 0)
+    {
+      bool newFile = !std::ifstream(fileName).good();
+      std::ofstream file(fileName, std::ios::app);
+      if (newFile)
+      {
+        file << "mode,ranks,threads,dim,N1,N2,N3,steps,timePerStep,"
+             << "zoneCyclesPerSecPerRank,profile\n";
+      }
+      file.precision(6);
+      file << std::scientific;
+      file << (weakScaling ? "weak" : "strong") << "," << world_size << ","
+           << omp_get_max_threads() << "," << params::dim << ","
+           << params::N1 << "," << params::N2 << "," << params::N3 << ","
+           << numSteps << "," << timePerStep << ","
+           << zoneCyclesPerSecPerRank << "," << profileFile << "\n";
+    }
+  }
+  PetscFinalize();
+  return(0);
+}
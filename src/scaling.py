@@ -0,0 +1,187 @@
+#!/usr/bin/env python
+"""Strong and weak scaling runs of grim_scaling (see scaling.cpp).
+
+Run from the build folder, e.g. on one machine with 8 cores:
+
+  python scaling.py strong --ranks 1,2,4,8 --N 256,256 --dim 2
+  python scaling.py weak   --ranks 1,2,4,8 --local 64,64 --dim 2
+  python scaling.py table  scaling/scaling.csv
+
+Each run appends a line to <out>/scaling.csv and writes its per-stage
+profile to <out>/profile_<mode>_<ranks>.csv. The tables give, relative to
+the run with the fewest ranks:
+
+  efficiency    : zone-cycles/sec/rank over that of the first run, i.e.
+                  T_1 p_1/(T_p p) for strong and T_1/T_p for weak scaling
+  comm fraction : time in communication ("communication", "communicate"
+                  and "MPI..." profiler regions) over the time in "step"
+"""
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+def isCommunication(region):
+  name = region.split('/')[-1]
+  return (   name in ('communication', 'communicate')
+          or name.startswith('MPI')
+         )
+
+def readProfile(fileName):
+  """Returns (step time, communication time), per step and avg over ranks,
+  of the last record of a CSV profile."""
+  with open(fileName) as profileFile:
+    rows = list(csv.DictReader(profileFile))
+  if len(rows) == 0:
+    return 0., 0.
+  lastStep = rows[-1]['step']
+  rows = [row for row in rows if row['step'] == lastStep]
+
+  stepTime = 0.
+  commTime = 0.
+  commRegions = []
+  for row in rows:
+    region = row['region']
+    if region == 'step':
+      stepTime = float(row['avg'])
+    # Nested communication regions are already in their parent's time
+    nested = any(region.startswith(parent + '/') for parent in commRegions)
+    if isCommunication(region) and not nested:
+      commRegions.append(region)
+      commTime += float(row['avg'])
+
+  return stepTime, commTime
+
+def printTables(summaryFileName):
+  with open(summaryFileName) as summaryFile:
+    runs = list(csv.DictReader(summaryFile))
+  summaryDir = os.path.dirname(summaryFileName)
+
+  for mode in ('strong', 'weak'):
+    modeRuns = sorted([run for run in runs if run['mode'] == mode],
+                      key=lambda run: int(run['ranks'])
+                     )
+    if len(modeRuns) == 0:
+      continue
+
+    print('')
+    print('  %s scaling' % mode.capitalize())
+    print('  %6s %8s %18s %12s %10s %10s %14s'
+          % ('ranks', 'threads', 'zones', 'time/step', 'speedup',
+             'efficiency', 'comm fraction'
+            )
+         )
+    first = modeRuns[0]
+    for run in modeRuns:
+      profileFileName = run['profile']
+      if not os.path.isabs(profileFileName) and not os.path.exists(profileFileName):
+        profileFileName = os.path.join(summaryDir, os.path.basename(profileFileName))
+      commFraction = float('nan')
+      if os.path.exists(profileFileName):
+        stepTime, commTime = readProfile(profileFileName)
+        if stepTime > 0.:
+          commFraction = commTime/stepTime
+
+      zones = '%sx%sx%s' % (run['N1'], run['N2'], run['N3'])
+      speedup    = float(first['timePerStep'])/float(run['timePerStep'])
+      efficiency =   float(run['zoneCyclesPerSecPerRank']) \
+                   / float(first['zoneCyclesPerSecPerRank'])
+      # Speedup only means something at a fixed problem size
+      print('  %6s %8s %18s %12.4e %10s %10.3f %14.3f'
+            % (run['ranks'], run['threads'], zones, float(run['timePerStep']),
+               '%.3f' % speedup if mode == 'strong' else '-',
+               efficiency, commFraction
+              )
+           )
+    print('  zone-cycles/sec/rank at %s ranks: %s'
+          % (modeRuns[-1]['ranks'], modeRuns[-1]['zoneCyclesPerSecPerRank'])
+         )
+  print('')
+
+def runSeries(args):
+  if not os.path.isdir(args.out):
+    os.makedirs(args.out)
+  summaryFileName = os.path.join(args.out, 'scaling.csv')
+
+  env = dict(os.environ)
+  env['OMP_NUM_THREADS'] = str(args.threads)
+
+  for ranks in [int(r) for r in args.ranks.split(',')]:
+    profileFileName = os.path.join(args.out,
+                                   'profile_%s_%d.csv' % (args.mode, ranks)
+                                  )
+    if os.path.exists(profileFileName):
+      os.remove(profileFileName)
+
+    command = args.mpirun.split() + ['-np', str(ranks), args.executable,
+                                     '-scaling_steps', str(args.steps),
+                                     '-scaling_profile', profileFileName,
+                                     '-scaling_file', summaryFileName
+                                    ]
+    if args.dim is not None:
+      command += ['-scaling_dim', str(args.dim)]
+    if args.mode == 'strong' and args.N is not None:
+      command += ['-scaling_N', args.N]
+    if args.mode == 'weak':
+      command += ['-scaling_local', args.local]
+
+    print('  ' + ' '.join(command))
+    with open(os.path.join(args.out, 'log_%s_%d.txt' % (args.mode, ranks)), 'w') as log:
+      returnCode = subprocess.call(command, stdout=log, stderr=subprocess.STDOUT,
+                                   env=env
+                                  )
+    if returnCode != 0:
+      sys.exit('  Run with %d ranks failed, see the log in %s'
+               % (ranks, args.out)
+              )
+
+  printTables(summaryFileName)
+
+def main():
+  parser = argparse.ArgumentParser(description='grim scaling studies')
+  subparsers = parser.add_subparsers(dest='mode')
+
+  for mode in ('strong', 'weak'):
+    modeParser = subparsers.add_parser(mode, help='run a %s scaling series' % mode)
+    modeParser.add_argument('--ranks', default='1,2,4',
+                            help='comma separated rank counts'
+                           )
+    modeParser.add_argument('--threads', type=int, default=1,
+                            help='OpenMP threads per rank'
+                           )
+    modeParser.add_argument('--steps', type=int, default=10,
+                            help='timed steps per run'
+                           )
+    modeParser.add_argument('--dim', type=int, default=None,
+                            help='dimensions (default: params.cpp)'
+                           )
+    if mode == 'strong':
+      modeParser.add_argument('--N', default=None,
+                              help='global zones, e.g. 256,256 (default: params.cpp)'
+                             )
+    else:
+      modeParser.add_argument('--local', required=True,
+                              help='zones per rank, e.g. 64,64'
+                             )
+    modeParser.add_argument('--executable', default='./grim_scaling')
+    modeParser.add_argument('--mpirun', default='mpirun',
+                            help='MPI launcher and its options, e.g. "mpirun --oversubscribe"'
+                           )
+    modeParser.add_argument('--out', default='scaling',
+                            help='folder for the summary, profiles and logs'
+                           )
+
+  tableParser = subparsers.add_parser('table', help='print the tables of a summary')
+  tableParser.add_argument('summary', help='scaling.csv written by the runs')
+
+  args = parser.parse_args()
+  if args.mode == 'table':
+    printTables(args.summary)
+  elif args.mode in ('strong', 'weak'):
+    runSeries(args)
+  else:
+    parser.print_help()
+
+if __name__ == '__main__':
+  main()
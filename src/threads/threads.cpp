@@ -0,0 +1,118 @@
+#include "threads.hpp"
+#include <omp.h>
+#include <sstream>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/* Busy time of each thread, padded to a cache line so that threads do not
+ * share one */
+static const int THREAD_TIME_STRIDE = 8;
+static std::vector<double> threadTimes;
+
+void threads::setupThreads(const int numThreads,
+                          const int pinThreads,
+                          std::string &threadInfo
+                         )
+{
+  if (numThreads > 0)
+  {
+    omp_set_num_threads(numThreads);
+  }
+  const int maxThreads = omp_get_max_threads();
+  threadTimes.assign(maxThreads*THREAD_TIME_STRIDE, 0.);
+
+  std::vector<int> threadCPU(maxThreads, -1);
+
+#ifdef __linux__
+  if (pinThreads)
+  {
+    /* The CPUs this rank may run on, as set by the MPI launcher (for example
+     * --map-by numa --bind-to numa). Thread n is pinned to the n-th of them,
+     * cyclically. */
+    cpu_set_t processMask;
+    CPU_ZERO(&processMask);
+    sched_getaffinity(0, sizeof(cpu_set_t), &processMask);
+
+    std::vector<int> cpus;
+    for (int cpu=0; cpu < CPU_SETSIZE; cpu++)
+    {
+      if (CPU_ISSET(cpu, &processMask))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+
+    #pragma omp parallel
+    {
+      int thread = omp_get_thread_num();
+      int cpu    = cpus[thread % cpus.size()];
+
+      cpu_set_t threadMask;
+      CPU_ZERO(&threadMask);
+      CPU_SET(cpu, &threadMask);
+      if (sched_setaffinity(0, sizeof(cpu_set_t), &threadMask) == 0)
+      {
+        threadCPU[thread] = cpu;
+      }
+    }
+  }
+#endif
+
+  std::ostringstream info;
+  info << maxThreads << " OpenMP threads";
+  if (threadCPU[0] >= 0)
+  {
+    info << ", pinned to cpus";
+    for (int thread=0; thread < maxThreads; thread++)
+    {
+      info << " " << threadCPU[thread];
+    }
+  }
+  else
+  {
+    info << ", not pinned";
+  }
+  threadInfo = info.str();
+}
+
+void threads::resetThreadTimes()
+{
+  std::fill(threadTimes.begin(), threadTimes.end(), 0.);
+}
+
+void threads::addThreadTime(const double seconds)
+{
+  const int thread = omp_get_thread_num();
+  if ((thread+1)*THREAD_TIME_STRIDE <= threadTimes.size())
+  {
+    threadTimes[thread*THREAD_TIME_STRIDE] += seconds;
+  }
+}
+
+void threads::getThreadTimes(double &minTime, double &avgTime, double &maxTime)
+{
+  const int numThreads = threadTimes.size()/THREAD_TIME_STRIDE;
+
+  minTime = 0.;
+  avgTime = 0.;
+  maxTime = 0.;
+  for (int thread=0; thread < numThreads; thread++)
+  {
+    double time = threadTimes[thread*THREAD_TIME_STRIDE];
+    if (thread==0 || time < minTime)
+    {
+      minTime = time;
+    }
+    if (time > maxTime)
+    {
+      maxTime = time;
+    }
+    avgTime += time;
+  }
+  if (numThreads > 0)
+  {
+    avgTime /= numThreads;
+  }
+}
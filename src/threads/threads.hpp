@@ -0,0 +1,25 @@
+#ifndef GRIM_THREADS_H_
+#define GRIM_THREADS_H_
+
+#include <string>
+
+/* OpenMP threads of a rank, shared by both backends: the native kernels and
+ * the CPU batch solver of the ArrayFire path run on them */
+namespace threads
+{
+  /* Sets the number of OpenMP threads (0: leave the runtime default) and,
+   * if pinThreads, pins every thread to one CPU of the rank's affinity mask.
+   * Call once at startup, before any threaded work. */
+  void setupThreads(const int numThreads,
+                    const int pinThreads,
+                    std::string &threadInfo
+                   );
+
+  /* Per-thread busy time inside threaded loops, for the performance report.
+   * Each thread adds the time it spent on its share of a loop. */
+  void resetThreadTimes();
+  void addThreadTime(const double seconds);
+  void getThreadTimes(double &minTime, double &avgTime, double &maxTime);
+};
+
+#endif /* GRIM_THREADS_H_ */
@@ -0,0 +1,333 @@
+#include "timestepper.hpp"
+#include <omp.h>
+#include <fstream>
+#include <functional>
+
+/* Time numEvals calls of kernel after one untimed call, which also generates
+ * the JIT kernels. Returns the slowest rank's time per call. */
+static double timeKernel(const int numEvals,
+                         const std::function<void()> &kernel
+                        )
+{
+  kernel();
+  af::sync();
+  MPI_Barrier(PETSC_COMM_WORLD);
+
+  af::timer kernelTimer = af::timer::start();
+  for (int n=0; n < numEvals; n++)
+  {
+    kernel();
+  }
+  af::sync();
+  double timeElapsed = af::timer::stop(kernelTimer);
+
+  MPI_Allreduce(MPI_IN_PLACE, &timeElapsed, 1, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+  return timeElapsed/numEvals;
+}
+
+static void evalArrays(const int numArrays, array arrays[])
+{
+  std::vector<af::array *> arraysThatNeedEval;
+  for (int n=0; n < numArrays; n++)
+  {
+    arraysThatNeedEval.push_back(&arrays[n]);
+  }
+  af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
+}
+
+static double geometryBytes(const geometry &geom)
+{
+  double bytes = geom.alpha.bytes() + geom.g.bytes();
+  for (int mu=0; mu < NDIM; mu++)
+  {
+    bytes += profiler::arrayBytes(NDIM, geom.gCov[mu])
+           + profiler::arrayBytes(NDIM, geom.gCon[mu]);
+  }
+
+  return bytes;
+}
+
+/* Time the building blocks of a step one at a time on the current state and
+ * append zones/sec and GB/sec per proc to the CSV file fileName (written on
+ * rank 0, header added to a new file). The bytes are the arrays each kernel
+ * has to read and write at least once; intermediates are not counted, so
+ * the bandwidths are lower bounds, as in the profiler. Call after a time
+ * step, so that the states are physical. Overwrites the work grids and the
+ * fluid elements. Collective. */
+void timeStepper::benchmarkKernels(const int numEvals,
+                                   const std::string fileName
+                                  )
+{
+  struct kernelTiming
+  {
+    std::string name;
+    double time, bytes;
+  };
+  std::vector<kernelTiming> timings;
+  kernelTiming timing;
+
+  const int numDirections = dim;
+  grid *fluxes[3] = {fluxesX1, fluxesX2, fluxesX3};
+  const double primBytes = profiler::arrayBytes(numVars, primOld->vars);
+
+  /* fluidElement: every quantity that the fluxes and sources read */
+  std::vector<af::array *> elemArrays{&elemOld->gammaLorentzFactor,
+                                      &elemOld->bSqr, &elemOld->bNorm
+                                     };
+  for (int mu=0; mu < NDIM; mu++)
+  {
+    elemArrays.push_back(&elemOld->uCon[mu]);
+    elemArrays.push_back(&elemOld->uCov[mu]);
+    elemArrays.push_back(&elemOld->bCon[mu]);
+    elemArrays.push_back(&elemOld->bCov[mu]);
+    elemArrays.push_back(&elemOld->NUp[mu]);
+    for (int nu=0; nu < NDIM; nu++)
+    {
+      elemArrays.push_back(&elemOld->TUpDown[mu][nu]);
+    }
+  }
+
+  timing.name  = "fluidElement::set";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      elemOld->set(*primOld, *geomCenter);
+      af::eval(elemArrays.size(), &elemArrays[0]);
+    });
+  timing.bytes =   primBytes + geometryBytes(*geomCenter)
+                 + profiler::arrayBytes(elemArrays);
+  timings.push_back(timing);
+
+  /* computeFluxes() takes the index of the 4-vector component, 1 to 3 */
+  timing.name  = "computeFluxes";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      for (int dir=1; dir <= numDirections; dir++)
+      {
+        elemOld->computeFluxes(dir, *fluxes[dir-1]);
+        evalArrays(numVars, fluxes[dir-1]->vars);
+      }
+    });
+  timing.bytes = 0.;
+  for (int dir=1; dir <= numDirections; dir++)
+  {
+    timing.bytes +=   geomCenter->g.bytes() + elemOld->NUp[dir].bytes()
+                    + profiler::arrayBytes(NDIM, elemOld->TUpDown[dir])
+                    + profiler::arrayBytes(NDIM, elemOld->bCon)
+                    + profiler::arrayBytes(NDIM, elemOld->uCon)
+                    + profiler::arrayBytes(numVars, fluxes[dir-1]->vars);
+  }
+  timings.push_back(timing);
+
+  array minSpeed[3], maxSpeed[3];
+  timing.name  = "computeMinMaxCharSpeeds";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      for (int dir=directions::X1; dir < directions::X1 + numDirections;
+           dir++
+          )
+      {
+        elemOld->computeMinMaxCharSpeeds(dir, minSpeed[dir], maxSpeed[dir]);
+        af::eval(minSpeed[dir], maxSpeed[dir]);
+      }
+    });
+  /* rho, u, bSqr, soundSpeed, uCon^0, uCon^dir, gCon^00, gCon^0dir and
+   * gCon^dirdir in; both speeds out */
+  timing.bytes = numDirections*11.*elemOld->rho.bytes();
+  timings.push_back(timing);
+
+  const char *reconstructionNames[3] = {"reconstructMM",
+                                        "reconstructWENO5",
+                                        "reconstructPPM"
+                                       };
+  for (int method=0; method < 3; method++)
+  {
+    timing.name  = std::string("reconstruction::")
+                   + reconstructionNames[method];
+    timing.time  = timeKernel(numEvals, [&]()
+      {
+        for (int dir=directions::X1; dir < directions::X1 + numDirections;
+             dir++
+            )
+        {
+          switch (method)
+          {
+            case 0:
+              reconstruction::reconstructMM(*primOld, dir,
+                                            *primLeft, *primRight
+                                           );
+              break;
+            case 1:
+              reconstruction::reconstructWENO5(*primOld, dir,
+                                               *primLeft, *primRight
+                                              );
+              break;
+            case 2:
+              reconstruction::reconstructPPM(*primOld, dir,
+                                             *primLeft, *primRight
+                                            );
+              break;
+          }
+          evalArrays(numVars, primLeft->vars);
+          evalArrays(numVars, primRight->vars);
+        }
+      });
+    timing.bytes = numDirections*3.*primBytes;
+    timings.push_back(timing);
+  }
+
+  /* The Riemann solver reads the last reconstruction */
+  timing.name  = "riemannSolver::solve";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      for (int dir=directions::X1; dir < directions::X1 + numDirections;
+           dir++
+          )
+      {
+        riemann->solve(*primLeft, *primRight,
+                       *geomFaces[dir - directions::X1],
+                       dir, *fluxes[dir - directions::X1]
+                      );
+        evalArrays(numVars, fluxes[dir - directions::X1]->vars);
+      }
+    });
+  timing.bytes = 0.;
+  for (int dir=0; dir < numDirections; dir++)
+  {
+    timing.bytes += 3.*primBytes + geometryBytes(*geomFaces[dir]);
+  }
+  timings.push_back(timing);
+
+  /* Diagonally dominant systems of the shape of the Jacobian, in the Array of
+   * Structs layout that solve() passes */
+  const int numFluidVars = residual->numVars;
+  array A =   af::randu(numFluidVars*numFluidVars,
+                        residual->N1Total, residual->N2Total, residual->N3Total,
+                        f64
+                       )
+            + numFluidVars*af::tile(af::flat(af::identity(numFluidVars,
+                                                          numFluidVars,
+                                                          f64
+                                                         )
+                                            ),
+                                    1, residual->N1Total, residual->N2Total,
+                                    residual->N3Total
+                                   );
+  array b = af::randu(numFluidVars,
+                      residual->N1Total, residual->N2Total, residual->N3Total,
+                      f64
+                     );
+  A.eval();
+  b.eval();
+
+  const int linearSolverSaved = params::linearSolver;
+  const int linearSolverTypes[2] = {linearSolvers::CPU_BATCH_SOLVER,
+                                    linearSolvers::GPU_BATCH_SOLVER
+                                   };
+  const char *linearSolverNames[2] = {"batchLinearSolve CPU",
+                                      "batchLinearSolve GPU"
+                                     };
+  for (int solver=0; solver < 2; solver++)
+  {
+    params::linearSolver = linearSolverTypes[solver];
+    timing.name  = linearSolverNames[solver];
+    timing.time  = timeKernel(numEvals, [&]()
+      {
+        batchLinearSolve(A, b, deltaPrimAoS);
+        deltaPrimAoS.eval();
+      });
+    timing.bytes = A.bytes() + b.bytes() + deltaPrimAoS.bytes();
+    timings.push_back(timing);
+  }
+  params::linearSolver = linearSolverSaved;
+
+  /* As in benchmarkIdealSolver(): invert cons starting from primHalfStep */
+  for (int solverVersion=0; solverVersion < 2; solverVersion++)
+  {
+    timing.name  = solverVersion == 0 ? "idealSolverFixedIter" : "idealSolver";
+    timing.time  = timeKernel(numEvals, [&]()
+      {
+        for (int var=0; var < numVars; var++)
+        {
+          primGuessPlusEps->vars[var] = primHalfStep->vars[var];
+        }
+        if (solverVersion == 0)
+        {
+          idealSolverFixedIter(*primGuessPlusEps);
+        }
+        else
+        {
+          idealSolver(*primGuessPlusEps);
+        }
+      });
+    timing.bytes =   3.*profiler::arrayBytes(vars::U3+1, primHalfStep->vars)
+                   + profiler::arrayBytes(3, &primHalfStep->vars[vars::B1]);
+    timings.push_back(timing);
+  }
+
+  /* Only the ghost zones are written, from (at most) as many bulk zones */
+  const double numZones      = prim->N1Total * prim->N2Total * prim->N3Total;
+  const double numLocalZones = prim->N1Local * prim->N2Local * prim->N3Local;
+  const double ghostBytes    =   2.*(numZones - numLocalZones)/numZones
+                               * primBytes;
+
+  timing.name  = "applyBoundaryConditions";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      boundaries::applyBoundaryConditions(boundaryLeft, boundaryRight,
+                                          boundaryTop,  boundaryBottom,
+                                          boundaryFront, boundaryBack,
+                                          *primOld
+                                         );
+      evalArrays(numVars, primOld->vars);
+    });
+  timing.bytes = ghostBytes;
+  timings.push_back(timing);
+
+  timing.name  = "grid::communicate";
+  timing.time  = timeKernel(numEvals, [&]()
+    {
+      primOld->communicate();
+    });
+  timing.bytes = ghostBytes;
+  timings.push_back(timing);
+
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+  PetscPrintf(PETSC_COMM_WORLD, "    ---Kernel benchmark: %i x %i x %i, dim %i--- \n",
+                                 N1, N2, N3, dim
+             );
+  for (int n=0; n < timings.size(); n++)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "     %-24s: %g zones/sec/proc, %g GB/sec\n",
+                                   timings[n].name.c_str(),
+                                   numZones/timings[n].time,
+                                   memoryBandwidth(timings[n].bytes,
+                                                   timings[n].time
+                                                  )
+               );
+  }
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+
+  if (world_rank == 0)
+  {
+    bool newFile = !std::ifstream(fileName.c_str()).good();
+    std::ofstream file(fileName.c_str(), std::ios::app);
+    if (newFile)
+    {
+      file << "kernel,dim,N1,N2,N3,procs,threads,evals,time,"
+           << "zonesPerSecPerProc,bandwidthPerProc\n";
+    }
+    file.precision(6);
+    file << std::scientific;
+    for (int n=0; n < timings.size(); n++)
+    {
+      file << timings[n].name << "," << dim << ","
+           << N1 << "," << N2 << "," << N3 << ","
+           << world_size << "," << omp_get_max_threads() << ","
+           << numEvals << "," << timings[n].time << ","
+           << numZones/timings[n].time << ","
+           << memoryBandwidth(timings[n].bytes, timings[n].time) << "\n";
+    }
+  }
+}
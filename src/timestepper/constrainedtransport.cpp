@@ -1,13 +1,10 @@
 #include "timestepper.hpp"
 
-void timeStepper::fluxCT(int &numReads,
-                         int &numWrites
-                        )
+void timeStepper::fluxCT()
 {
   if (fluxesX1->dim >= 2)
   {
-    int numReadsEMF, numWritesEMF;
-    computeEMF(numReadsEMF, numWritesEMF);
+    computeEMF();
 
     fluxesX1->vars[vars::B1] = 0.;
 
@@ -56,9 +53,7 @@ void timeStepper::fluxCT(int &numReads,
   }
 }
 
-void timeStepper::computeEMF(int &numReadsEMF,
-                             int &numWritesEMF
-                            )
+void timeStepper::computeEMF()
 {
   if (fluxesX1->dim >= 2)
   {
@@ -92,10 +87,7 @@ void timeStepper::computeEMF(int &numReadsEMF,
   }
 }
 
-void timeStepper::computeDivB(const grid &prim,
-                              int &numReads,
-                              int &numWrites
-                             )
+void timeStepper::computeDivB(const grid &prim)
 {
 
   array B1 = prim.vars[vars::B1];
@@ -1,13 +1,102 @@
 #include "timestepper.hpp"
+#include <omp.h>
 
-void timeStepper::computeDivOfFluxes(const grid &primFlux,
-                                     int &numReads,
-                                     int &numWrites
-                                    )
+void timeStepper::computeDivOfFluxes(const grid &primFlux)
 {
-  int numReadsReconstruction, numWritesReconstruction;
-  int numReadsRiemann, numWritesRiemann;
-  int numReadsCT, numWritesCT;
+
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    double dX[3];
+    dX[0] = XCoords->dX1;
+    dX[1] = XCoords->dX2;
+    dX[2] = XCoords->dX3;
+
+    if (params::tiledFluxes)
+    {
+      /* Reconstruction, Riemann solve and divergence tile by tile. Only the B
+       * fluxes are stored; their divergence is redone after CT. */
+      const geometry *geomFacesDir[3] = {geomFaces[0], geomFaces[1],
+                                         geomFaces[2]
+                                        };
+      const int tileSize[3] = {params::tileSizeX1,
+                               params::tileSizeX2,
+                               params::tileSizeX3
+                              };
+      grid *fluxes[3] = {fluxesX1, fluxesX2, fluxesX3};
+      PROFILE_BEGIN("tiles");
+      native::computeDivOfFluxesTiled(primFlux, geomFacesDir,
+                                      dX, tileSize, fluxes, *divFluxes
+                                     );
+      PROFILE_END();
+      if (primFlux.dim > 1)
+      {
+        PROFILE_BEGIN("flux CT");
+        fluxCT();
+        PROFILE_END();
+      }
+      PROFILE_BEGIN("flux filter");
+      applyProblemSpecificFluxFilter();
+      PROFILE_END();
+
+      PROFILE_BEGIN("divergence");
+      native::computeDivergence(*fluxesX1, *fluxesX2, *fluxesX3,
+                                dX, vars::B1, vars::B3, *divFluxes
+                               );
+      PROFILE_END();
+      return;
+    }
+
+    if (params::fluxTasks)
+    {
+      PROFILE_BEGIN("task graph");
+      computeDivOfFluxesTasks(primFlux, dX);
+      PROFILE_END();
+      return;
+    }
+
+    /* Fused reconstruction + Riemann solve per direction. CT and the flux
+     * filter stay on ArrayFire. */
+    PROFILE_BEGIN("native fluxes");
+    native::computeFluxes(primFlux, directions::X1,
+                          *geomFaces[directions::X1], *fluxesX1
+                         );
+    PROFILE_END();
+    if (primFlux.dim > 1)
+    {
+      PROFILE_BEGIN("native fluxes");
+      native::computeFluxes(primFlux, directions::X2,
+                            *geomFaces[directions::X2], *fluxesX2
+                           );
+      PROFILE_END();
+    }
+    if (primFlux.dim > 2)
+    {
+      PROFILE_BEGIN("native fluxes");
+      native::computeFluxes(primFlux, directions::X3,
+                            *geomFaces[directions::X3], *fluxesX3
+                           );
+      PROFILE_END();
+    }
+
+    if (primFlux.dim > 1)
+    {
+      PROFILE_BEGIN("flux CT");
+      fluxCT();
+      PROFILE_END();
+    }
+    PROFILE_BEGIN("flux filter");
+    applyProblemSpecificFluxFilter();
+    PROFILE_END();
+
+    PROFILE_BEGIN("divergence");
+    native::computeDivergence(*fluxesX1, *fluxesX2, *fluxesX3,
+                              dX, 0, native::NUM_IDEAL_VARS-1, *divFluxes
+                             );
+    PROFILE_END();
+    return;
+  }
+#endif
 
   switch (primFlux.dim)
   {
@@ -15,24 +104,24 @@ void timeStepper::computeDivOfFluxes(const grid &primFlux,
     /* Reconstruction gives, at a point of index i:
      * primLeft : right-biased stencil reconstructs on face i-/1.2
      * primRight: left-biased stencil reconstructs on face i+1/2 */
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X1,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      numReads  = numReadsReconstruction;
-      numWrites = numWritesReconstruction;
+      PROFILE_END();
 
+      PROFILE_BEGIN("riemann");
       riemann->solve(*primLeft, *primRight,
-                     *geomLeft, *geomRight,
-                     directions::X1, *fluxesX1,
-                     numReadsRiemann, numWritesRiemann
+                     *geomFaces[directions::X1],
+                     directions::X1, *fluxesX1
                     );
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
+      PROFILE_END();
 
-      applyProblemSpecificFluxFilter(numReads,numWrites);
+      PROFILE_BEGIN("flux filter");
+      applyProblemSpecificFluxFilter();
+      PROFILE_END();
 
+      PROFILE_BEGIN("divergence");
       for (int var=0; var < primFlux.numVars; var++)
       {
         double filter1D[] = {1, -1, 0}; /* Forward difference */
@@ -44,51 +133,49 @@ void timeStepper::computeDivOfFluxes(const grid &primFlux,
         divFluxes->vars[var] = dFluxX1_dX1;
         divFluxes->vars[var].eval();
       }
+      PROFILE_END();
 
       break;
 
     case 2:
 
       /* directions:: X1 */
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X1,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      numReads  = numReadsReconstruction;
-      numWrites = numWritesReconstruction;
+      PROFILE_END();
 
+      PROFILE_BEGIN("riemann");
       riemann->solve(*primLeft, *primRight,
-                     *geomLeft, *geomRight,
-                     directions::X1, *fluxesX1,
-                     numReadsRiemann, numWritesRiemann
+                     *geomFaces[directions::X1],
+                     directions::X1, *fluxesX1
                     );
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
+      PROFILE_END();
 
       /* directions:: X2 */
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X2,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      numReads  += numReadsReconstruction;
-      numWrites += numWritesReconstruction;
+      PROFILE_END();
 
-      riemann->solve(*primLeft,   *primRight,
-                     *geomBottom, *geomTop,
-                     directions::X2, *fluxesX2,
-                     numReadsRiemann, numWritesRiemann
+      PROFILE_BEGIN("riemann");
+      riemann->solve(*primLeft, *primRight,
+                     *geomFaces[directions::X2],
+                     directions::X2, *fluxesX2
                     );
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
+      PROFILE_END();
 
-      fluxCT(numReadsCT, numWritesCT);
-      numReads  += numReadsCT;
-      numWrites += numWritesCT;
+      PROFILE_BEGIN("flux CT");
+      fluxCT();
+      PROFILE_END();
 
-      applyProblemSpecificFluxFilter(numReads,numWrites);
+      PROFILE_BEGIN("flux filter");
+      applyProblemSpecificFluxFilter();
+      PROFILE_END();
 
+      PROFILE_BEGIN("divergence");
       for (int var=0; var < primFlux.numVars; var++)
       {
         double filter1D[] = {1, -1, 0}; /* Forward difference */
@@ -102,105 +189,62 @@ void timeStepper::computeDivOfFluxes(const grid &primFlux,
         divFluxes->vars[var] = dFluxX1_dX1 + dFluxX2_dX2;
         divFluxes->vars[var].eval();
       }
+      PROFILE_END();
 
       break;
 
     case 3:
-      double reconstructTime = 0.;
-      double riemannSolveTime = 0.;
-      double fluxCTTime = 0.;
-      double fluxFilterTime = 0.;
-
       /* directions:: X1 */
-      af::timer reconstructTimer = af::timer::start();
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X1,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      af::sync();
-      reconstructTime += af::timer::stop(reconstructTimer);
-      numReads  = numReadsReconstruction;
-      numWrites = numWritesReconstruction;
+      PROFILE_END();
 
-      af::timer riemannSolveTimer = af::timer::start();
+      PROFILE_BEGIN("riemann");
       riemann->solve(*primLeft, *primRight,
-                     *geomLeft, *geomRight,
-                     directions::X1, *fluxesX1,
-                     numReadsRiemann, numWritesRiemann
+                     *geomFaces[directions::X1],
+                     directions::X1, *fluxesX1
                     );
-      af::sync();
-      riemannSolveTime += af::timer::stop(riemannSolveTimer);
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
+      PROFILE_END();
 
       /* directions:: X2 */
-      reconstructTimer = af::timer::start();
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X2,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      af::sync();
-      reconstructTime += af::timer::stop(reconstructTimer);
-      numReads  += numReadsReconstruction;
-      numWrites += numWritesReconstruction;
-
-      riemannSolveTimer = af::timer::start();
-      riemann->solve(*primLeft,   *primRight,
-                     *geomBottom, *geomTop,
-                     directions::X2, *fluxesX2,
-                     numReadsRiemann, numWritesRiemann
+      PROFILE_END();
+
+      PROFILE_BEGIN("riemann");
+      riemann->solve(*primLeft, *primRight,
+                     *geomFaces[directions::X2],
+                     directions::X2, *fluxesX2
                     );
-      af::sync();
-      riemannSolveTime += af::timer::stop(riemannSolveTimer);
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
+      PROFILE_END();
 
       /* directions:: X3 */
-      reconstructTimer = af::timer::start();
+      PROFILE_BEGIN("reconstruct");
       reconstruction::reconstruct(primFlux, directions::X3,
-                                  *primLeft, *primRight,
-                                  numReadsReconstruction,
-                                  numWritesReconstruction
+                                  *primLeft, *primRight
                                  );
-      af::sync();
-      reconstructTime += af::timer::stop(reconstructTimer);
-      numReads  += numReadsReconstruction;
-      numWrites += numWritesReconstruction;
-
-      riemannSolveTimer = af::timer::start();
-      riemann->solve(*primLeft,   *primRight,
-                     *geomCenter, *geomCenter,
-                     directions::X3, *fluxesX3,
-                     numReadsRiemann, numWritesRiemann
+      PROFILE_END();
+
+      PROFILE_BEGIN("riemann");
+      riemann->solve(*primLeft, *primRight,
+                     *geomFaces[directions::X3],
+                     directions::X3, *fluxesX3
                     );
-      af::sync();
-      riemannSolveTime += af::timer::stop(riemannSolveTimer);
-      numReads  += numReadsRiemann;
-      numWrites += numWritesRiemann;
-
-      af::timer fluxCTTimer = af::timer::start();
-      fluxCT(numReadsCT, numWritesCT);
-      af::sync();
-      fluxCTTime += af::timer::stop(fluxCTTimer);
-      numReads  += numReadsCT;
-      numWrites += numWritesCT;
-
-      af::timer fluxFilterTimer = af::timer::start();
-      applyProblemSpecificFluxFilter(numReads,numWrites);
-      af::sync();
-      fluxFilterTime += af::timer::stop(fluxFilterTimer);
-
-      PetscPrintf(PETSC_COMM_WORLD, "       reconstruct  : %g secs %\n",    
-        reconstructTime); 
-      PetscPrintf(PETSC_COMM_WORLD, "       Riemann      : %g secs %\n",    
-        riemannSolveTime); 
-      PetscPrintf(PETSC_COMM_WORLD, "       Flux CT      : %g secs %\n",    
-        fluxCTTime); 
-      PetscPrintf(PETSC_COMM_WORLD, "       Filter  : %g secs %\n",    
-        fluxFilterTime); 
+      PROFILE_END();
+
+      PROFILE_BEGIN("flux CT");
+      fluxCT();
+      PROFILE_END();
+
+      PROFILE_BEGIN("flux filter");
+      applyProblemSpecificFluxFilter();
+      PROFILE_END();
 
+      PROFILE_BEGIN("divergence");
       std::vector<af::array *> arraysThatNeedEval{};
       for (int var=0; var < primFlux.numVars; var++)
       {
@@ -218,9 +262,216 @@ void timeStepper::computeDivOfFluxes(const grid &primFlux,
         //divFluxes->vars[var].eval();
         arraysThatNeedEval.push_back(&divFluxes->vars[var]);
       }
+      PROFILE_BYTES(  profiler::arrayBytes(arraysThatNeedEval)
+                    + profiler::arrayBytes(primFlux.numVars, fluxesX1->vars)
+                    + profiler::arrayBytes(primFlux.numVars, fluxesX2->vars)
+                    + profiler::arrayBytes(primFlux.numVars, fluxesX3->vars)
+                   );
       af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
+      PROFILE_END();
 
       break;
   }
 }
 
+
+#ifdef GRIM_NATIVE_BACKEND
+/* Native fluxes as a task graph. Each direction is split into blocks of
+ * params::linesPerTask pencils, and the blocks of all directions run
+ * concurrently. CT waits on the fluxes of every direction, since in 3D it
+ * rewrites the X3 B fluxes; the flux filter and the divergence wait on CT.
+ * The OpenMP runtime schedules the tasks. */
+void timeStepper::computeDivOfFluxesTasks(const grid &primFlux,
+                                          const double dX[3]
+                                         )
+{
+  const int dim = primFlux.dim;
+  grid *fluxes[3] = {fluxesX1, fluxesX2, fluxesX3};
+  const int linesPerTask = std::max(1, params::linesPerTask);
+
+  native::hostArrays host[3];
+  native::fluxPencils pencils[3];
+  for (int d=0; d < dim; d++)
+  {
+    native::setupFluxPencils(primFlux, d, *geomFaces[d],
+                             *fluxes[d], host[d], pencils[d]
+                            );
+  }
+  native::hostArrays hostDiv;
+  native::divergenceRows rows;
+
+  /* Per-thread scratch and busy time. Tasks that use the scratch have no
+   * scheduling points, so a thread never runs two of them at once. */
+  const int numThreads = omp_get_max_threads();
+  std::vector<native::pencilScratch> scratch(numThreads);
+  std::vector< std::vector<double> > faceFluxes(numThreads);
+  std::vector<double> busyTime(numThreads, 0.);
+
+  /* Dependency tokens */
+  int fluxesDone[3], fluxCTDone;
+
+  double startTime = omp_get_wtime();
+  #pragma omp parallel
+  #pragma omp single
+  {
+    for (int d=0; d < dim; d++)
+    {
+      #pragma omp task firstprivate(d) depend(out: fluxesDone[d])
+      {
+        for (int lineStart=0; lineStart < pencils[d].numLines;
+             lineStart += linesPerTask
+            )
+        {
+          #pragma omp task firstprivate(d, lineStart)
+          {
+            int thread = omp_get_thread_num();
+            double taskStart = omp_get_wtime();
+            native::computeFluxPencils(pencils[d], lineStart,
+                                       std::min(lineStart + linesPerTask,
+                                                pencils[d].numLines
+                                               ),
+                                       scratch[thread], faceFluxes[thread]
+                                      );
+            double taskTime = omp_get_wtime() - taskStart;
+            busyTime[thread] += taskTime;
+            threads::addThreadTime(taskTime);
+          }
+        }
+        #pragma omp taskwait
+        host[d].release();
+      }
+    }
+
+    /* CT reads the B fluxes of every direction, and in 3D also rewrites
+     * those of X3, which release() would otherwise overwrite. Tokens of
+     * directions beyond dim have no task and are satisfied at once. */
+    #pragma omp task depend(in: fluxesDone[0], fluxesDone[1], fluxesDone[2]) \
+                     depend(out: fluxCTDone)
+    {
+      int thread = omp_get_thread_num();
+      double taskStart = omp_get_wtime();
+      if (dim > 1)
+      {
+        fluxCT();
+        af::sync();
+      }
+      double taskTime = omp_get_wtime() - taskStart;
+      busyTime[thread] += taskTime;
+      threads::addThreadTime(taskTime);
+    }
+
+    #pragma omp task depend(in: fluxesDone[0], fluxesDone[1], fluxesDone[2], \
+                                fluxCTDone)
+    {
+      int thread = omp_get_thread_num();
+      double taskStart = omp_get_wtime();
+      applyProblemSpecificFluxFilter();
+      native::setupDivergence(*fluxesX1, *fluxesX2, *fluxesX3, dX,
+                              0, native::NUM_IDEAL_VARS-1, *divFluxes,
+                              hostDiv, rows
+                             );
+      double taskTime = omp_get_wtime() - taskStart;
+      busyTime[thread] += taskTime;
+      threads::addThreadTime(taskTime);
+
+      for (int rowStart=0; rowStart < rows.numRows; rowStart += linesPerTask)
+      {
+        #pragma omp task firstprivate(rowStart)
+        {
+          int thread = omp_get_thread_num();
+          double taskStart = omp_get_wtime();
+          native::computeDivergenceRows(rows, rowStart,
+                                        std::min(rowStart + linesPerTask,
+                                                 rows.numRows
+                                                )
+                                       );
+          double taskTime = omp_get_wtime() - taskStart;
+          busyTime[thread] += taskTime;
+          threads::addThreadTime(taskTime);
+        }
+      }
+    }
+  }
+  double wallTime = omp_get_wtime() - startTime;
+  hostDiv.release();
+
+  double totalBusyTime = 0.;
+  for (int thread=0; thread < numThreads; thread++)
+  {
+    totalBusyTime += busyTime[thread];
+  }
+  fluxTaskUtilization = totalBusyTime/(numThreads*wallTime);
+}
+#endif
+
+void timeStepper::benchmarkFluxTiles(const int numEvals)
+{
+  if (!useNativeBackend)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  Flux tiling benchmark needs the native backend, skipping\n"
+               );
+    return;
+  }
+
+#ifdef GRIM_NATIVE_BACKEND
+  /* Bytes per zone that each version has to move: prim and the face metric
+   * (alpha, g, gCov, gCon) per direction, the stored fluxes, and the
+   * divergence. CT is common to both and not counted. */
+  const double numVarsIdeal = native::NUM_IDEAL_VARS;
+  const double numGeomVars  = 2 + 2*NDIM*NDIM;
+  const double numVarsB     = vars::B3 - vars::B1 + 1;
+  const double bytesPerZone[2] =
+    {sizeof(double)*(  dim*(numVarsIdeal + numGeomVars) + dim*numVarsIdeal
+                     + dim*numVarsIdeal + numVarsIdeal
+                    ),
+     sizeof(double)*(  dim*(numVarsIdeal + numGeomVars) + dim*numVarsB
+                     + dim*numVarsB + numVarsIdeal + numVarsB
+                    )
+    };
+
+  const int tiledFluxesSaved = params::tiledFluxes;
+  double timeElapsed[2];
+  for (int version=0; version < 2; version++)
+  {
+    params::tiledFluxes = version;
+
+    af::sync();
+    af::timer benchmarkTimer = af::timer::start();
+    for (int n=0; n < numEvals; n++)
+    {
+      computeDivOfFluxes(*primOld);
+    }
+    af::sync();
+    timeElapsed[version] = af::timer::stop(benchmarkTimer);
+  }
+  params::tiledFluxes = tiledFluxesSaved;
+
+  double numZones = prim->N1Total * prim->N2Total * prim->N3Total;
+  double availableBandwidth = bandwidthTest(1000);
+
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+  PetscPrintf(PETSC_COMM_WORLD, "    ---Flux tiling benchmark--- \n");
+  PetscPrintf(PETSC_COMM_WORLD, "     Tile size           : %i x %i x %i\n",
+                                 params::tileSizeX1,
+                                 params::tileSizeX2,
+                                 params::tileSizeX3
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "     Pencils             : %g zones/sec/proc, %g GB/sec\n",
+                                 numZones*numEvals/timeElapsed[0],
+                                 memoryBandwidth(bytesPerZone[0]*numZones*numEvals,
+                                                 timeElapsed[0]
+                                                )
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "     Tiles               : %g zones/sec/proc, %g GB/sec\n",
+                                 numZones*numEvals/timeElapsed[1],
+                                 memoryBandwidth(bytesPerZone[1]*numZones*numEvals,
+                                                 timeElapsed[1]
+                                                )
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "     Memory Bandwidth    : %g GB/sec\n",
+                                 availableBandwidth
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+#endif
+}
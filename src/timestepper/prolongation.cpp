@@ -0,0 +1,509 @@
+#include "timestepper.hpp"
+#include <cmath>
+
+/* Restart onto a grid of another resolution, see prolongRestart() */
+
+/* Source zone i covers the fraction weight of a zone of the new grid, with
+ * the middle of the overlap at offset from the center of i, in units of
+ * source zones */
+struct zoneOverlap
+{
+  int i;
+  double weight, offset;
+};
+
+/* Source zones, out of sourceN, overlapping zone I out of N on the same
+ * interval */
+static void zoneOverlaps(const int sourceN, const int N, const int I,
+                         std::vector<zoneOverlap> &overlaps
+                        )
+{
+  const double ratio = sourceN/(double) N;
+  const double start = I*ratio;
+  const double end   = (I + 1)*ratio;
+
+  overlaps.clear();
+  for (int i=(int) floor(start); i < sourceN && i < end; i++)
+  {
+    const double left  = std::max(start, (double) i);
+    const double right = std::min(end, i + 1.);
+    if (right - left <= 1.e-12*ratio)
+    {
+      continue;
+    }
+    zoneOverlap overlap;
+    overlap.i      = i;
+    overlap.weight = (right - left)/ratio;
+    overlap.offset = 0.5*(left + right) - (i + 0.5);
+    overlaps.push_back(overlap);
+  }
+}
+
+/* Minmod slope, per source zone, of zone along a direction with n zones */
+static double limitedSlope(const std::vector<double> &values,
+                           const int zone, const int stride,
+                           const int i, const int n
+                          )
+{
+  if (i == 0 || i == n-1)
+  {
+    return 0.;
+  }
+  const double left  = values[zone] - values[zone - stride];
+  const double right = values[zone + stride] - values[zone];
+  if (left*right <= 0.)
+  {
+    return 0.;
+  }
+  return (fabs(left) < fabs(right)) ? left : right;
+}
+
+/* Weights of cubic (fewer points if n < 4) Lagrange interpolation at lattice
+ * coordinate t on a lattice of n points, from point base on. Returns the
+ * number of points. */
+static int lagrangeStencil(const double t, const int n,
+                           int &base, double weights[4]
+                          )
+{
+  const int numPoints = std::min(4, n);
+  base = (int) floor(t) - (numPoints - 1)/2;
+  base = std::max(0, std::min(base, n - numPoints));
+
+  for (int m=0; m < numPoints; m++)
+  {
+    weights[m] = 1.;
+    for (int l=0; l < numPoints; l++)
+    {
+      if (l != m)
+      {
+        weights[m] *= (t - (base + l))/(double) (m - l);
+      }
+    }
+  }
+  return numPoints;
+}
+
+/* Interpolates a lattice of m[0] x m[1] x m[2] points, X1 fastest, to the
+ * corners of the local zones of the new grid. Lattice point i is at
+ * (i + latticeStart) source zones from the start of the domain in each
+ * direction. */
+static void interpolateToCorners(const std::vector<double> &lattice,
+                                 const int m[3],
+                                 const double latticeStart[3],
+                                 const int n[3], const int N[3],
+                                 const int cornerStart[3],
+                                 const int numCorners[3],
+                                 std::vector<double> &corners
+                                )
+{
+  corners.resize(numCorners[0]*numCorners[1]*numCorners[2]);
+
+  for (int kc=0; kc < numCorners[2]; kc++)
+  {
+    for (int jc=0; jc < numCorners[1]; jc++)
+    {
+      for (int ic=0; ic < numCorners[0]; ic++)
+      {
+        const int corner[3] = {ic, jc, kc};
+        int base[3], numPoints[3];
+        double weights[3][4];
+        for (int d=0; d < 3; d++)
+        {
+          const double t = (cornerStart[d] + corner[d])*n[d]/(double) N[d]
+                         - latticeStart[d];
+          numPoints[d] = lagrangeStencil(t, m[d], base[d], weights[d]);
+        }
+
+        double value = 0.;
+        for (int c=0; c < numPoints[2]; c++)
+        {
+          for (int b=0; b < numPoints[1]; b++)
+          {
+            for (int a=0; a < numPoints[0]; a++)
+            {
+              value +=  weights[0][a]*weights[1][b]*weights[2][c]
+                      * lattice[  base[0] + a
+                                + m[0]*(base[1] + b + m[1]*(base[2] + c))
+                               ];
+            }
+          }
+        }
+        corners[ic + numCorners[0]*(jc + numCorners[1]*kc)] = value;
+      }
+    }
+  }
+}
+
+/* Difference along dir across local zone (i, j, k) of a corner centered
+ * field, averaged over the other directions */
+static double cornerDifference(const std::vector<double> &corners,
+                               const int numCorners[3], const int dim,
+                               const int i, const int j, const int k,
+                               const int dir
+                              )
+{
+  double difference = 0.;
+  const int numOffsets[3] = {2, dim > 1 ? 2 : 1, dim > 2 ? 2 : 1};
+  for (int c=0; c < numOffsets[2]; c++)
+  {
+    for (int b=0; b < numOffsets[1]; b++)
+    {
+      for (int a=0; a < numOffsets[0]; a++)
+      {
+        const int offset[3] = {a, b, c};
+        const double sign = offset[dir] ? 1. : -1.;
+        difference +=  sign
+                     * corners[  i + a
+                               + numCorners[0]*(j + b + numCorners[1]*(k + c))
+                              ];
+      }
+    }
+  }
+  return difference/(1 << (dim - 1));
+}
+
+/* Fills primOld from a checkpoint of sourceN zones. Every rank gathers the
+ * whole checkpoint, one variable at a time, so the source grid has to fit in
+ * the memory of a rank.
+ *
+ * The fluid variables (and B3 in 2D) are the averages, over each new zone,
+ * of the minmod limited piecewise linear reconstruction of the checkpoint.
+ * Conservative here means that the integrals of the primitives themselves
+ * over the logical volume, sum of prim*dX1*dX2*dX3, are unchanged for any
+ * ratio of resolutions; the conserved variables (rho u^t sqrt(-g) and the
+ * others) are not, as they are nonlinear in the primitives. The new values
+ * also stay within the range of their neighbours.
+ *
+ * The magnetic field goes through a vector potential, so that the new field
+ * has zero divergence in the corner stencil of computeDivB() and fluxCT().
+ * In that stencil, divB at the corners of the zones is the divergence on the
+ * dual grid, whose zones are centered at the corners, of the face fluxes
+ * Phi1_(i, j-1/2, k-1/2) = <g B1> averaged over the zones around the face.
+ * For a divergence free checkpoint these are the curl of a potential on the
+ * dual edges, found by integrating along lines in the gauge A3 = 0 (A3 = psi,
+ * with A1 = A2 = 0, in 2D). The potential is smooth: interpolated to the
+ * corners of the new zones, its curl in the averaged difference stencil is
+ * divergence free in the same stencil, as the differences and averages along
+ * different directions commute. */
+void timeStepper::prolongRestart(const std::string fileName,
+                                 const int sourceN[3]
+                                )
+{
+  const int N[3] = {primOld->N1, primOld->N2, primOld->N3};
+  int n[3];
+  for (int d=0; d < 3; d++)
+  {
+    n[d] = (d < dim) ? sourceN[d] : 1;
+  }
+  PetscPrintf(PETSC_COMM_WORLD,
+              "\n  Prolonging %s from %d x %d x %d to %d x %d x %d zones\n",
+              fileName.c_str(), n[0], n[1], n[2], N[0], N[1], N[2]
+             );
+
+  const bool preserveDivB = (dim >= 2);
+
+  /* The source grid with PETSc's even split: the ownership ranges are for
+   * this run's grid */
+  std::vector<PetscInt> runRanges[3];
+  for (int d=0; d < 3; d++)
+  {
+    runRanges[d].swap(grid::ownershipRanges[d]);
+  }
+  grid *source = new grid(n[0], n[1], n[2],
+                          dim, numVars, numGhost,
+                          primOld->periodicBoundariesX1,
+                          primOld->periodicBoundariesX2,
+                          primOld->periodicBoundariesX3
+                         );
+  source->load("primitives", fileName);
+  if (preserveDivB)
+  {
+    coordinatesGrid sourceXCoords(n[0], n[1], n[2],
+                                  dim, numGhost,
+                                  XCoords->X1Start, XCoords->X1End,
+                                  XCoords->X2Start, XCoords->X2End,
+                                  XCoords->X3Start, XCoords->X3End
+                                 );
+    sourceXCoords.setXCoords(locations::CENTER);
+    geometry sourceGeom(geomCenter->metric,
+                        geomCenter->blackHoleSpin,
+                        geomCenter->hSlope,
+                        sourceXCoords
+                       );
+    for (int var=vars::B1; var <= vars::B3; var++)
+    {
+      source->vars[var] = sourceGeom.g*source->vars[var];
+    }
+  }
+  for (int d=0; d < 3; d++)
+  {
+    runRanges[d].swap(grid::ownershipRanges[d]);
+  }
+
+  const int NLocal[3]     = {primOld->N1Local, primOld->N2Local,
+                             primOld->N3Local
+                            };
+  const int localStart[3] = {primOld->iLocalStart, primOld->jLocalStart,
+                             primOld->kLocalStart
+                            };
+  const int NTotal[3]     = {primOld->N1Total, primOld->N2Total,
+                             primOld->N3Total
+                            };
+  const int numGhostX[3]  = {primOld->numGhostX1, primOld->numGhostX2,
+                             primOld->numGhostX3
+                            };
+  const af::dim4 dims = primOld->vars[0].dims();
+
+  std::vector<std::vector<zoneOverlap> > overlaps[3];
+  for (int d=0; d < 3; d++)
+  {
+    overlaps[d].resize(NLocal[d]);
+    for (int I=0; I < NLocal[d]; I++)
+    {
+      zoneOverlaps(n[d], N[d], localStart[d] + I, overlaps[d][I]);
+    }
+  }
+  const int sourceStride[3] = {1, n[0], n[0]*n[1]};
+
+  std::vector<double> values, slopes[3];
+  std::vector<double> newValues(NTotal[0]*NTotal[1]*NTotal[2], 0.);
+  for (int var=0; var < numVars; var++)
+  {
+    if (preserveDivB && var >= vars::B1 && var < vars::B1 + dim)
+    {
+      continue;
+    }
+
+    source->gatherToAll(var, values);
+    for (int d=0; d < 3; d++)
+    {
+      slopes[d].resize(values.size());
+    }
+    for (int k=0; k < n[2]; k++)
+    {
+      for (int j=0; j < n[1]; j++)
+      {
+        for (int i=0; i < n[0]; i++)
+        {
+          const int zone = i + n[0]*(j + n[1]*k);
+          const int index[3] = {i, j, k};
+          for (int d=0; d < 3; d++)
+          {
+            slopes[d][zone] = limitedSlope(values, zone, sourceStride[d],
+                                           index[d], n[d]
+                                          );
+          }
+        }
+      }
+    }
+
+    for (int k=0; k < NLocal[2]; k++)
+    {
+      for (int j=0; j < NLocal[1]; j++)
+      {
+        for (int i=0; i < NLocal[0]; i++)
+        {
+          double value = 0.;
+          for (int c=0; c < overlaps[2][k].size(); c++)
+          {
+            const zoneOverlap &oc = overlaps[2][k][c];
+            for (int b=0; b < overlaps[1][j].size(); b++)
+            {
+              const zoneOverlap &ob = overlaps[1][j][b];
+              for (int a=0; a < overlaps[0][i].size(); a++)
+              {
+                const zoneOverlap &oa = overlaps[0][i][a];
+                const int zone = oa.i + n[0]*(ob.i + n[1]*oc.i);
+                value +=  oa.weight*ob.weight*oc.weight
+                        * (  values[zone]
+                           + slopes[0][zone]*oa.offset
+                           + slopes[1][zone]*ob.offset
+                           + slopes[2][zone]*oc.offset
+                          );
+              }
+            }
+          }
+          newValues[  i + numGhostX[0]
+                    + NTotal[0]*(  j + numGhostX[1]
+                                 + NTotal[1]*(k + numGhostX[2])
+                                )
+                   ] = value;
+        }
+      }
+    }
+    primOld->vars[var] = array(dims, &newValues[0]);
+  }
+
+  if (preserveDivB)
+  {
+    std::vector<double> gB[3];
+    for (int d=0; d < dim; d++)
+    {
+      source->gatherToAll(vars::B1 + d, gB[d]);
+    }
+    const double h[3] = {(XCoords->X1End - XCoords->X1Start)/n[0],
+                         (XCoords->X2End - XCoords->X2Start)/n[1],
+                         (XCoords->X3End - XCoords->X3Start)/n[2]
+                        };
+    const double H[3] = {XCoords->dX1, XCoords->dX2, XCoords->dX3};
+
+    int numCorners[3];
+    for (int d=0; d < 3; d++)
+    {
+      numCorners[d] = (d < dim) ? NLocal[d] + 1 : 1;
+    }
+
+    /* Potential on the source grid, and at the corners of the new zones */
+    std::vector<double> A[3], ACorners[3];
+    #define SOURCE_ZONE(i, j, k) ((i) + n[0]*((j) + n[1]*(k)))
+    if (dim == 2)
+    {
+      /* psi at the zone centers, Phi1 = dpsi/dX2, Phi2 = -dpsi/dX1 */
+      std::vector<double> &psi = A[2];
+      psi.assign(n[0]*n[1], 0.);
+      for (int i=1; i < n[0]; i++)
+      {
+        psi[i] = psi[i-1] - h[0]*0.5*(gB[1][i] + gB[1][i-1]);
+      }
+      for (int j=1; j < n[1]; j++)
+      {
+        for (int i=0; i < n[0]; i++)
+        {
+          psi[SOURCE_ZONE(i, j, 0)] =
+              psi[SOURCE_ZONE(i, j-1, 0)]
+            + h[1]*0.5*(gB[0][SOURCE_ZONE(i, j, 0)]
+                        + gB[0][SOURCE_ZONE(i, j-1, 0)]
+                       );
+        }
+      }
+      const int m[3] = {n[0], n[1], 1};
+      const double latticeStart[3] = {0.5, 0.5, 0.};
+      interpolateToCorners(psi, m, latticeStart, n, N, localStart,
+                           numCorners, ACorners[2]
+                          );
+    }
+    else
+    {
+      /* A1 on the dual X1 edges (i-1/2, j, k), i = 1..n1-1, and A2 on
+       * (i, j-1/2, k). A1 = 0 and Phi3 = dA2/dX1 on k = 0, then
+       * Phi1 = -dA2/dX3 and Phi2 = dA1/dX3. */
+      const int m1[3] = {n[0]-1, n[1], n[2]};
+      const int m2[3] = {n[0], n[1]-1, n[2]};
+      A[0].assign(m1[0]*m1[1]*m1[2], 0.);
+      A[1].assign(m2[0]*m2[1]*m2[2], 0.);
+      #define A1_INDEX(i, j, k) ((i) - 1 + m1[0]*((j) + m1[1]*(k)))
+      #define A2_INDEX(i, j, k) ((i) + m2[0]*((j) - 1 + m2[1]*(k)))
+
+      for (int j=1; j < n[1]; j++)
+      {
+        for (int i=1; i < n[0]; i++)
+        {
+          const double Phi3 = 0.25*(  gB[2][SOURCE_ZONE(i,   j,   0)]
+                                    + gB[2][SOURCE_ZONE(i-1, j,   0)]
+                                    + gB[2][SOURCE_ZONE(i,   j-1, 0)]
+                                    + gB[2][SOURCE_ZONE(i-1, j-1, 0)]
+                                   );
+          A[1][A2_INDEX(i, j, 0)] = A[1][A2_INDEX(i-1, j, 0)] + h[0]*Phi3;
+        }
+      }
+      for (int k=1; k < n[2]; k++)
+      {
+        for (int j=0; j < n[1]; j++)
+        {
+          for (int i=0; i < n[0]; i++)
+          {
+            if (j > 0)
+            {
+              const double Phi1 = 0.25*(  gB[0][SOURCE_ZONE(i, j,   k)]
+                                        + gB[0][SOURCE_ZONE(i, j-1, k)]
+                                        + gB[0][SOURCE_ZONE(i, j,   k-1)]
+                                        + gB[0][SOURCE_ZONE(i, j-1, k-1)]
+                                       );
+              A[1][A2_INDEX(i, j, k)] = A[1][A2_INDEX(i, j, k-1)] - h[2]*Phi1;
+            }
+            if (i > 0)
+            {
+              const double Phi2 = 0.25*(  gB[1][SOURCE_ZONE(i,   j, k)]
+                                        + gB[1][SOURCE_ZONE(i-1, j, k)]
+                                        + gB[1][SOURCE_ZONE(i,   j, k-1)]
+                                        + gB[1][SOURCE_ZONE(i-1, j, k-1)]
+                                       );
+              A[0][A1_INDEX(i, j, k)] = A[0][A1_INDEX(i, j, k-1)] + h[2]*Phi2;
+            }
+          }
+        }
+      }
+      #undef A1_INDEX
+      #undef A2_INDEX
+
+      const double latticeStart1[3] = {1., 0.5, 0.5};
+      const double latticeStart2[3] = {0.5, 1., 0.5};
+      interpolateToCorners(A[0], m1, latticeStart1, n, N, localStart,
+                           numCorners, ACorners[0]
+                          );
+      interpolateToCorners(A[1], m2, latticeStart2, n, N, localStart,
+                           numCorners, ACorners[1]
+                          );
+    }
+    #undef SOURCE_ZONE
+
+    /* B = curl A / g in the averaged difference stencil */
+    double *gHostPtr = geomCenter->g.host<double>();
+    std::vector<double> newB[3];
+    for (int d=0; d < dim; d++)
+    {
+      newB[d].assign(NTotal[0]*NTotal[1]*NTotal[2], 0.);
+    }
+    for (int k=0; k < NLocal[2]; k++)
+    {
+      for (int j=0; j < NLocal[1]; j++)
+      {
+        for (int i=0; i < NLocal[0]; i++)
+        {
+          const int index =   i + numGhostX[0]
+                            + NTotal[0]*(  j + numGhostX[1]
+                                         + NTotal[1]*(k + numGhostX[2])
+                                        );
+          double gBZone[3];
+          if (dim == 2)
+          {
+            gBZone[0] =  cornerDifference(ACorners[2], numCorners, dim,
+                                          i, j, k, 1
+                                         )/H[1];
+            gBZone[1] = -cornerDifference(ACorners[2], numCorners, dim,
+                                          i, j, k, 0
+                                         )/H[0];
+          }
+          else
+          {
+            gBZone[0] = -cornerDifference(ACorners[1], numCorners, dim,
+                                          i, j, k, 2
+                                         )/H[2];
+            gBZone[1] =  cornerDifference(ACorners[0], numCorners, dim,
+                                          i, j, k, 2
+                                         )/H[2];
+            gBZone[2] =  cornerDifference(ACorners[1], numCorners, dim,
+                                          i, j, k, 0
+                                         )/H[0]
+                       - cornerDifference(ACorners[0], numCorners, dim,
+                                          i, j, k, 1
+                                         )/H[1];
+          }
+          for (int d=0; d < dim; d++)
+          {
+            newB[d][index] = gBZone[d]/gHostPtr[index];
+          }
+        }
+      }
+    }
+    af::freeHost(gHostPtr);
+
+    for (int d=0; d < dim; d++)
+    {
+      primOld->vars[vars::B1 + d] = array(dims, &newB[d][0]);
+    }
+  }
+  delete source;
+
+  /* Ghost zones, boundaries and floors are set by restartFrom() */
+}
@@ -0,0 +1,316 @@
+#include "timestepper.hpp"
+
+/* Set the inputs of the half step solve from primOld, as timeStep() does up
+ * to the solver: boundaries, elemOld, consOld and the sources, the
+ * divergence of the fluxes, and the guess with the induction equation
+ * applied. dt is the Courant step of primOld. */
+void timeStepper::replaySetup()
+{
+  currentStep = timeStepperSwitches::HALF_STEP;
+  boundaries::applyBoundaryConditions(boundaryLeft, boundaryRight,
+                                      boundaryTop,  boundaryBottom,
+                                      boundaryFront, boundaryBack,
+                                      *primOld
+                                     );
+  setProblemSpecificBCs();
+  elemOld->set(*primOld, *geomCenter);
+
+  /* No previous step to limit the growth of dt */
+  dt = 1e30;
+  computeDt();
+
+  double dX[3];
+  dX[0] = XCoords->dX1;
+  dX[1] = XCoords->dX2;
+  dX[2] = XCoords->dX3;
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    native::computeConsAndSources(*primOld, *geomCenter,
+                                  consOld, *sourcesExplicit
+                                 );
+  }
+  else
+#endif
+  {
+    elemOld->computeFluxes(0, *consOld);
+    elemOld->computeExplicitSources(dX, *sourcesExplicit);
+    elemOld->computeImplicitSources(*sourcesImplicitOld,
+                                    elemOld->tau
+                                   );
+  }
+
+  computeDivOfFluxes(*primOld);
+
+  for (int var=0; var < vars::numFluidVars; var++)
+  {
+    prim->vars[var] = primOld->vars[var];
+  }
+
+  if (!useNativeBackend)
+  {
+    for (int var=vars::B1; var <= vars::B3; var++)
+    {
+      cons->vars[var] = consOld->vars[var] - 0.5*dt*divFluxes->vars[var];
+      prim->vars[var] = cons->vars[var]/geomCenter->g;
+      prim->vars[var].eval();
+
+      primGuessPlusEps->vars[var]         = prim->vars[var];
+      primGuessLineSearchTrial->vars[var] = prim->vars[var];
+    }
+  }
+}
+
+/* The half step solver of timeStep(), on the state set by replaySetup() */
+void timeStepper::replaySolve()
+{
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    native::timeStepAndInvert(*consOld, *divFluxes, *sourcesExplicit,
+                              *geomCenter, 0.5*dt,
+                              *cons, *prim,
+                              idealSolverFailures, idealSolverZoneIters,
+                              idealSolverIters
+                             );
+  }
+  else
+#endif
+  if (params::conduction == 0 &&
+      params::viscosity == 0 &&
+      params::solver == solvers::IDEAL)
+  {
+    PROFILE_BEGIN("fluid cons");
+    timeStepFluidCons(0.5*dt);
+    PROFILE_END();
+
+    idealSolver(*prim);
+  }
+  else
+  {
+    solve(*prim);
+  }
+}
+
+/* Repeat one stage of the half step numEvals times on the current primOld,
+ * e.g. a snapshot read with grid::load (see replay.cpp in the top folder).
+ * Every repetition starts from the same inputs, so that floor activity,
+ * Newton iterations and line searches are those of the snapshot. Each
+ * repetition is a profiler step. Collective. */
+void timeStepper::replay(const int stage, const int numEvals)
+{
+  replaySetup();
+
+  /* The solver overwrites the guess and cons */
+  std::vector<array> primSaved(prim->vars, prim->vars + prim->numVars);
+  std::vector<array> consSaved(cons->vars, cons->vars + cons->numVars);
+  std::vector<array> primHalfStepSaved;
+  if (stage == replayStages::FLOORS)
+  {
+    replaySolve();
+    for (int var=0; var < prim->numVars; var++)
+    {
+      primHalfStep->vars[var] = prim->vars[var];
+    }
+    primHalfStep->communicate();
+    primHalfStepSaved.assign(primHalfStep->vars,
+                             primHalfStep->vars + primHalfStep->numVars
+                            );
+  }
+
+  const char *stageNames[3] = {"divergence of fluxes", "solve", "floors"};
+  PetscPrintf(PETSC_COMM_WORLD, "  Replaying %s, dt = %g\n",
+              stageNames[stage], dt
+             );
+
+  double stageTime = 0.;
+  for (int n=1; n <= numEvals; n++)
+  {
+    for (int var=0; var < prim->numVars; var++)
+    {
+      prim->vars[var] = primSaved[var];
+      cons->vars[var] = consSaved[var];
+    }
+    for (int var=0; var < primHalfStepSaved.size(); var++)
+    {
+      primHalfStep->vars[var] = primHalfStepSaved[var];
+    }
+    af::sync();
+
+    profiler::beginStep(n);
+    af::timer stageTimer = af::timer::start();
+    switch (stage)
+    {
+      case replayStages::DIV_OF_FLUXES:
+        PROFILE_BEGIN("fluxes");
+        computeDivOfFluxes(*primOld);
+        PROFILE_END();
+        break;
+
+      case replayStages::SOLVE:
+        PROFILE_BEGIN("solver");
+        replaySolve();
+        PROFILE_END();
+        break;
+
+      case replayStages::FLOORS:
+        PROFILE_BEGIN("diagnostics");
+        halfStepDiagnostics();
+        PROFILE_END();
+        break;
+    }
+    af::sync();
+    double evalTime = af::timer::stop(stageTimer);
+    profiler::endStep(n);
+    stageTime += evalTime;
+
+    PetscPrintf(PETSC_COMM_WORLD, "  Replay %i : %g secs", n, evalTime);
+    if (stage == replayStages::SOLVE && params::solver == solvers::IDEAL)
+    {
+      double numFailures =
+        af::count<double>(idealSolverFailures(domainX1, domainX2, domainX3));
+      PetscPrintf(PETSC_COMM_WORLD, ", %d ideal solver iters, %g failed zones",
+                  idealSolverIters, numFailures
+                 );
+    }
+    PetscPrintf(PETSC_COMM_WORLD, "\n");
+  }
+
+  PetscPrintf(PETSC_COMM_WORLD, "  Average  : %g secs, %g zones/sec/proc\n",
+              stageTime/numEvals,
+              prim->N1Local*prim->N2Local*prim->N3Local*numEvals/stageTime
+             );
+}
+
+#ifdef GRIM_NATIVE_BACKEND
+/* Largest difference between a and b in the domain over the largest |b|,
+ * over all ranks */
+static double relativeError(const array &a, const array &b,
+                            const af::seq &domainX1,
+                            const af::seq &domainX2,
+                            const af::seq &domainX3
+                           )
+{
+  double errors[2];
+  errors[0] = af::max<double>(af::abs(a - b)(domainX1, domainX2, domainX3));
+  errors[1] = af::max<double>(af::abs(b)(domainX1, domainX2, domainX3));
+  MPI_Allreduce(MPI_IN_PLACE, errors, 2, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+
+  return errors[0]/std::max(errors[1], 1e-300);
+}
+
+/* The half step of primOld with the native backend and then with ArrayFire,
+ * from the same inputs: the largest relative differences of divFluxes and of
+ * the solved primitives over all variables, and the largest residual of the
+ * primitives of each backend. Both residuals are computeResidual() on the
+ * ArrayFire inputs. Returns false if the native backend does not cover the
+ * physics of the problem. Collective. */
+bool timeStepper::compareBackends(double &divFluxesError, double &primError,
+                                  double &nativeResidual,
+                                  double &arrayFireResidual
+                                 )
+{
+  if (!useNativeBackend)
+  {
+    return false;
+  }
+
+  replaySetup();
+  replaySolve();
+  std::vector<array> divFluxesNative(divFluxes->vars,
+                                     divFluxes->vars + divFluxes->numVars
+                                    );
+  std::vector<array> primNative(prim->vars, prim->vars + prim->numVars);
+
+  useNativeBackend = false;
+  replaySetup();
+  replaySolve();
+  useNativeBackend = true;
+
+  divFluxesError = 0.;
+  primError      = 0.;
+  for (int var=0; var < prim->numVars; var++)
+  {
+    divFluxesError = std::max(divFluxesError,
+                              relativeError(divFluxesNative[var],
+                                            divFluxes->vars[var],
+                                            domainX1, domainX2, domainX3
+                                           )
+                             );
+    primError = std::max(primError,
+                         relativeError(primNative[var], prim->vars[var],
+                                       domainX1, domainX2, domainX3
+                                      )
+                        );
+    primGuessPlusEps->vars[var] = primNative[var];
+  }
+
+  /* The residual overwrites cons; prim and the inputs are kept */
+  computeResidual(*primGuessPlusEps, *residualPlusEps);
+  computeResidual(*prim, *residual);
+  nativeResidual    = 0.;
+  arrayFireResidual = 0.;
+  for (int var=0; var < residual->numVars; var++)
+  {
+    nativeResidual =
+      std::max(nativeResidual,
+               af::max<double>(af::abs(residualPlusEps->vars[var]))
+              );
+    arrayFireResidual =
+      std::max(arrayFireResidual,
+               af::max<double>(af::abs(residual->vars[var]))
+              );
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &nativeResidual, 1, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+  MPI_Allreduce(MPI_IN_PLACE, &arrayFireResidual, 1, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+
+  return true;
+}
+
+/* divFluxes of primOld from the flux task graph (fluxTasks) against the
+ * serial native sweeps, as the largest relative difference over all
+ * variables. Returns false if the native backend does not cover the physics
+ * of the problem. Collective. */
+bool timeStepper::compareFluxTasks(double &divFluxesError)
+{
+  if (!useNativeBackend)
+  {
+    return false;
+  }
+
+  const int fluxTasks   = params::fluxTasks;
+  const int tiledFluxes = params::tiledFluxes;
+  params::tiledFluxes   = 0;
+
+  params::fluxTasks = 0;
+  replaySetup();
+  std::vector<array> divFluxesSerial(divFluxes->vars,
+                                     divFluxes->vars + divFluxes->numVars
+                                    );
+
+  params::fluxTasks = 1;
+  computeDivOfFluxes(*primOld);
+
+  divFluxesError = 0.;
+  for (int var=0; var < divFluxes->numVars; var++)
+  {
+    divFluxesError = std::max(divFluxesError,
+                              relativeError(divFluxes->vars[var],
+                                            divFluxesSerial[var],
+                                            domainX1, domainX2, domainX3
+                                           )
+                             );
+  }
+
+  params::fluxTasks   = fluxTasks;
+  params::tiledFluxes = tiledFluxes;
+
+  return true;
+}
+#endif
@@ -1,38 +1,21 @@
 #include "timestepper.hpp"
 
 void timeStepper::computeResidual(const grid &primGuess,
-                                  grid &residualGuess, 
-                                  int &numReads,
-                                  int &numWrites
+                                  grid &residualGuess
                                  )
 {
-  numReads = 0; numWrites = 0;
-  int numReadsElemSet, numWritesElemSet;
-  int numReadsComputeFluxes, numWritesComputeFluxes;
-  elem->set(primGuess, *geomCenter, numReadsElemSet, numWritesElemSet);
-  elem->computeFluxes(0, *cons, 
-                      numReadsComputeFluxes, numWritesComputeFluxes
-                     );
-  numReads  += numReadsElemSet  + numReadsComputeFluxes;
-  numWrites += numWritesElemSet + numWritesComputeFluxes;
+  elem->set(primGuess, *geomCenter);
+  elem->computeFluxes(0, *cons);
 
   if (currentStep == timeStepperSwitches::HALF_STEP)
   {
-    int numReadsImplicitSources, numReadsTimeDerivSources;
-    int numWritesImplicitSources, numWritesTimeDerivSources;
     elem->computeImplicitSources(*sourcesImplicit,
-                                 elemOld->tau,
-                                 numReadsImplicitSources,
-                                 numWritesImplicitSources
+                                 elemOld->tau
                                 );
     elemOld->computeTimeDerivSources(*elemOld, *elem,
                                      dt/2,
-                                     *sourcesTimeDer,
-                                     numReadsTimeDerivSources,
-                                     numWritesTimeDerivSources
+                                     *sourcesTimeDer
                                     );
-    numReads  += numReadsImplicitSources  + numReadsTimeDerivSources;
-    numWrites += numWritesImplicitSources + numWritesTimeDerivSources; 
 
     for (int var=0; var<residualGuess.numVars; var++)
     {
@@ -44,16 +27,6 @@ void timeStepper::computeResidual(const grid &primGuess,
       + sourcesTimeDer->vars[var];
     }
 
-    /* Reads:
-     * -----
-     *  cons[var], consOld[var], divFluxes[var]       : 3*numVars
-     *  sourcesExplicit[var], sourcesTimeDer[var]     : 2*numVars
-     *  sourcesImplicitOld[var], sourcesImplicit[var] : 2*numVars
-     *
-     * Writes:
-     * ------
-     * residualGuess[var] : numVars */
-    numReads  += 7*residualGuess.numVars;
 
     /* Normalization of the residualGuess */
     if (params::conduction)
@@ -63,13 +36,10 @@ void timeStepper::computeResidual(const grid &primGuess,
         residualGuess.vars[vars::Q] *=
            elemOld->temperature 
          * af::sqrt(elemOld->rho*elemOld->chi_emhd*elemOld->tau);
-
-        numReads += 4;
       }
       else
       {
         residualGuess.vars[vars::Q] *= elemOld->tau;
-        numReads += 1;
       }
     }
 
@@ -81,12 +51,10 @@ void timeStepper::computeResidual(const grid &primGuess,
           af::sqrt(   elemOld->rho*elemOld->nu_emhd
                     * elemOld->temperature*elemOld->tau
                   );
-        numReads += 4;
       }
       else
       {
         residualGuess.vars[vars::DP] *= elemOld->tau;
-        numReads += 1;
       }
     }
 
@@ -94,21 +62,13 @@ void timeStepper::computeResidual(const grid &primGuess,
 
   else if (currentStep == timeStepperSwitches::FULL_STEP)
   {
-    int numReadsImplicitSources, numReadsTimeDerivSources;
-    int numWritesImplicitSources, numWritesTimeDerivSources;
     elem->computeImplicitSources(*sourcesImplicit,
-                                 elemHalfStep->tau,
-                                 numReadsImplicitSources,
-                                 numWritesImplicitSources
+                                 elemHalfStep->tau
                                 );
     elemHalfStep->computeTimeDerivSources(*elemOld, *elem,
                                           dt,
-                                          *sourcesTimeDer,
-                                          numReadsTimeDerivSources,
-                                          numWritesTimeDerivSources
+                                          *sourcesTimeDer
                                          );
-    numReads  += numReadsImplicitSources  + numReadsTimeDerivSources;
-    numWrites += numWritesImplicitSources + numWritesTimeDerivSources; 
 
     for (int var=0; var < residualGuess.numVars; var++)
     {
@@ -119,16 +79,6 @@ void timeStepper::computeResidual(const grid &primGuess,
       + 0.5*(sourcesImplicitOld->vars[var] + sourcesImplicit->vars[var])
       + sourcesTimeDer->vars[var];
     }
-    /* Reads:
-     * -----
-     *  cons[var], consOld[var], divFluxes[var]       : 3*numVars
-     *  sourcesExplicit[var], sourcesTimeDer[var]     : 2*numVars
-     *  sourcesImplicitOld[var], sourcesImplicit[var] : 2*numVars
-     *
-     * Writes:
-     * ------
-     * residualGuess[var] : numVars */
-    numReads  += 7*residualGuess.numVars;
 
     /* Normalization of the residualGuess */
     if (params::conduction)
@@ -138,13 +88,10 @@ void timeStepper::computeResidual(const grid &primGuess,
         residualGuess.vars[vars::Q] *= 
           elemHalfStep->temperature
         * af::sqrt(elemHalfStep->rho*elemHalfStep->chi_emhd*elemHalfStep->tau);
-
-        numReads += 4;
       }
       else
       {
         residualGuess.vars[vars::Q] *= elemHalfStep->tau;
-        numReads += 1;
       }
     }
 
@@ -156,13 +103,10 @@ void timeStepper::computeResidual(const grid &primGuess,
           af::sqrt(   elemHalfStep->rho*elemHalfStep->nu_emhd
                     * elemHalfStep->temperature*elemHalfStep->tau
                   );
-
-        numReads += 4;
       }
       else
       {
         residualGuess.vars[vars::DP] *= elemHalfStep->tau;
-        numReads += 1;
       }
     }
 
@@ -175,7 +119,16 @@ void timeStepper::computeResidual(const grid &primGuess,
     residualGuess.vars[var] *= residualMask;
     arraysThatNeedEval.push_back(&residualGuess.vars[var]);
   }
+  /* cons and the implicit and time derivative sources are recomputed from
+   * primGuess inside the fused kernel */
+  const int numVars = residualGuess.numVars;
+  PROFILE_BYTES(  profiler::arrayBytes(arraysThatNeedEval)
+                + profiler::arrayBytes(numVars, primGuess.vars)
+                + profiler::arrayBytes(numVars, consOld->vars)
+                + profiler::arrayBytes(numVars, divFluxes->vars)
+                + profiler::arrayBytes(numVars, sourcesExplicit->vars)
+                + profiler::arrayBytes(numVars, sourcesImplicitOld->vars)
+                + residualMask.bytes()
+               );
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
-
-  numWrites += residualGuess.numVars;
 }
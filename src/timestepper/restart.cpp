@@ -0,0 +1,434 @@
+#include "timestepper.hpp"
+#include <fstream>
+#include <sstream>
+#include <csignal>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+
+/* Checkpoints are the primitives of primOld, with everything else needed to
+ * continue the run stored as attributes of the dataset: time, dt,
+ * stepNumber, the grid size, and a fingerprint of the parameters the
+ * solution depends on (parameters, in plain text, for inspection with
+ * h5dump). A restart reads them back instead of generating the initial
+ * conditions. */
+
+/* Parameters a checkpoint is only valid with. The grid size is checked
+ * separately. */
+std::string timeStepper::restartParameters()
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << "restart v1"
+      << " metric " << params::metric
+      << " blackHoleSpin " << params::blackHoleSpin
+      << " hSlope " << params::hSlope
+      << " DerefineThetaHorizon " << params::DerefineThetaHorizon
+      << " DoCylindrify " << params::DoCylindrify
+      << " X1cyl " << params::X1cyl << " X2cyl " << params::X2cyl
+      << " X1MapFile " << params::X1MapFile
+      << " X2MapFile " << params::X2MapFile
+      << " X1 " << params::X1Start << " " << params::X1End
+      << " X2 " << params::X2Start << " " << params::X2End
+      << " X3 " << params::X3Start << " " << params::X3End
+      << " adiabaticIndex " << params::adiabaticIndex
+      << " conduction " << params::conduction
+      << " viscosity " << params::viscosity
+      << " numVars " << numVars;
+
+  return key.str();
+}
+
+void timeStepper::dumpRestart(const std::string fileName)
+{
+  primOld->dump("primitives", fileName);
+
+  const std::string parameters = restartParameters();
+  long fingerprint = hashString(parameters);
+  PetscInt gridSize[4] = {N1, N2, N3, dim};
+  PetscInt step = stepNumber;
+
+  PetscViewer viewer;
+  PetscViewerHDF5Open(PETSC_COMM_WORLD,
+                      fileName.c_str(), FILE_MODE_APPEND, &viewer
+                     );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "time",
+                                PETSC_DOUBLE, &time
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "dt",
+                                PETSC_DOUBLE, &dt
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "stepNumber",
+                                PETSC_INT, &step
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "N1",
+                                PETSC_INT, &gridSize[0]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "N2",
+                                PETSC_INT, &gridSize[1]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "N3",
+                                PETSC_INT, &gridSize[2]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "dim",
+                                PETSC_INT, &gridSize[3]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "fingerprint",
+                                PETSC_LONG, &fingerprint
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "primitives", "parameters",
+                                PETSC_STRING, parameters.c_str()
+                               );
+  PetscViewerDestroy(&viewer);
+}
+
+/* Loads a checkpoint written by dumpRestart() into primOld and sets time, dt
+ * and stepNumber. Returns false, and loads nothing, for files without the
+ * attributes. Aborts if the checkpoint does not match this run. */
+bool timeStepper::loadRestart(const std::string fileName)
+{
+  PetscViewer viewer;
+  PetscViewerHDF5Open(PETSC_COMM_WORLD,
+                      fileName.c_str(), FILE_MODE_READ, &viewer
+                     );
+  hid_t fileId;
+  PetscViewerHDF5GetFileId(viewer, &fileId);
+  if (H5Aexists_by_name(fileId, "primitives", "fingerprint", H5P_DEFAULT) <= 0)
+  {
+    PetscViewerDestroy(&viewer);
+    return false;
+  }
+
+  double restartTime, restartDt;
+  PetscInt step, gridSize[4];
+  long fingerprint;
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "time",
+                               PETSC_DOUBLE, &restartTime
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "dt",
+                               PETSC_DOUBLE, &restartDt
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "stepNumber",
+                               PETSC_INT, &step
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "N1",
+                               PETSC_INT, &gridSize[0]
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "N2",
+                               PETSC_INT, &gridSize[1]
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "N3",
+                               PETSC_INT, &gridSize[2]
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "dim",
+                               PETSC_INT, &gridSize[3]
+                              );
+  PetscViewerHDF5ReadAttribute(viewer, "primitives", "fingerprint",
+                               PETSC_LONG, &fingerprint
+                              );
+  PetscViewerDestroy(&viewer);
+
+  const bool sameGrid =    gridSize[0] == N1 && gridSize[1] == N2
+                        && gridSize[2] == N3 && gridSize[3] == dim;
+  if (!sameGrid && (gridSize[3] != dim || !params::restartChangeResolution))
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "Restart file %s is %d x %d x %d in %dD, the grid is "
+                "%d x %d x %d in %dD\n",
+                fileName.c_str(), gridSize[0], gridSize[1], gridSize[2],
+                gridSize[3], N1, N2, N3, dim
+               );
+    if (gridSize[3] == dim)
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "Set restartChangeResolution to restart on this grid\n"
+                 );
+    }
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+  if (fingerprint != (long) hashString(restartParameters()))
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "Restart file %s was written with other parameters, see\n"
+                "  h5dump -a primitives/parameters %s\n"
+                "The parameters of this run are\n  %s\n",
+                fileName.c_str(), fileName.c_str(),
+                restartParameters().c_str()
+               );
+    MPI_Abort(PETSC_COMM_WORLD, 1);
+  }
+
+  if (sameGrid)
+  {
+    primOld->load("primitives", fileName);
+  }
+  else
+  {
+    const int sourceN[3] = {gridSize[0], gridSize[1], gridSize[2]};
+    prolongRestart(fileName, sourceN);
+  }
+  /* dt is recomputed for the new zones at the start of the next step */
+  time       = restartTime;
+  dt         = restartDt;
+  stepNumber = step;
+
+  return true;
+}
+
+/* The checkpoint to restart from: the one named in restartFileName, written
+ * by the problem when it checkpoints, or else restartFile if restart is set.
+ * Empty for a fresh start. */
+std::string timeStepper::findRestartFile()
+{
+  struct stat fileInfo;
+  if (stat(params::restartFileName.c_str(), &fileInfo) == 0)
+  {
+    std::ifstream fName(params::restartFileName.c_str());
+    std::string fileName;
+    fName >> fileName;
+    return fileName;
+  }
+
+  if (params::restart)
+  {
+    if (stat(params::restartFile.c_str(), &fileInfo) != 0)
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "\n");
+      PetscPrintf(PETSC_COMM_WORLD, "Restart file %s does not exist\n",
+                  params::restartFile.c_str()
+                 );
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    return params::restartFile;
+  }
+
+  return "";
+}
+
+void timeStepper::restartFrom(const std::string fileName)
+{
+  if (loadRestart(fileName))
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\n  Restarting from %s at time %e, step %d, dt %e\n\n",
+                fileName.c_str(), time, stepNumber, dt
+               );
+  }
+  else
+  {
+    /* Checkpoints from before dumpRestart(): primitives only, with the time
+     * in restartFileTime */
+    primOld->load("primitives", fileName);
+
+    struct stat fileInfo;
+    if (stat(params::restartFileTime.c_str(), &fileInfo) == 0)
+    {
+      std::ifstream fTime(params::restartFileTime.c_str());
+      fTime >> time;
+    }
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\n  Restarting from %s at time %e (no restart attributes, "
+                "dt and step number start over)\n\n",
+                fileName.c_str(), time
+               );
+  }
+
+  /* Ghost zones and floors, as the initial conditions end with them, for
+   * elemOld and computeDt() at the start of the next step */
+  primOld->communicate();
+  boundaries::applyBoundaryConditions(boundaryLeft, boundaryRight,
+                                      boundaryTop,  boundaryBottom,
+                                      boundaryFront, boundaryBack,
+                                      *primOld
+                                     );
+  setProblemSpecificBCs();
+  elemOld->set(*primOld, *geomCenter);
+  fullStepDiagnostics();
+}
+
+/* Checkpoint requests from the batch scheduler: SIGTERM checkpoints and
+ * stops, SIGUSR1 checkpoints and carries on. The handlers only count; the
+ * counts are reduced over the ranks with dt, see reduceStepState(). */
+static volatile sig_atomic_t stopSignals = 0;
+static volatile sig_atomic_t checkpointSignals = 0;
+
+static void checkpointSignalHandler(const int signal)
+{
+  if (signal == SIGTERM)
+  {
+    stopSignals = stopSignals + 1;
+  }
+  else
+  {
+    checkpointSignals = checkpointSignals + 1;
+  }
+}
+
+void timeStepper::installCheckpointSignalHandlers()
+{
+  struct sigaction action;
+  action.sa_handler = checkpointSignalHandler;
+  sigemptyset(&action.sa_mask);
+  /* Restart interrupted system calls, MPI and HDF5 included */
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGTERM, &action, NULL);
+  sigaction(SIGUSR1, &action, NULL);
+}
+
+/* The maximum of the inverse time step over all ranks, together with the
+ * wall time and the pending signals, in the one reduction computeDt() needs
+ * anyway, so that every rank takes the same checkpoint decisions without a
+ * collective of their own */
+void timeStepper::reduceStepState(double &maxInvDt)
+{
+  const int checkpointSignalsNow = checkpointSignals;
+  double state[4] = {maxInvDt,
+                     MPI_Wtime() - wallTimeStart,
+                     (double) (stopSignals > 0),
+                     (double) (checkpointSignalsNow > checkpointSignalsHandled)
+                    };
+  MPI_Allreduce(MPI_IN_PLACE, state, 4, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+  maxInvDt            = state[0];
+  wallTimeElapsed     = state[1];
+  stopRequested       = (state[2] > 0.);
+  checkpointRequested = (state[3] > 0.);
+  checkpointSignalsSeen = checkpointSignalsNow;
+}
+
+/* Flushes a file, or the entries of a directory, to disk */
+static void syncToDisk(const std::string path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    fsync(fd);
+    close(fd);
+  }
+}
+
+/* Deletes all but the last numKept restartVarsStep*.h5 files of the working
+ * directory, earlier runs included, and the leftovers of checkpoints that
+ * were interrupted while being written. Checkpoints past currentStep are
+ * from a run that was restarted from an earlier one, and go first. */
+static void rotateCheckpoints(const int currentStep, const int numKept)
+{
+  const std::string prefix = "restartVarsStep";
+  std::vector<std::pair<int, std::string> > checkpoints;
+  std::vector<std::string> leftovers;
+
+  DIR *dir = opendir(".");
+  if (dir == NULL)
+  {
+    return;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    const std::string name(entry->d_name);
+    int step;
+    if (   name.compare(0, prefix.size(), prefix) != 0
+        || sscanf(name.c_str() + prefix.size(), "%d", &step) != 1
+       )
+    {
+      continue;
+    }
+    char expected[64];
+    snprintf(expected, sizeof(expected), "restartVarsStep%08d.h5", step);
+    if (name == expected)
+    {
+      checkpoints.push_back(std::make_pair(step <= currentStep ? step : -1,
+                                           name
+                                          )
+                           );
+    }
+    else if (name == std::string(expected) + ".tmp")
+    {
+      leftovers.push_back(name);
+    }
+  }
+  closedir(dir);
+
+  std::sort(checkpoints.begin(), checkpoints.end());
+  for (int n=0; n + numKept < (int) checkpoints.size(); n++)
+  {
+    remove(checkpoints[n].second.c_str());
+  }
+  for (int n=0; n < leftovers.size(); n++)
+  {
+    remove(leftovers[n].c_str());
+  }
+}
+
+/* Writes restartVarsStep<stepNumber>.h5 under a temporary name, flushes it
+ * to disk and renames it, so that a run killed while writing, or a node that
+ * crashes after, leaves the previous checkpoints intact. Keeps the last
+ * numCheckpointsKept checkpoints in the directory. */
+void timeStepper::writeCheckpoint()
+{
+  char name[64];
+  snprintf(name, sizeof(name), "restartVarsStep%08d.h5", stepNumber);
+  const std::string fileName(name);
+  const std::string tmpFileName = fileName + ".tmp";
+
+  dumpRestart(tmpFileName);
+
+  /* Each rank flushes what it wrote, from its own node's cache */
+  syncToDisk(tmpFileName);
+  MPI_Barrier(PETSC_COMM_WORLD);
+
+  if (world_rank == 0)
+  {
+    rename(tmpFileName.c_str(), fileName.c_str());
+
+    const std::string tmpPointerName = params::restartFileName + ".tmp";
+    std::ofstream fName(tmpPointerName.c_str());
+    fName << fileName << std::endl;
+    fName.close();
+    syncToDisk(tmpPointerName);
+    rename(tmpPointerName.c_str(), params::restartFileName.c_str());
+    syncToDisk(".");
+
+    rotateCheckpoints(stepNumber, std::max(params::numCheckpointsKept, 1));
+  }
+  lastCheckpointWallTime = wallTimeElapsed;
+
+  PetscPrintf(PETSC_COMM_WORLD,
+              "\n  Checkpoint %s at time %e, step %d\n",
+              fileName.c_str(), time, stepNumber
+             );
+}
+
+/* Checkpoints at the end of a step when MaxWallTime has passed, on a signal,
+ * or every checkpointEveryNSteps steps or checkpointEveryWallTime seconds.
+ * Returns 1 if the run should stop. All ranks agree, see reduceStepState(). */
+int timeStepper::checkpointIfDue()
+{
+  const int stop = (wallTimeElapsed >= params::MaxWallTime) || stopRequested;
+  const int due  =    stop || checkpointRequested
+                   || (   params::checkpointEveryNSteps > 0
+                       && stepNumber % params::checkpointEveryNSteps == 0
+                      )
+                   || (   params::checkpointEveryWallTime > 0.
+                       &&    wallTimeElapsed - lastCheckpointWallTime
+                          >= params::checkpointEveryWallTime
+                      );
+  if (due)
+  {
+    writeCheckpoint();
+    dumpZoneCost(params::zoneCostFile);
+    checkpointSignalsHandled = checkpointSignalsSeen;
+    checkpointRequested = 0;
+  }
+  if (stop)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "\n  Stopping: %s\n",
+                stopRequested ? "SIGTERM" : "MaxWallTime reached"
+               );
+  }
+  return stop;
+}
@@ -1,4 +1,5 @@
 #include "timestepper.hpp"
+#include <omp.h>
 
 void timeStepper::solve(grid &primGuess)
 {
@@ -11,11 +12,9 @@ void timeStepper::solve(grid &primGuess)
        nonLinearIter < params::maxNonLinearIter; nonLinearIter++
       )
   {
+    PROFILE_SCOPE("newton iteration");
     af::timer jacobianAssemblyTimer = af::timer::start();
-    int numReadsResidual, numWritesResidual;
-    computeResidual(primGuess, *residual,
-                    numReadsResidual, numWritesResidual
-                   );
+    computeResidual(primGuess, *residual);
     for (int var=0; var < vars::numFluidVars; var++)
     {
       /* Need residualSoA to compute norms */
@@ -41,6 +40,7 @@ void timeStepper::solve(grid &primGuess)
               );
     double globalresnorm = localresnorm;
     int globalNonConverged = localNonConverged;
+    PROFILE_BEGIN("MPI residual norm");
     if (world_rank == 0)
     {
 	    double temp;
@@ -63,6 +63,7 @@ void timeStepper::solve(grid &primGuess)
     MPI_Barrier(PETSC_COMM_WORLD);
     MPI_Bcast(&globalNonConverged,1,MPI_INT,0,PETSC_COMM_WORLD);
     MPI_Barrier(PETSC_COMM_WORLD);
+    PROFILE_END();
     PetscPrintf(PETSC_COMM_WORLD, " ||Residual|| = %g; %i pts haven't converged\n", 
                 globalresnorm,globalNonConverged
 		);
@@ -73,6 +74,7 @@ void timeStepper::solve(grid &primGuess)
 
     /* Assemble the Jacobian in Struct of Arrays format where the physics
      * operations are all vectorized */
+    PROFILE_BEGIN("jacobian");
     for (int row=0; row < residual->numVars; row++)
     {
       /* Recommended value of Jacobian differencing parameter to achieve fp64
@@ -85,9 +87,7 @@ void timeStepper::solve(grid &primGuess)
           (1. + epsilon)*primGuess.vars[row]*(1.-smallPrim)
 	      + smallPrim*epsilon; 
 
-      computeResidual(*primGuessPlusEps, *residualPlusEps,
-                      numReadsResidual, numWritesResidual
-                     );
+      computeResidual(*primGuessPlusEps, *residualPlusEps);
 
       for (int column=0; column < vars::numFluidVars; column++)
       {
@@ -101,6 +101,7 @@ void timeStepper::solve(grid &primGuess)
       primGuessPlusEps->vars[row]  = primGuess.vars[row]; 
     }
     jacobianAssemblyTime += af::timer::stop(jacobianAssemblyTimer);
+    PROFILE_END();
     /* Jacobian assembly complete */
 
     /* Solve the linear system Jacobian * deltaPrim = -residual for the
@@ -133,6 +134,7 @@ void timeStepper::solve(grid &primGuess)
      which has a minimum at the new value of stepLength,
        stepLength = -fPrime0*stepLength0^2 / (f1-f0-fPrime0*stepLength0)/2
      */
+    PROFILE_BEGIN("line search");
     af::timer lineSearchTimer = af::timer::start();
     array f0      = 0.5 * l2Norm;
     array fPrime0 = -2.*f0;
@@ -150,9 +152,7 @@ void timeStepper::solve(grid &primGuess)
           primGuess.vars[var] + stepLength*deltaPrimSoA(span, span, span, var);
       } 
       /* ...and then compute the norm */
-      computeResidual(*primGuessLineSearchTrial, *residual,
-                      numReadsResidual, numWritesResidual
-                     );
+      computeResidual(*primGuessLineSearchTrial, *residual);
       for (int var=0; var<vars::numFluidVars; var++)
       {
         residualSoA(span, span, span, var) = residual->vars[var];
@@ -191,11 +191,13 @@ void timeStepper::solve(grid &primGuess)
         primGuess.vars[var] + stepLength*deltaPrimSoA(span, span, span, var);
     }
     lineSearchTime += af::timer::stop(lineSearchTimer);
+    PROFILE_END();
   }
 }
 
 void timeStepper::batchLinearSolve(const array &A, const array &b, array &x)
 {
+  PROFILE_SCOPE("linear solve");
   af::timer linearSolverTimer = af::timer::start();
 
   int numVars = residual->numVars;
@@ -229,25 +231,32 @@ void timeStepper::batchLinearSolve(const array &A, const array &b, array &x)
     A.host(AHostPtr);
     b.host(bHostPtr);
   
-    #pragma omp parallel for
-    for (int k=0; k<N3Total; k++)
+    #pragma omp parallel
     {
-      for (int j=0; j<N2Total; j++)
+      double threadStart = omp_get_wtime();
+
+      #pragma omp for nowait
+      for (int k=0; k<N3Total; k++)
       {
-        for (int i=0; i<N1Total; i++)
+        for (int j=0; j<N2Total; j++)
         {
-          int pivot[numVars];
+          for (int i=0; i<N1Total; i++)
+          {
+            int pivot[numVars];
   
-          const int spatialIndex = 
-            i +  N1Total*(j + (N2Total*k) );
+            const int spatialIndex = 
+              i +  N1Total*(j + (N2Total*k) );
   
-          LAPACKE_dgesv(LAPACK_COL_MAJOR, numVars, 1, 
-                        &AHostPtr[numVars*numVars*spatialIndex], numVars, 
-                        pivot, &bHostPtr[numVars*spatialIndex], numVars
-                       );
+            LAPACKE_dgesv(LAPACK_COL_MAJOR, numVars, 1, 
+                          &AHostPtr[numVars*numVars*spatialIndex], numVars, 
+                          pivot, &bHostPtr[numVars*spatialIndex], numVars
+                         );
   
+          }
         }
       }
+
+      threads::addThreadTime(omp_get_wtime() - threadStart);
     }
   
     /* Copy solution to x on device */
@@ -311,55 +320,58 @@ array errFunc(const array &BSqr,
   return err;
 }
 
-void timeStepper::idealSolver(grid &primGuess,
-                            int &numReads,
-                            int &numWrites
-                           )
+/* Quantities that stay fixed while iterating on Wp = W - D in the ideal
+ * solver, and the initial guess for Wp computed from primGuess (through elem).
+ * Shared by idealSolver() and idealSolverFixedIter() */
+static void idealSolverInvariants(const fluidElement &elem,
+                                  const geometry &geom,
+                                  const grid &cons,
+                                  array BCon[NDIM],
+                                  array QTildeCon[NDIM],
+                                  array &BSqr,
+                                  array &D,
+                                  array &Ep,
+                                  array &QDotB,
+                                  array &QTildeSqr,
+                                  array &Wp
+                                 )
 {
-  elem->set(primGuess, *geomCenter,
-            numReads, numWrites
-           );
-  
-  array lapse = geomCenter->alpha;
-  array g     = geomCenter->g;
+  array lapse = geom.alpha;
+  array g     = geom.g;
 
-  array D = cons->vars[vars::RHO] * lapse / g;
+  D = cons.vars[vars::RHO] * lapse / g;
 
-  array zero = 0. * elem->B1;
+  array zero = 0. * elem.B1;
 
-  array BCon[NDIM];
   BCon[0] = zero;
-  BCon[1] = elem->B1 * lapse; //BCon[1].eval();
-  BCon[2] = elem->B2 * lapse; //BCon[2].eval();
-  BCon[3] = elem->B3 * lapse; //BCon[3].eval();
+  BCon[1] = elem.B1 * lapse;
+  BCon[2] = elem.B2 * lapse;
+  BCon[3] = elem.B3 * lapse;
 
   array BCov[NDIM];
   for (int mu=0; mu<NDIM; mu++)
   {
-    BCov[mu] =   geomCenter->gCov[mu][0] * BCon[0]
-               + geomCenter->gCov[mu][1] * BCon[1]
-               + geomCenter->gCov[mu][2] * BCon[2]
-               + geomCenter->gCov[mu][3] * BCon[3];
-    //BCov[mu].eval();
+    BCov[mu] =   geom.gCov[mu][0] * BCon[0]
+               + geom.gCov[mu][1] * BCon[1]
+               + geom.gCov[mu][2] * BCon[2]
+               + geom.gCov[mu][3] * BCon[3];
   }
-  array BSqr =   BCov[0]*BCon[0] + BCov[1]*BCon[1]
-               + BCov[2]*BCon[2] + BCov[3]*BCon[3];
-  //BSqr.eval();
+  BSqr =   BCov[0]*BCon[0] + BCov[1]*BCon[1]
+         + BCov[2]*BCon[2] + BCov[3]*BCon[3];
 
   array QCov[NDIM];
-  QCov[0] = cons->vars[vars::U]  * lapse / g; //QCov[0].eval();
-  QCov[1] = cons->vars[vars::U1] * lapse / g; //QCov[1].eval();
-  QCov[2] = cons->vars[vars::U2] * lapse / g; //QCov[2].eval();
-  QCov[3] = cons->vars[vars::U3] * lapse / g; //QCov[3].eval();
+  QCov[0] = cons.vars[vars::U]  * lapse / g;
+  QCov[1] = cons.vars[vars::U1] * lapse / g;
+  QCov[2] = cons.vars[vars::U2] * lapse / g;
+  QCov[3] = cons.vars[vars::U3] * lapse / g;
 
   array QCon[NDIM];
   for (int mu=0; mu<NDIM; mu++)
   {
-    QCon[mu] =   geomCenter->gCon[mu][0] * QCov[0]
-               + geomCenter->gCon[mu][1] * QCov[1]
-               + geomCenter->gCon[mu][2] * QCov[2]
-               + geomCenter->gCon[mu][3] * QCov[3];
-    //QCon[mu].eval();
+    QCon[mu] =   geom.gCon[mu][0] * QCov[0]
+               + geom.gCon[mu][1] * QCov[1]
+               + geom.gCon[mu][2] * QCov[2]
+               + geom.gCon[mu][3] * QCov[3];
   }
 
   array nCov[NDIM];
@@ -371,48 +383,42 @@ void timeStepper::idealSolver(grid &primGuess,
   array nCon[NDIM];
   for (int mu=0; mu<NDIM; mu++)
   {
-    nCon[mu] =   geomCenter->gCon[mu][0] * nCov[0]
-               + geomCenter->gCon[mu][1] * nCov[1]
-               + geomCenter->gCon[mu][2] * nCov[2]
-               + geomCenter->gCon[mu][3] * nCov[3];
-    //nCon[mu].eval();
+    nCon[mu] =   geom.gCon[mu][0] * nCov[0]
+               + geom.gCon[mu][1] * nCov[1]
+               + geom.gCon[mu][2] * nCov[2]
+               + geom.gCon[mu][3] * nCov[3];
   }
 
   array QDotn =   QCov[0]*nCon[0] + QCov[1]*nCon[1]
                 + QCov[2]*nCon[2] + QCov[3]*nCon[3];
-  //QDotn.eval();
 
-  array QDotB =   QCov[0]*BCon[0] + QCov[1]*BCon[1]
-                + QCov[2]*BCon[2] + QCov[3]*BCon[3];
-  //QDotB.eval();
+  QDotB =   QCov[0]*BCon[0] + QCov[1]*BCon[1]
+          + QCov[2]*BCon[2] + QCov[3]*BCon[3];
   
   array QSqr =   QCov[0]*QCon[0] + QCov[1]*QCon[1]
                + QCov[2]*QCon[2] + QCov[3]*QCon[3];
-  //QSqr.eval();
 
-  array QTildeCon[NDIM];
   for (int mu=0; mu < NDIM; mu++)
   {
     QTildeCon[mu] = QCon[mu] + nCon[mu]*QDotn;
   }
-  array QTildeSqr = QSqr + QDotn*QDotn;
+  QTildeSqr = QSqr + QDotn*QDotn;
 
-  array Ep = -QDotn - D;
+  Ep = -QDotn - D;
 
   array uTildeCon[NDIM];
-
   uTildeCon[0] = zero;
-  uTildeCon[1] = elem->u1;
-  uTildeCon[2] = elem->u2;
-  uTildeCon[3] = elem->u3;
+  uTildeCon[1] = elem.u1;
+  uTildeCon[2] = elem.u2;
+  uTildeCon[3] = elem.u3;
 
   array uTildeCov[NDIM];
   for (int mu=0; mu<NDIM; mu++)
   {
-    uTildeCov[mu] =   geomCenter->gCov[mu][0] * uTildeCon[0]
-                    + geomCenter->gCov[mu][1] * uTildeCon[1]
-                    + geomCenter->gCov[mu][2] * uTildeCon[2]
-                    + geomCenter->gCov[mu][3] * uTildeCon[3];
+    uTildeCov[mu] =   geom.gCov[mu][0] * uTildeCon[0]
+                    + geom.gCov[mu][1] * uTildeCon[1]
+                    + geom.gCov[mu][2] * uTildeCon[2]
+                    + geom.gCov[mu][3] * uTildeCon[3];
   }
 
   array uTildeSqr =  uTildeCov[0] * uTildeCon[0] + uTildeCov[1] * uTildeCon[1]
@@ -420,17 +426,29 @@ void timeStepper::idealSolver(grid &primGuess,
 
   array gammaTilde = af::sqrt(1. + af::abs(uTildeSqr));
 
-  array Wp =   (elem->rho + elem->u + elem->pressure)*gammaTilde*gammaTilde
-             - elem->rho*gammaTilde;
+  Wp =   (elem.rho + elem.u + elem.pressure)*gammaTilde*gammaTilde
+       - elem.rho*gammaTilde;
+}
 
-  double DEL = 1e-5;
+/* Halley step on err(Wp) using numerical derivatives (first iteration of the
+ * harm inversion) */
+static array idealSolverHalleyStep(const array &BSqr,
+                                   const array &D,
+                                   const array &Ep,
+                                   const array &QDotB,
+                                   const array &QTildeSqr,
+                                   const array &Wp,
+                                   array &err
+                                  )
+{
+  const double DEL = 1e-5;
   array WpMinus = (1. - DEL)*Wp;
   array h       = Wp - WpMinus;
   array WpPlus  = Wp + h;
 
-  array errPlus  = errFunc(BSqr, Ep, D, QDotB, QTildeSqr, WpPlus );
-  array err      = errFunc(BSqr, Ep, D, QDotB, QTildeSqr, Wp     );
-  array errMinus = errFunc(BSqr, Ep, D, QDotB, QTildeSqr, WpMinus);
+  array errPlus  = errFunc(BSqr, D, Ep, QDotB, QTildeSqr, WpPlus );
+  err            = errFunc(BSqr, D, Ep, QDotB, QTildeSqr, Wp     );
+  array errMinus = errFunc(BSqr, D, Ep, QDotB, QTildeSqr, WpMinus);
 
   array dErrdW   = (errPlus - errMinus)/(WpPlus - WpMinus);
   array dErr2dW2 = (errPlus - 2.*err + errMinus)/(h*h);
@@ -438,62 +456,311 @@ void timeStepper::idealSolver(grid &primGuess,
   array f = 0.5*err*dErr2dW2/(dErrdW * dErrdW);
   array dW = -err/dErrdW/(1. - af::min(af::max(-0.3, f), 0.3));
 
-  array Wp1  = Wp;
-  array err1 = err;
-
-  Wp  = Wp + af::max( af::min(dW, 2.0*Wp), -0.5*Wp );
-  err = errFunc(BSqr, D, Ep, QDotB, QTildeSqr, Wp);
-
-  // ITERMAX is 8 in harm code. Need break?
-  for (int iter=0; iter < 1; iter++)
-  {
-    dW  = (Wp1 - Wp)*err/(err - err1);
-
-    Wp1  = Wp;
-    err1 = err;
-
-    Wp  = Wp + af::max( af::min(dW, 2.0*Wp), -0.5*Wp );
-    err  = errFunc(BSqr, Ep, D, QDotB, QTildeSqr, Wp);
-  }
+  return af::max( af::min(dW, 2.0*Wp), -0.5*Wp );
+}
 
+/* Compute the fluid primitives from the converged Wp */
+static void idealSolverPrimitives(const array BCon[NDIM],
+                                  const array QTildeCon[NDIM],
+                                  const array &BSqr,
+                                  const array &D,
+                                  const array &QDotB,
+                                  const array &QTildeSqr,
+                                  const array &Wp,
+                                  array primRecovered[]
+                                 )
+{
   array gamma = gammaFunc(BSqr, D, QDotB, QTildeSqr, Wp);
   array rho0  = D/gamma;
   array W     = Wp + D;
   array w     = W/(gamma * gamma);
   array P     = pressureRho0W(rho0, w);
   
-  primGuess.vars[vars::RHO] = rho0;
-  primGuess.vars[vars::U]   = w - (rho0 + P);
+  primRecovered[vars::RHO] = rho0;
+  primRecovered[vars::U]   = w - (rho0 + P);
+
+  primRecovered[vars::U1] =   (gamma/(W + BSqr))
+                            * (QTildeCon[1] + QDotB*BCon[1]/W) ;
+
+  primRecovered[vars::U2] =   (gamma/(W + BSqr))
+                            * (QTildeCon[2] + QDotB*BCon[2]/W) ;
+
+  primRecovered[vars::U3] =   (gamma/(W + BSqr))
+                            * (QTildeCon[3] + QDotB*BCon[3]/W) ;
+}
+
+void timeStepper::idealSolver(grid &primGuess)
+{
+  elem->set(primGuess, *geomCenter);
+
+  array BCon[NDIM], QTildeCon[NDIM];
+  array BSqr, D, Ep, QDotB, QTildeSqr, Wp;
+  idealSolverInvariants(*elem, *geomCenter, *cons,
+                        BCon, QTildeCon,
+                        BSqr, D, Ep, QDotB, QTildeSqr, Wp
+                       );
+
+  /* Iterate on flattened copies of the invariants. Once a zone has converged
+   * it is dropped from all the *Active arrays, so that later iterations only
+   * cost work for the zones that still need it. activeZones maps back from
+   * the compacted arrays to the flat zone index. */
+  const int numZones = Wp.elements();
+  array activeZones     = af::range(af::dim4(numZones), 0, u32);
+  array BSqrActive      = af::flat(BSqr);
+  array DActive         = af::flat(D);
+  array EpActive        = af::flat(Ep);
+  array QDotBActive     = af::flat(QDotB);
+  array QTildeSqrActive = af::flat(QTildeSqr);
+  array WpActive        = af::flat(Wp);
+  array WpOldActive, errOldActive;
+
+  array WpFlat     = af::flat(Wp);
+  array statusFlat = af::constant(idealSolverStatus::NOT_CONVERGED,
+                                  numZones, f64
+                                 );
+  array itersFlat  = af::constant(params::maxIdealSolverIter, numZones, f64);
+
+  idealSolverIters = 0;
+  for (int iter=0; iter < params::maxIdealSolverIter; iter++)
+  {
+    array dW;
+    if (iter==0)
+    {
+      dW = idealSolverHalleyStep(BSqrActive, DActive, EpActive,
+                                 QDotBActive, QTildeSqrActive, WpActive,
+                                 errOldActive
+                                );
+    }
+    else
+    {
+      /* Secant steps after the first iteration */
+      array errActive = errFunc(BSqrActive, DActive, EpActive,
+                                QDotBActive, QTildeSqrActive, WpActive
+                               );
+      dW  = (WpOldActive - WpActive)*errActive/(errActive - errOldActive);
+      dW  = af::max( af::min(dW, 2.0*WpActive), -0.5*WpActive );
+
+      errOldActive = errActive;
+    }
+    WpOldActive = WpActive;
+    WpActive    = WpActive + dW;
+    WpActive.eval();
+    idealSolverIters = iter+1;
+
+    WpFlat(activeZones) = WpActive;
+
+    /* Device-side convergence mask. NaNs never compare as converged and stay
+     * in the active set until they are flagged below. */
+    array converged = af::abs(dW) <= params::idealSolverTol*af::abs(WpActive);
+    array convergedIndices = where(converged);
+    if (convergedIndices.elements() > 0)
+    {
+      statusFlat(activeZones(convergedIndices)) = idealSolverStatus::CONVERGED;
+      itersFlat(activeZones(convergedIndices))  = iter+1;
+    }
 
-  primGuess.vars[vars::U1] =   (gamma/(W + BSqr))
-                             * (QTildeCon[1] + QDotB*BCon[1]/W) ;
+    array notConvergedIndices = where(!converged);
+    if (notConvergedIndices.elements() == 0)
+    {
+      break;
+    }
 
-  primGuess.vars[vars::U2] =   (gamma/(W + BSqr))
-                             * (QTildeCon[2] + QDotB*BCon[2]/W) ;
+    /* Compact the active set */
+    activeZones     = activeZones(notConvergedIndices);
+    BSqrActive      = BSqrActive(notConvergedIndices);
+    DActive         = DActive(notConvergedIndices);
+    EpActive        = EpActive(notConvergedIndices);
+    QDotBActive     = QDotBActive(notConvergedIndices);
+    QTildeSqrActive = QTildeSqrActive(notConvergedIndices);
+    WpActive        = WpActive(notConvergedIndices);
+    WpOldActive     = WpOldActive(notConvergedIndices);
+    errOldActive    = errOldActive(notConvergedIndices);
+  }
 
-  primGuess.vars[vars::U3] =   (gamma/(W + BSqr))
-                             * (QTildeCon[3] + QDotB*BCon[3]/W) ;
+  Wp = af::moddims(WpFlat, Wp.dims());
 
+  array primRecovered[vars::U3+1];
+  idealSolverPrimitives(BCon, QTildeCon,
+                        BSqr, D, QDotB, QTildeSqr, Wp,
+                        primRecovered
+                       );
 
-  // Trivial fake version for testing 
-  /*primGuess.vars[vars::RHO] = elem->rho;
-  primGuess.vars[vars::U]   = elem->u;
-  primGuess.vars[vars::U1]  = elem->u1;
-  primGuess.vars[vars::U2]  = elem->u2;
-  primGuess.vars[vars::U3]  = elem->u3;*/
+  /* Flag zones where the inversion produced unusable values, whether or not
+   * the iteration converged */
+  array unphysical =    af::isNaN(primRecovered[vars::RHO])
+                     || af::isInf(primRecovered[vars::RHO])
+                     || af::isNaN(primRecovered[vars::U])
+                     || af::isInf(primRecovered[vars::U])
+                     || (Wp + D <= 0.);
+  for (int var=vars::U1; var <= vars::U3; var++)
+  {
+    unphysical = unphysical || af::isNaN(primRecovered[var])
+                            || af::isInf(primRecovered[var]);
+  }
+
+  idealSolverFailures = af::moddims(statusFlat, Wp.dims());
+  idealSolverFailures = af::select(unphysical, 
+                                   (double)idealSolverStatus::UNPHYSICAL,
+                                   idealSolverFailures
+                                  );
+  idealSolverFailures.eval();
+  idealSolverZoneIters = af::moddims(itersFlat, Wp.dims());
 
-  //for (int var=0; var <= vars::U3; var++)
-  //{
-  //  primGuess.vars[var].eval();
-  //}
+  /* Zones that failed keep the guess (the last good state of the zone)
+   * until fixupFailedZones(). select() is needed instead of a multiplicative
+   * mask since the failed values may be NaN. */
+  array failed = idealSolverFailures != idealSolverStatus::CONVERGED;
 
   std::vector<af::array *> arraysThatNeedEval{};
   for (int var=0; var <= vars::U3; var++)
   {
+    primGuess.vars[var] = af::select(failed,
+                                     primGuess.vars[var],
+                                     primRecovered[var]
+                                    );
     arraysThatNeedEval.push_back(&primGuess.vars[var]);
   }                       
+  /* The guess is read and overwritten */
+  PROFILE_BYTES(  2.*profiler::arrayBytes(arraysThatNeedEval)
+                + profiler::arrayBytes(vars::U3+1, cons->vars)
+                + profiler::arrayBytes(3, &primGuess.vars[vars::B1])
+               );
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
   
   return;
 }
 
+/* Fix-up of the zones where the last ideal solve failed, as fixup_utoprim()
+ * in harm: the fluid primitives of a failed zone of the domain become the
+ * average of those of its converged neighbours, over the 3, 3x3 or 3x3x3
+ * block around it. Ghost zones do not count as neighbours, and a zone with
+ * no converged neighbour keeps the guess. The magnetic field is left alone;
+ * the floors are applied afterwards in the problem diagnostics. */
+void timeStepper::fixupFailedZones(grid &primFixup)
+{
+  af::seq domainX1 = *primFixup.domainX1;
+  af::seq domainX2 = *primFixup.domainX2;
+  af::seq domainX3 = *primFixup.domainX3;
+
+  array inDomain = af::constant(0., primFixup.vars[0].dims(), f64);
+  inDomain(domainX1, domainX2, domainX3) = 1.;
+  array converged =
+    inDomain*(idealSolverFailures == idealSolverStatus::CONVERGED);
+  array failed    =
+    inDomain*(idealSolverFailures != idealSolverStatus::CONVERGED);
+  if (af::count<double>(failed) == 0)
+  {
+    return;
+  }
+
+  /* Convolving with the block, without its center, sums over the
+   * neighbours; the zero padding of convolve adds nothing at the edges */
+  const int blockN2 = (primFixup.dim > 1 ? 3 : 1);
+  const int blockN3 = (primFixup.dim > 2 ? 3 : 1);
+  array block = af::constant(1., 3, blockN2, blockN3, f64);
+  block(1, blockN2/2, blockN3/2) = 0.;
+
+  array numConverged = convolve(converged, block);
+  array fixable      = failed > 0. && numConverged > 0.;
+
+  std::vector<af::array *> arraysThatNeedEval{};
+  for (int var=0; var <= vars::U3; var++)
+  {
+    /* select() since the values of failed zones may be NaN */
+    array convergedValues = af::select(converged > 0., primFixup.vars[var], 0.);
+    array average         =   convolve(convergedValues, block)
+                            / af::max(numConverged, 1.);
+
+    primFixup.vars[var] = af::select(fixable, average, primFixup.vars[var]);
+    arraysThatNeedEval.push_back(&primFixup.vars[var]);
+  }
+  PROFILE_BYTES(3.*profiler::arrayBytes(arraysThatNeedEval));
+  af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
+}
+
+/* Original fixed-iteration inversion: one Halley step followed by a single
+ * secant step in every zone, with no convergence check. Kept as the reference
+ * for benchmarkIdealSolver(). */
+void timeStepper::idealSolverFixedIter(grid &primGuess)
+{
+  elem->set(primGuess, *geomCenter);
+
+  array BCon[NDIM], QTildeCon[NDIM];
+  array BSqr, D, Ep, QDotB, QTildeSqr, Wp;
+  idealSolverInvariants(*elem, *geomCenter, *cons,
+                        BCon, QTildeCon,
+                        BSqr, D, Ep, QDotB, QTildeSqr, Wp
+                       );
+
+  array err1;
+  array Wp1 = Wp;
+  Wp  = Wp + idealSolverHalleyStep(BSqr, D, Ep, QDotB, QTildeSqr, Wp, err1);
+  array err = errFunc(BSqr, D, Ep, QDotB, QTildeSqr, Wp);
+
+  array dW = (Wp1 - Wp)*err/(err - err1);
+  Wp = Wp + af::max( af::min(dW, 2.0*Wp), -0.5*Wp );
+
+  array primRecovered[vars::U3+1];
+  idealSolverPrimitives(BCon, QTildeCon,
+                        BSqr, D, QDotB, QTildeSqr, Wp,
+                        primRecovered
+                       );
+
+  std::vector<af::array *> arraysThatNeedEval{};
+  for (int var=0; var <= vars::U3; var++)
+  {
+    primGuess.vars[var] = primRecovered[var];
+    arraysThatNeedEval.push_back(&primGuess.vars[var]);
+  }                       
+  /* The guess is read and overwritten */
+  PROFILE_BYTES(  2.*profiler::arrayBytes(arraysThatNeedEval)
+                + profiler::arrayBytes(vars::U3+1, cons->vars)
+                + profiler::arrayBytes(3, &primGuess.vars[vars::B1])
+               );
+  af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
+}
+
+void timeStepper::benchmarkIdealSolver(const int numEvals)
+{
+  /* Invert cons using primHalfStep as the guess, as is done in the full step.
+   * primGuessPlusEps is only used by the nonlinear solver and is free here. */
+  double numZones = prim->N1Total * prim->N2Total * prim->N3Total;
+
+  double timeElapsed[2];
+  for (int solverVersion=0; solverVersion < 2; solverVersion++)
+  {
+    af::sync();
+    af::timer benchmarkTimer = af::timer::start();
+    for (int n=0; n < numEvals; n++)
+    {
+      for (int var=0; var < prim->numVars; var++)
+      {
+        primGuessPlusEps->vars[var] = primHalfStep->vars[var];
+      }
+      if (solverVersion==0)
+      {
+        idealSolverFixedIter(*primGuessPlusEps);
+      }
+      else
+      {
+        idealSolver(*primGuessPlusEps);
+      }
+    }
+    af::sync();
+    timeElapsed[solverVersion] = af::timer::stop(benchmarkTimer);
+  }
+
+  double numFailures = 
+    af::count<double>(idealSolverFailures(domainX1, domainX2, domainX3));
+
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+  PetscPrintf(PETSC_COMM_WORLD, "    ---Ideal solver benchmark--- \n");
+  PetscPrintf(PETSC_COMM_WORLD, "     Fixed iterations    : %g zones/sec/proc\n",
+                                 numZones*numEvals/timeElapsed[0]
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "     Converged           : %g zones/sec/proc, %d iters, %g failed zones\n",
+                                 numZones*numEvals/timeElapsed[1],
+                                 idealSolverIters, numFailures
+             );
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+}
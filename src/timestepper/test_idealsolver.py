@@ -0,0 +1,153 @@
+import mpi4py, petsc4py
+from petsc4py import PETSc
+import numpy as np
+import pytest
+import gridPy
+import geometryPy
+import boundaryPy
+import timeStepperPy
+
+petsc4py.init()
+petscComm  = petsc4py.PETSc.COMM_WORLD
+comm = petscComm.tompi4py()
+rank = comm.Get_rank()
+numProcs = comm.Get_size()
+
+# getIdealSolverFailures() goes through a grid of its own, whose
+# decomposition only matches that of the time stepper on one rank
+assert numProcs == 1, 'run with mpirun -np 1'
+
+N1  = int(pytest.config.getoption('N1'))
+N2  = int(pytest.config.getoption('N2'))
+N3  = int(pytest.config.getoption('N3'))
+dim = int(pytest.config.getoption('dim'))
+
+blackHoleSpin = float(pytest.config.getoption('blackHoleSpin'))
+hSlope        = float(pytest.config.getoption('hSlope'))
+numGhost = 3
+
+X1Start = 0.; X1End = 1.
+X2Start = 0.; X2End = 1.
+X3Start = 0.; X3End = 1.
+
+time = 0.
+dt   = 0.002
+numVars = 8
+RHO, U, U1, U2, U3, B1, B2, B3 = range(numVars)
+fluidVars = [RHO, U, U1, U2, U3]
+
+# idealSolverStatus in params.hpp
+CONVERGED, NOT_CONVERGED, UNPHYSICAL = 0, 1, 2
+
+ts = timeStepperPy.timeStepperPy(N1, N2, N3,
+                                 dim, numVars, numGhost,
+                                 time, dt,
+                                 boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                 boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                 boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                 geometryPy.MINKOWSKI, blackHoleSpin, hSlope,
+                                 X1Start, X1End,
+                                 X2Start, X2End,
+                                 X3Start, X3End
+                                )
+
+shape = ts.prim.getVars().shape
+domain = (slice(ts.prim.numGhostX3, shape[1] - ts.prim.numGhostX3),
+          slice(ts.prim.numGhostX2, shape[2] - ts.prim.numGhostX2),
+          slice(ts.prim.numGhostX1, shape[3] - ts.prim.numGhostX1)
+         )
+
+def knownStates():
+  """Smooth, physical states: mildly relativistic flow, magnetization
+  b^2/rho up to ~0.1"""
+  np.random.seed(42)
+  prim = np.zeros(shape)
+  prim[RHO] = np.random.uniform(0.5, 1.5, shape[1:])
+  prim[U]   = np.random.uniform(0.1, 1., shape[1:])
+  for var in [U1, U2, U3]:
+    prim[var] = np.random.uniform(-0.5, 0.5, shape[1:])
+  for var in [B1, B2, B3]:
+    prim[var] = np.random.uniform(-0.2, 0.2, shape[1:])
+  return prim
+
+def solveFrom(exact, guess, corruptCons=None):
+  """Conserved variables of exact, optionally corrupted, then the ideal
+  solver from guess. Returns the primitives and the status of every zone of
+  the domain."""
+  ts.prim.setVars(exact)
+  ts.computeCons(ts.prim)
+  if corruptCons is not None:
+    cons = ts.cons.getVars()
+    corruptCons(cons)
+    ts.cons.setVars(cons)
+
+  ts.prim.setVars(guess)
+  ts.idealSolver(ts.prim)
+  return ts.prim.getVars(), ts.getIdealSolverFailures()
+
+def test_convergence():
+  exact = knownStates()
+  guess = exact.copy()
+  for var in fluidVars:
+    guess[var] *= 1.05
+
+  prim, failures = solveFrom(exact, guess)
+
+  assert np.all(failures[domain] == CONVERGED)
+  for var in fluidVars:
+    error = np.abs(prim[var][domain] - exact[var][domain])
+    assert np.max(error/np.abs(exact[var][domain]).max()) < 1e-8, \
+      'variable %d not recovered' % var
+
+# Domain zones whose conserved variables are corrupted, away from the edges
+# of the domain so that all their neighbours are in it
+def failedZones():
+  k = ts.prim.numGhostX3 + (N3//2 if dim > 2 else 0)
+  j = ts.prim.numGhostX2 + (N2//2 if dim > 1 else 0)
+  return [(k, j, ts.prim.numGhostX1 + N1//4),
+          (k, j, ts.prim.numGhostX1 + N1//2)
+         ]
+
+def corruptZones(cons):
+  k, j, i = failedZones()[0]
+  cons[U, k, j, i] = np.nan
+  k, j, i = failedZones()[1]
+  cons[RHO, k, j, i] = np.inf
+
+def test_failure_statuses_and_mask():
+  exact = knownStates()
+  prim, failures = solveFrom(exact, exact, corruptZones)
+
+  mask = np.zeros(shape[1:], dtype=bool)
+  for zone in failedZones():
+    mask[zone] = True
+    assert failures[zone] == UNPHYSICAL, \
+      'zone %s has status %g' % (str(zone), failures[zone])
+
+  assert np.all(failures[domain][mask[domain] == False] == CONVERGED)
+
+def test_fixup_averages_converged_neighbours():
+  exact = knownStates()
+  prim, failures = solveFrom(exact, exact, corruptZones)
+
+  ts.fixupFailedZones(ts.prim)
+  fixed = ts.prim.getVars()
+
+  for zone in failedZones():
+    k, j, i = zone
+    neighbours = (slice(k-1, k+2) if dim > 2 else slice(k, k+1),
+                  slice(j-1, j+2) if dim > 1 else slice(j, j+1),
+                  slice(i-1, i+2)
+                 )
+    for var in fluidVars:
+      block = prim[var][neighbours]
+      average = (block.sum() - prim[var][zone])/(block.size - 1)
+      assert np.abs(fixed[var][zone] - average) < 1e-12*np.abs(average), \
+        'variable %d of zone %s is not the neighbour average' % (var, zone)
+    for var in [B1, B2, B3]:
+      assert fixed[var][zone] == prim[var][zone]
+
+  # Converged zones are left alone
+  converged = (failures == CONVERGED)
+  for var in range(numVars):
+    assert np.all(fixed[var][converged] == prim[var][converged])
@@ -0,0 +1,180 @@
+import mpi4py, petsc4py
+from mpi4py import MPI
+from petsc4py import PETSc
+import numpy as np
+import pytest
+import os
+import shutil
+import tempfile
+import gridPy
+import geometryPy
+import boundaryPy
+import timeStepperPy
+
+petsc4py.init()
+petscComm  = petsc4py.PETSc.COMM_WORLD
+comm = petscComm.tompi4py()
+rank = comm.Get_rank()
+numProcs = comm.Get_size()
+
+# The checkpoint has half the zones of N1 x N2 x N3; it is prolonged by
+# ratios 2 and 3/2
+N1  = int(pytest.config.getoption('N1'))
+N2  = int(pytest.config.getoption('N2'))
+N3  = int(pytest.config.getoption('N3'))
+dim = int(pytest.config.getoption('dim'))
+sourceN = [N1//2, N2//2 if dim > 1 else 1, N3//2 if dim > 2 else 1]
+assert all(n % 2 == 0 for n in sourceN[:dim]), 'N1, N2, N3 must be 4k'
+
+blackHoleSpin = float(pytest.config.getoption('blackHoleSpin'))
+hSlope        = float(pytest.config.getoption('hSlope'))
+numGhost = 3
+
+X1Start = 0.; X1End = 1.
+X2Start = 0.; X2End = 1.
+X3Start = 0.; X3End = 1.
+
+time = 0.
+dt   = 0.002
+numVars = 8
+RHO, U, U1, U2, U3, B1, B2, B3 = range(numVars)
+
+# Variables reconstructed zone by zone, whose volume integrals are conserved
+conservedVars = [RHO, U, U1, U2, U3] + ([B3] if dim == 2 else [])
+
+outputDir = comm.bcast(tempfile.mkdtemp() if rank == 0 else None, root=0)
+
+def teardown_module(module):
+  comm.Barrier()
+  if rank == 0:
+    shutil.rmtree(outputDir)
+
+def domain(grid):
+  return (slice(grid.numGhostX3, grid.N3Total - grid.numGhostX3),
+          slice(grid.numGhostX2, grid.N2Total - grid.numGhostX2),
+          slice(grid.numGhostX1, grid.N1Total - grid.numGhostX1)
+         )
+
+def zoneCenters(grid):
+  """X1, X2, X3 of the local zones of grid, ghost zones included, on the
+  unit domain"""
+  N = [grid.N1, grid.N2, grid.N3]
+  start = [grid.iLocalStart, grid.jLocalStart, grid.kLocalStart]
+  numGhostX = [grid.numGhostX1, grid.numGhostX2, grid.numGhostX3]
+  total = [grid.N1Total, grid.N2Total, grid.N3Total]
+  X = [(np.arange(total[d]) - numGhostX[d] + start[d] + 0.5)/N[d]
+       for d in range(3)
+      ]
+  X3, X2, X1 = np.meshgrid(X[2], X[1], X[0], indexing='ij')
+  return X1, X2, X3
+
+def writeCheckpoint():
+  """Smooth fields, a jump in density, and a field that is divergence free
+  in the continuum"""
+  source = gridPy.gridPy(sourceN[0], sourceN[1], sourceN[2],
+                         dim, numVars, numGhost,
+                         True, True, True
+                        )
+  X1, X2, X3 = zoneCenters(source)
+  prim = np.zeros(source.getVars().shape)
+  twoPi = 2.*np.pi
+  prim[RHO] = 1. + 0.3*np.sin(twoPi*X1)*np.cos(twoPi*X2) + 0.5*(X1 > 0.37)
+  prim[U]   = 0.5 + 0.2*np.cos(twoPi*(X1 + X2 + X3))
+  prim[U1]  = 0.1*np.sin(twoPi*X2)
+  prim[U2]  = 0.1*np.sin(twoPi*X3) + 0.05*np.cos(twoPi*X1)
+  prim[U3]  = 0.1*np.cos(twoPi*X1)
+  prim[B1]  = 0.1*np.sin(twoPi*X2) + 0.05*np.cos(twoPi*X3)
+  prim[B2]  = 0.1*np.sin(twoPi*X1) + 0.05*np.sin(twoPi*X3)
+  prim[B3]  = 0.1*np.cos(twoPi*X1)*np.sin(twoPi*X2)
+  source.setVars(prim)
+
+  fileName = os.path.join(outputDir,
+                          'checkpoint_%d_%d_%d.h5' % tuple(sourceN)
+                         )
+  source.dump('primitives', fileName)
+  return fileName, prim[(slice(None),) + domain(source)]
+
+def prolong(ratio):
+  N = [int(n*ratio) if d < dim else 1 for d, n in enumerate(sourceN)]
+  ts = timeStepperPy.timeStepperPy(N[0], N[1], N[2],
+                                   dim, numVars, numGhost,
+                                   time, dt,
+                                   boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                   boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                   boundaryPy.PERIODIC, boundaryPy.PERIODIC,
+                                   geometryPy.MINKOWSKI, blackHoleSpin, hSlope,
+                                   X1Start, X1End,
+                                   X2Start, X2End,
+                                   X3Start, X3End
+                                  )
+  fileName, sourcePrim = writeCheckpoint()
+  ts.prolongRestart(fileName, sourceN)
+  ts.primOld.communicate()
+  return ts, sourcePrim
+
+def divB(ts, prim):
+  """The corner stencil of computeDivB(), in any dimension: differences of
+  g B^i across the faces of the dual zone, averaged over the other
+  directions"""
+  g  = ts.geomCenter.g
+  dX = [ts.XCoords.dX1, ts.XCoords.dX2, ts.XCoords.dX3]
+  div = np.zeros(g.shape)
+  for d in range(dim):
+    axis = 2 - d
+    gB = g*prim[B1 + d]
+    difference = (gB - np.roll(gB, 1, axis))/dX[d]
+    for other in range(dim):
+      if other != d:
+        difference = 0.5*(difference + np.roll(difference, 1, 2 - other))
+    div += difference
+  return div
+
+def interiorCorners(grid):
+  """Corners at the lower end of the local zones that are not on the
+  boundary of the domain, where the potential is not periodic"""
+  start = [grid.kLocalStart, grid.jLocalStart, grid.iLocalStart]
+  mask = np.zeros([grid.N3Local, grid.N2Local, grid.N1Local], dtype=bool)
+  interior = tuple(slice(1 if (start[a] == 0 and 2 - a < dim) else 0, None)
+                   for a in range(3)
+                  )
+  mask[interior] = True
+  return mask
+
+def volumeIntegral(values, zoneVolume):
+  return comm.allreduce(np.sum(values))*zoneVolume
+
+@pytest.mark.parametrize('ratio', [2., 1.5])
+def test_prolongation_conserves_primitives(ratio):
+  ts, sourcePrim = prolong(ratio)
+  prim = ts.primOld.getVars()[(slice(None),) + domain(ts.primOld)]
+
+  sourceVolume = 1./np.prod(sourceN)
+  volume = ts.XCoords.dX1*ts.XCoords.dX2*ts.XCoords.dX3
+  for var in conservedVars:
+    expected = volumeIntegral(sourcePrim[var], sourceVolume)
+    integral = volumeIntegral(prim[var], volume)
+    scale = volumeIntegral(np.abs(sourcePrim[var]), sourceVolume)
+    assert abs(integral - expected) < 1e-12*scale, \
+      'variable %d: %g instead of %g' % (var, integral, expected)
+
+@pytest.mark.parametrize('ratio', [2., 1.5])
+def test_prolongation_divB(ratio):
+  ts, sourcePrim = prolong(ratio)
+  prim = ts.primOld.getVars()
+
+  div = divB(ts, prim)
+  if dim == 2:
+    ts.computeDivB(ts.primOld)
+    assert np.allclose(ts.divB.getVars()[0][domain(ts.primOld)],
+                       div[domain(ts.primOld)], rtol=0., atol=1e-12
+                      )
+
+  div = div[domain(ts.primOld)][interiorCorners(ts.primOld)]
+  BScale = comm.allreduce(np.max(np.abs(sourcePrim[B1:B3+1])),
+                          op=MPI.MAX
+                         )
+  dXMin = min([ts.XCoords.dX1, ts.XCoords.dX2, ts.XCoords.dX3][:dim])
+  maxDivB = comm.allreduce(np.max(np.abs(div)) if div.size > 0 else 0.,
+                           op=MPI.MAX
+                          )
+  assert maxDivB < 1e-12*BScale/dXMin, 'max |divB| = %g' % maxDivB
@@ -9,12 +9,11 @@ cdef class timeStepperPy(object):
   cdef timeStepper *timeStepperPtr
   cdef coordinatesGridPy XCoords
   cdef geometryPy geomCenter
-  cdef geometryPy geomLeft, geomRight
-  cdef geometryPy geomTop, geomBottom
-  cdef geometryPy geomFront, geomBack
+  cdef geometryPy geomFaceX1, geomFaceX2, geomFaceX3
   cdef gridPy prim, primOld, primHalfStep
   cdef gridPy fluxesX1, fluxesX2, fluxesX3
   cdef gridPy divFluxes
+  cdef gridPy cons
   cdef gridPy emfX1, emfX2, emfX3
   cdef gridPy sourcesExplicit
   cdef gridPy divB
@@ -79,19 +79,20 @@ cdef class timeStepperPy(object):
     self.sourcesExplicit = \
         gridPy.createGridPyFromGridPtr(self.timeStepperPtr.sourcesExplicit)
 
+    self.cons = \
+        gridPy.createGridPyFromGridPtr(self.timeStepperPtr.cons)
+
     self.divB = \
         gridPy.createGridPyFromGridPtr(self.timeStepperPtr.divB)
 
     self.geomCenter = \
         geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomCenter)
-    self.geomLeft = \
-        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomLeft)
-    self.geomRight = \
-        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomRight)
-    self.geomBottom = \
-        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomBottom)
-    self.geomTop = \
-        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomTop)
+    self.geomFaceX1 = \
+        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomFaces[0])
+    self.geomFaceX2 = \
+        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomFaces[1])
+    self.geomFaceX3 = \
+        geometryPy.createGeometryPyFromGeometryPtr(self.timeStepperPtr.geomFaces[2])
 
     self.elem = \
         fluidElementPy.createFluidElementPyFromElemPtr(self.timeStepperPtr.elem)
@@ -112,21 +113,17 @@ cdef class timeStepperPy(object):
     def __get__(self):
      return self.geomCenter
 
-  property geomRight:
-    def __get__(self):
-     return self.geomRight
-
-  property geomLeft:
+  property geomFaceX1:
     def __get__(self):
-     return self.geomLeft
+     return self.geomFaceX1
 
-  property geomBottom:
+  property geomFaceX2:
     def __get__(self):
-     return self.geomBottom
+     return self.geomFaceX2
 
-  property geomTop:
+  property geomFaceX3:
     def __get__(self):
-     return self.geomTop
+     return self.geomFaceX3
 
   property prim:
     def __get__(self):
@@ -176,37 +173,55 @@ cdef class timeStepperPy(object):
     def __get__(self):
      return self.divB
 
+  property cons:
+    def __get__(self):
+     return self.cons
+
 
   def fluxCT(self):
-     cdef int numReads  = 0
-     cdef int numWrites = 0
-     self.timeStepperPtr.fluxCT(numReads, numWrites)
-     return numReads, numWrites
+     self.timeStepperPtr.fluxCT()
 
   def computeDivB(self, gridPy prim):
-     cdef int numReads  = 0
-     cdef int numWrites = 0
-     self.timeStepperPtr.computeDivB(prim.getGridPtr()[0],
-                                     numReads, numWrites
-                                    )
-     return numReads, numWrites
+     self.timeStepperPtr.computeDivB(prim.getGridPtr()[0])
 
   def computeEMF(self):
-     cdef int numReads  = 0
-     cdef int numWrites = 0
-     self.timeStepperPtr.computeEMF(numReads, numWrites)
-     return numReads, numWrites
+     self.timeStepperPtr.computeEMF()
 
   def timeStep(self):
-      cdef int numReads  = 0
-      cdef int numWrites = 0
-      self.timeStepperPtr.timeStep(numReads, numWrites)
-      return numReads, numWrites
+      self.timeStepperPtr.timeStep()
+
+  def prolongRestart(self, fileName, sourceN):
+    """Fill primOld from the "primitives" of fileName, a grid of sourceN[0] x
+    sourceN[1] x sourceN[2] zones, see prolongation.cpp"""
+    cdef int N[3]
+    for d in range(3):
+      N[d] = sourceN[d]
+    self.timeStepperPtr.prolongRestart(fileName.encode('utf-8'), N)
 
   def computeDivOfFluxes(self, gridPy prim):
-    cdef int numReads  = 0
-    cdef int numWrites = 0
-    self.timeStepperPtr.computeDivOfFluxes(prim.getGridPtr()[0],
-                                           numReads, numWrites
-                                          )
-    return numReads, numWrites
+    self.timeStepperPtr.computeDivOfFluxes(prim.getGridPtr()[0])
+
+  def computeCons(self, gridPy prim):
+    """Conserved variables of prim, in cons"""
+    self.timeStepperPtr.elem.set(prim.getGridPtr()[0],
+                                 self.timeStepperPtr.geomCenter[0]
+                                )
+    self.timeStepperPtr.elem.computeFluxes(0, self.timeStepperPtr.cons[0])
+
+  def idealSolver(self, gridPy primGuess):
+    self.timeStepperPtr.idealSolver(primGuess.getGridPtr()[0])
+
+  def fixupFailedZones(self, gridPy prim):
+    self.timeStepperPtr.fixupFailedZones(prim.getGridPtr()[0])
+
+  def getIdealSolverFailures(self):
+    """Status of the last ideal solve in each zone, see idealSolverStatus in
+    params.hpp. Goes through a grid of its own, so on one rank only."""
+    cdef gridPy failures = gridPy(self.timeStepperPtr.N1,
+                                  self.timeStepperPtr.N2,
+                                  self.timeStepperPtr.N3,
+                                  self.timeStepperPtr.dim, 1,
+                                  self.timeStepperPtr.numGhost
+                                 )
+    failures.getGridPtr().vars[0] = self.timeStepperPtr.idealSolverFailures
+    return failures.getVars()[0]
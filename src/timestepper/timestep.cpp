@@ -1,134 +1,183 @@
 #include "timestepper.hpp"
 
-void timeStepper::timeStep(int &numReads, int &numWrites)
+void timeStepper::timeStep()
 {
+  PROFILE_BEGIN("step");
   af::timer timeStepTimer = af::timer::start();
+  threads::resetThreadTimes();
   PetscPrintf(PETSC_COMM_WORLD, "  Time = %f, dt = %f\n\n", time, dt);
-  int numReadsDt, numWritesDt;
-  computeDt(numReadsDt, numWritesDt);
+  PROFILE_BEGIN("dt");
+  af::timer dtTimer = af::timer::start();
+  computeDt();
+  double dtTime = af::timer::stop(dtTimer);
+  PROFILE_END();
 
   /* First take a half step */
   PetscPrintf(PETSC_COMM_WORLD, "  ---Half step--- \n");
+  PROFILE_BEGIN("half step");
   af::timer halfStepTimer = af::timer::start();
 
   currentStep = timeStepperSwitches::HALF_STEP;
   /* Apply boundary conditions on primOld */
+  PROFILE_BEGIN("boundaries");
   af::timer boundaryTimer = af::timer::start();
   boundaries::applyBoundaryConditions(boundaryLeft, boundaryRight,
                                       boundaryTop,  boundaryBottom,
                                       boundaryFront, boundaryBack,
                                       *primOld
                                      );
-  setProblemSpecificBCs(numReads,numWrites);
+  setProblemSpecificBCs();
   double boundaryTime = af::timer::stop(boundaryTimer);
+  PROFILE_END();
 
-  int numReadsElemSet, numWritesElemSet;
-  int numReadsComputeFluxes, numWritesComputeFluxes;
+  PROFILE_BEGIN("elem");
   af::timer elemOldTimer = af::timer::start();
-  elemOld->set(*primOld, *geomCenter,
-               numReadsElemSet, numWritesElemSet
-              );
+  elemOld->set(*primOld, *geomCenter);
   double elemOldTime = af::timer::stop(elemOldTimer);
+  PROFILE_END();
 
-  af::timer consOldTimer = af::timer::start();
-  elemOld->computeFluxes(0, *consOld, 
-                         numReadsComputeFluxes, numWritesComputeFluxes
-                        );
-  numReads  = numReadsElemSet  + numReadsComputeFluxes;
-  numWrites = numWritesElemSet + numWritesComputeFluxes; 
-  double consOldTime = af::timer::stop(consOldTimer);
-
-  int numReadsExplicitSouces, numWritesExplicitSouces;
-  af::timer explicitSourcesTimer = af::timer::start();
   double dX[3];
   dX[0] = XCoords->dX1;
   dX[1] = XCoords->dX2;
   dX[2] = XCoords->dX3;
-  elemOld->computeExplicitSources(dX, *sourcesExplicit,
-                                  numReadsExplicitSouces,
-                                  numWritesExplicitSouces
-                                 );
-  numReads  += numReadsExplicitSouces;
-  numWrites += numWritesExplicitSouces;
-  double explicitSourcesTime = af::timer::stop(explicitSourcesTimer);
-
-  int numReadsImplicitSources, numWritesImplicitSources;
-  elemOld->computeImplicitSources(*sourcesImplicitOld,
-                                  elemOld->tau,
-                                  numReadsImplicitSources,
-                                  numWritesImplicitSources
+  af::timer consOldTimer;
+  af::timer explicitSourcesTimer;
+  double consOldTime, explicitSourcesTime;
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    /* elemOld is still set above: computeDt() and the diagnostics use it.
+     * There are no implicit sources in the ideal equations. */
+
+    PROFILE_BEGIN("cons");
+    consOldTimer = af::timer::start();
+    native::computeConsAndSources(*primOld, *geomCenter,
+                                  consOld, *sourcesExplicit
                                  );
-  numReads  += numReadsImplicitSources;
-  numWrites += numWritesImplicitSources;
+    consOldTime         = af::timer::stop(consOldTimer);
+    PROFILE_END();
+    explicitSourcesTime = 0.;
+  }
+  else
+#endif
+  {
+    PROFILE_BEGIN("cons");
+    consOldTimer = af::timer::start();
+    elemOld->computeFluxes(0, *consOld);
+    consOldTime = af::timer::stop(consOldTimer);
+    PROFILE_END();
+
+    PROFILE_BEGIN("explicit sources");
+    explicitSourcesTimer = af::timer::start();
+    elemOld->computeExplicitSources(dX, *sourcesExplicit);
+    explicitSourcesTime = af::timer::stop(explicitSourcesTimer);
+    PROFILE_END();
+
+    elemOld->computeImplicitSources(*sourcesImplicitOld,
+                                    elemOld->tau
+                                   );
+  }
 
+  PROFILE_BEGIN("fluxes");
   af::timer divFluxTimer = af::timer::start();
-  int numReadsDivFluxes, numWritesDivFluxes;
-  computeDivOfFluxes(*primOld, numReadsDivFluxes, numWritesDivFluxes);
-  numReads  += numReadsDivFluxes;
-  numWrites += numWritesDivFluxes;
+  computeDivOfFluxes(*primOld);
   double divFluxTime = af::timer::stop(divFluxTimer);
+  PROFILE_END();
 
   /* Set a guess for prim */
   for (int var=0; var < vars::numFluidVars; var++)
   {
     prim->vars[var] = primOld->vars[var];
-    numReads  += 1;
-    numWrites += 1;
   }
 
+  PROFILE_BEGIN("induction");
   af::timer inductionEqnTimer = af::timer::start();
-  cons->vars[vars::B1] = 
-    consOld->vars[vars::B1] - 0.5*dt*divFluxes->vars[vars::B1];
-  cons->vars[vars::B2] = 
-    consOld->vars[vars::B2] - 0.5*dt*divFluxes->vars[vars::B2];
-  cons->vars[vars::B3] = 
-    consOld->vars[vars::B3] - 0.5*dt*divFluxes->vars[vars::B3];
-
-  prim->vars[vars::B1] = cons->vars[vars::B1]/geomCenter->g;
-  prim->vars[vars::B1].eval();
-  prim->vars[vars::B2] = cons->vars[vars::B2]/geomCenter->g;
-  prim->vars[vars::B2].eval();
-  prim->vars[vars::B3] = cons->vars[vars::B3]/geomCenter->g;
-  prim->vars[vars::B3].eval();
+  if (!useNativeBackend)
+  {
+    cons->vars[vars::B1] = 
+      consOld->vars[vars::B1] - 0.5*dt*divFluxes->vars[vars::B1];
+    cons->vars[vars::B2] = 
+      consOld->vars[vars::B2] - 0.5*dt*divFluxes->vars[vars::B2];
+    cons->vars[vars::B3] = 
+      consOld->vars[vars::B3] - 0.5*dt*divFluxes->vars[vars::B3];
+
+    prim->vars[vars::B1] = cons->vars[vars::B1]/geomCenter->g;
+    prim->vars[vars::B1].eval();
+    prim->vars[vars::B2] = cons->vars[vars::B2]/geomCenter->g;
+    prim->vars[vars::B2].eval();
+    prim->vars[vars::B3] = cons->vars[vars::B3]/geomCenter->g;
+    prim->vars[vars::B3].eval();
+    PROFILE_BYTES(  profiler::arrayBytes(3, &prim->vars[vars::B1])
+                  + profiler::arrayBytes(3, &consOld->vars[vars::B1])
+                  + profiler::arrayBytes(3, &divFluxes->vars[vars::B1])
+                  + geomCenter->g.bytes()
+                 );
+
+    primGuessPlusEps->vars[vars::B1] = prim->vars[vars::B1];
+    primGuessPlusEps->vars[vars::B2] = prim->vars[vars::B2];
+    primGuessPlusEps->vars[vars::B3] = prim->vars[vars::B3];
+
+    primGuessLineSearchTrial->vars[vars::B1] = prim->vars[vars::B1];
+    primGuessLineSearchTrial->vars[vars::B2] = prim->vars[vars::B2];
+    primGuessLineSearchTrial->vars[vars::B3] = prim->vars[vars::B3];
+  }
   double inductionEqnTime = af::timer::stop(inductionEqnTimer);
-
-  primGuessPlusEps->vars[vars::B1] = prim->vars[vars::B1];
-  primGuessPlusEps->vars[vars::B2] = prim->vars[vars::B2];
-  primGuessPlusEps->vars[vars::B3] = prim->vars[vars::B3];
-
-  primGuessLineSearchTrial->vars[vars::B1] = prim->vars[vars::B1];
-  primGuessLineSearchTrial->vars[vars::B2] = prim->vars[vars::B2];
-  primGuessLineSearchTrial->vars[vars::B3] = prim->vars[vars::B3];
+  PROFILE_END();
 
   /* Solve dU/dt + div.F - S = 0 to get prim at n+1/2 */
   jacobianAssemblyTime = 0.;
   lineSearchTime       = 0.;
   linearSolverTime     = 0.;
   /* Use simple ideal solver if able and requested */
-  af::sync();
   af::timer solverTimer;
   af::timer stepConsTimer;
   double solverTime, stepConsTime;
-  if (params::conduction == 0 && 
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    /* Induction equation, fluid cons and the ideal solver in one pass */
+    stepConsTime = 0.;
+    PROFILE_BEGIN("solver");
+    solverTimer  = af::timer::start();
+    native::timeStepAndInvert(*consOld, *divFluxes, *sourcesExplicit,
+                              *geomCenter, 0.5*dt,
+                              *cons, *prim,
+                              idealSolverFailures, idealSolverZoneIters,
+                              idealSolverIters
+                             );
+    solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
+  }
+  else
+#endif
+  if (params::conduction == 0 &&
       params::viscosity == 0 &&
       params::solver == solvers::IDEAL)
   {
+    PROFILE_BEGIN("fluid cons");
     stepConsTimer = af::timer::start();
     timeStepFluidCons(0.5*dt);
-    af::sync();
     stepConsTime = af::timer::stop(stepConsTimer);
+    PROFILE_END();
 
-    int numreads, numwrites;
+    PROFILE_BEGIN("solver");
     solverTimer = af::timer::start();
-    idealSolver(*prim, numreads, numwrites);
-    af::sync();
+    idealSolver(*prim);
     solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
   } else {
+    PROFILE_BEGIN("solver");
     solverTimer = af::timer::start();
     solve(*prim);
     solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
   }
   //double solverTime = af::timer::stop(solverTimer);
+  zoneWork += idealSolverZoneIters;
+
+  PROFILE_BEGIN("fixup");
+  fixupFailedZones(*prim);
+  PROFILE_END();
 
   /* Copy solution to primHalfStepGhosted. WARNING: Right now
    * primHalfStep->vars[var] points to prim->vars[var]. Might need to do a deep
@@ -136,19 +185,22 @@ void timeStepper::timeStep(int &numReads, int &numWrites)
   for (int var=0; var < prim->numVars; var++)
   {
     primHalfStep->vars[var] = prim->vars[var];
-    numReads  += 1;
-    numWrites += 1;
   }
+  PROFILE_BEGIN("communication");
   af::timer halfStepCommTimer = af::timer::start();
   primHalfStep->communicate();
   double halfStepCommTime = af::timer::stop(halfStepCommTimer);
+  PROFILE_END();
 
+  PROFILE_BEGIN("diagnostics");
   af::timer halfStepDiagTimer = af::timer::start();
-  halfStepDiagnostics(numReads,numWrites);
+  halfStepDiagnostics();
   double halfStepDiagTime = af::timer::stop(halfStepDiagTimer);
+  PROFILE_END();
   /* Half step complete */
 
   double halfStepTime = af::timer::stop(halfStepTimer);
+  PROFILE_END();
 
   /*PetscPrintf(PETSC_COMM_WORLD, "\n");
   PetscPrintf(PETSC_COMM_WORLD, "    ---Performance report--- \n");
@@ -206,133 +258,188 @@ void timeStepper::timeStep(int &numReads, int &numWrites)
 
   /* Now take the full step */
   PetscPrintf(PETSC_COMM_WORLD, "  ---Full step--- \n");
-  af::sync();
+  PROFILE_BEGIN("full step");
   af::timer fullStepTimer = af::timer::start();
 
   currentStep = timeStepperSwitches::FULL_STEP;
   /* apply boundary conditions on primHalfStep */
+  PROFILE_BEGIN("boundaries");
   boundaryTimer = af::timer::start();
   boundaries::applyBoundaryConditions(boundaryLeft, boundaryRight,
                                       boundaryTop,  boundaryBottom,
                                       boundaryFront, boundaryBack,
                                       *primHalfStep
                                      );
-  setProblemSpecificBCs(numReads,numWrites);
-  af::sync();
+  setProblemSpecificBCs();
   boundaryTime = af::timer::stop(boundaryTimer);
+  PROFILE_END();
 
-  af::timer elemHalfStepTimer = af::timer::start();
-  elemHalfStep->set(*primHalfStep, *geomCenter,
-                    numReadsElemSet, numWritesElemSet
-                   );
-  numReads  += numReadsElemSet;
-  numWrites += numWritesElemSet; 
-  af::sync();
-  double elemHalfStepTime = af::timer::stop(elemHalfStepTimer);
-
-  explicitSourcesTimer = af::timer::start();
-  elemHalfStep->computeExplicitSources(dX, *sourcesExplicit,
-                                       numReadsExplicitSouces,
-                                       numWritesExplicitSouces
-                                      );
-  numReads  += numReadsExplicitSouces;
-  numWrites += numWritesExplicitSouces;
-  af::sync();
-  explicitSourcesTime = af::timer::stop(explicitSourcesTimer);
-
-  af::timer implicitSourcesTimer = af::timer::start();
-  elemOld->computeImplicitSources(*sourcesImplicitOld,
-                                  elemHalfStep->tau,
-                                  numReadsImplicitSources,
-                                  numWritesImplicitSources
+  double elemHalfStepTime, implicitSourcesTime;
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    elemHalfStepTime    = 0.;
+    implicitSourcesTime = 0.;
+
+    PROFILE_BEGIN("explicit sources");
+    explicitSourcesTimer = af::timer::start();
+    native::computeConsAndSources(*primHalfStep, *geomCenter,
+                                  NULL, *sourcesExplicit
                                  );
-  numReads  += numReadsImplicitSources;
-  numWrites += numWritesImplicitSources;
-  af::sync();
-  double implicitSourcesTime = af::timer::stop(implicitSourcesTimer);
+    explicitSourcesTime = af::timer::stop(explicitSourcesTimer);
+    PROFILE_END();
+  }
+  else
+#endif
+  {
+    PROFILE_BEGIN("elem");
+    af::timer elemHalfStepTimer = af::timer::start();
+    elemHalfStep->set(*primHalfStep, *geomCenter);
+    elemHalfStepTime = af::timer::stop(elemHalfStepTimer);
+    PROFILE_END();
+
+    PROFILE_BEGIN("explicit sources");
+    explicitSourcesTimer = af::timer::start();
+    elemHalfStep->computeExplicitSources(dX, *sourcesExplicit);
+    explicitSourcesTime = af::timer::stop(explicitSourcesTimer);
+    PROFILE_END();
+
+    PROFILE_BEGIN("implicit sources");
+    af::timer implicitSourcesTimer = af::timer::start();
+    elemOld->computeImplicitSources(*sourcesImplicitOld,
+                                    elemHalfStep->tau
+                                   );
+    implicitSourcesTime = af::timer::stop(implicitSourcesTimer);
+    PROFILE_END();
+  }
 
+  PROFILE_BEGIN("fluxes");
   divFluxTimer = af::timer::start();
-  computeDivOfFluxes(*primHalfStep, numReadsDivFluxes, numWritesDivFluxes);
-  numReads  += numReadsDivFluxes;
-  numWrites += numWritesDivFluxes;
-  af::sync();
+  computeDivOfFluxes(*primHalfStep);
   divFluxTime = af::timer::stop(divFluxTimer);
+  PROFILE_END();
 
+  PROFILE_BEGIN("induction");
   inductionEqnTimer = af::timer::start();
-  cons->vars[vars::B1] = 
-    consOld->vars[vars::B1] - dt*divFluxes->vars[vars::B1];
-  cons->vars[vars::B2] = 
-    consOld->vars[vars::B2] - dt*divFluxes->vars[vars::B2];
-  cons->vars[vars::B3] = 
-    consOld->vars[vars::B3] - dt*divFluxes->vars[vars::B3];
-
-  prim->vars[vars::B1] = cons->vars[vars::B1]/geomCenter->g;
-  prim->vars[vars::B1].eval();
-  prim->vars[vars::B2] = cons->vars[vars::B2]/geomCenter->g;
-  prim->vars[vars::B2].eval();
-  prim->vars[vars::B3] = cons->vars[vars::B3]/geomCenter->g;
-  prim->vars[vars::B3].eval();
-  
-  primGuessPlusEps->vars[vars::B1] = prim->vars[vars::B1];
-  primGuessPlusEps->vars[vars::B2] = prim->vars[vars::B2];
-  primGuessPlusEps->vars[vars::B3] = prim->vars[vars::B3];
-
-  primGuessLineSearchTrial->vars[vars::B1] = prim->vars[vars::B1];
-  primGuessLineSearchTrial->vars[vars::B2] = prim->vars[vars::B2];
-  primGuessLineSearchTrial->vars[vars::B3] = prim->vars[vars::B3];
-  af::sync();
+  if (!useNativeBackend)
+  {
+    cons->vars[vars::B1] = 
+      consOld->vars[vars::B1] - dt*divFluxes->vars[vars::B1];
+    cons->vars[vars::B2] = 
+      consOld->vars[vars::B2] - dt*divFluxes->vars[vars::B2];
+    cons->vars[vars::B3] = 
+      consOld->vars[vars::B3] - dt*divFluxes->vars[vars::B3];
+
+    prim->vars[vars::B1] = cons->vars[vars::B1]/geomCenter->g;
+    prim->vars[vars::B1].eval();
+    prim->vars[vars::B2] = cons->vars[vars::B2]/geomCenter->g;
+    prim->vars[vars::B2].eval();
+    prim->vars[vars::B3] = cons->vars[vars::B3]/geomCenter->g;
+    prim->vars[vars::B3].eval();
+    PROFILE_BYTES(  profiler::arrayBytes(3, &prim->vars[vars::B1])
+                  + profiler::arrayBytes(3, &consOld->vars[vars::B1])
+                  + profiler::arrayBytes(3, &divFluxes->vars[vars::B1])
+                  + geomCenter->g.bytes()
+                 );
+    
+    primGuessPlusEps->vars[vars::B1] = prim->vars[vars::B1];
+    primGuessPlusEps->vars[vars::B2] = prim->vars[vars::B2];
+    primGuessPlusEps->vars[vars::B3] = prim->vars[vars::B3];
+
+    primGuessLineSearchTrial->vars[vars::B1] = prim->vars[vars::B1];
+    primGuessLineSearchTrial->vars[vars::B2] = prim->vars[vars::B2];
+    primGuessLineSearchTrial->vars[vars::B3] = prim->vars[vars::B3];
+  }
   inductionEqnTime = af::timer::stop(inductionEqnTimer);
+  PROFILE_END();
 
   /* Solve dU/dt + div.F - S = 0 to get prim at n+1/2. NOTE: prim already has
    * primHalfStep as a guess */
   
   /* Use simple ideal solver if able and requested */
-  if (params::conduction == 0 && 
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    stepConsTime = 0.;
+    PROFILE_BEGIN("solver");
+    solverTimer  = af::timer::start();
+    native::timeStepAndInvert(*consOld, *divFluxes, *sourcesExplicit,
+                              *geomCenter, dt,
+                              *cons, *prim,
+                              idealSolverFailures, idealSolverZoneIters,
+                              idealSolverIters
+                             );
+    solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
+  }
+  else
+#endif
+  if (params::conduction == 0 &&
       params::viscosity == 0 &&
       params::solver == solvers::IDEAL)
   {
+    PROFILE_BEGIN("fluid cons");
     stepConsTimer = af::timer::start();
     timeStepFluidCons(dt);
-    af::sync();
     stepConsTime = af::timer::stop(stepConsTimer);
+    PROFILE_END();
 
-    int numreads, numwrites;
+    PROFILE_BEGIN("solver");
     solverTimer = af::timer::start();
-    idealSolver(*prim, numreads, numwrites);
-    af::sync();
+    idealSolver(*prim);
     solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
   } else {
     jacobianAssemblyTime = 0.;
     lineSearchTime       = 0.;
     linearSolverTime     = 0.;
+    PROFILE_BEGIN("solver");
     solverTimer = af::timer::start();
     solve(*prim);
     solverTime = af::timer::stop(solverTimer);
+    PROFILE_END();
   }
+  zoneWork += idealSolverZoneIters;
 
+  PROFILE_BEGIN("fixup");
+  fixupFailedZones(*prim);
+  PROFILE_END();
+
+  PROFILE_BEGIN("communication");
   af::timer fullStepCommTimer = af::timer::start();
   /* Copy solution to primOldGhosted */
   for (int var=0; var < prim->numVars; var++)
   {
     primOld->vars[var] = prim->vars[var];
-    numReads  += 1;
-    numWrites += 1;
   }
   /* Compute diagnostics */
   primOld->communicate();
-  af::sync();
   double fullStepCommTime = af::timer::stop(fullStepCommTimer);
+  PROFILE_END();
 
   time += dt;
+  stepNumber++;
+  PROFILE_BEGIN("diagnostics");
   af::timer fullStepDiagTimer = af::timer::start();
-  fullStepDiagnostics(numReads,numWrites);
-  af::sync();
+  fullStepDiagnostics();
   double fullStepDiagTime = af::timer::stop(fullStepDiagTimer);
+  PROFILE_END();
 
   /* done */
   double fullStepTime = af::timer::stop(fullStepTimer);
+  PROFILE_END();
   double timeStepTime = af::timer::stop(timeStepTimer);
+  PROFILE_END();
+
+  /* Cost map for load balancing; time spent waiting on other ranks in
+   * computeDt() and communicate() is left out */
+  zoneWork += 1.;
+  zoneWork.eval();
+  zoneWorkTime += timeStepTime - dtTime - halfStepCommTime - fullStepCommTime;
 
+  /* Stages are not synced unless the profiler is on with profileSync, so
+   * asynchronous ArrayFire work is charged to the stage that next waits on
+   * it */
   PetscPrintf(PETSC_COMM_WORLD, "\n");
   PetscPrintf(PETSC_COMM_WORLD, "    ---Performance report--- \n");
   PetscPrintf(PETSC_COMM_WORLD, "     Boundary Conditions : %g secs, %g %\n",
@@ -353,6 +460,12 @@ void timeStepper::timeStep(int &numReads, int &numWrites)
   PetscPrintf(PETSC_COMM_WORLD, "     Divergence of fluxes: %g secs, %g %\n",
                                  divFluxTime, divFluxTime/fullStepTime * 100
              );
+  if (useNativeBackend && params::fluxTasks && !params::tiledFluxes)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "     |- Core utilization : %g %\n",
+                                   fluxTaskUtilization * 100
+               );
+  }
   PetscPrintf(PETSC_COMM_WORLD, "     Nonlinear solver    : %g secs, %g %\n",
                                  solverTime, solverTime/fullStepTime * 100
              );
@@ -387,6 +500,29 @@ void timeStepper::timeStep(int &numReads, int &numWrites)
   PetscPrintf(PETSC_COMM_WORLD, "     Full step time      : %g secs\n\n",
                                  fullStepTime
              );
+  /* Busy time of the threads of all ranks: the slowest thread of any rank
+   * against the mean over all threads */
+  double minThreadTime, avgThreadTime, maxThreadTime;
+  threads::getThreadTimes(minThreadTime, avgThreadTime, maxThreadTime);
+  int numProcs;
+  MPI_Comm_size(PETSC_COMM_WORLD, &numProcs);
+  MPI_Allreduce(MPI_IN_PLACE, &minThreadTime, 1, MPI_DOUBLE, MPI_MIN,
+                PETSC_COMM_WORLD
+               );
+  MPI_Allreduce(MPI_IN_PLACE, &avgThreadTime, 1, MPI_DOUBLE, MPI_SUM,
+                PETSC_COMM_WORLD
+               );
+  MPI_Allreduce(MPI_IN_PLACE, &maxThreadTime, 1, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+  avgThreadTime /= numProcs;
+  if (avgThreadTime > 0.)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "     Thread imbalance    : %g (max/mean over ranks), busy min/mean/max = %g/%g/%g secs\n",
+                                   maxThreadTime/avgThreadTime,
+                                   minThreadTime, avgThreadTime, maxThreadTime
+               );
+  }
   PetscPrintf(PETSC_COMM_WORLD, "   ---Performance / proc : %g Zone cycles/sec/proc\n",
                                  prim->N1Local
                                * prim->N2Local
@@ -398,14 +534,13 @@ void timeStepper::timeStep(int &numReads, int &numWrites)
              );
 }
 
-double timeStepper::computeDt(int &numReads, int &numWrites)
+double timeStepper::computeDt()
 {
   // Time step control
   array minSpeedTemp,maxSpeedTemp;
   array minSpeed,maxSpeed;
   elemOld->computeMinMaxCharSpeeds(directions::X1,
-                                   minSpeedTemp, maxSpeedTemp,
-                                   numReads,numWrites
+                                   minSpeedTemp, maxSpeedTemp
                                   );
   minSpeedTemp = minSpeedTemp/XCoords->dX1;
   maxSpeedTemp = maxSpeedTemp/XCoords->dX1;
@@ -414,8 +549,7 @@ double timeStepper::computeDt(int &numReads, int &numWrites)
   if(params::dim>1)
   {
     elemOld->computeMinMaxCharSpeeds(directions::X2,
-                                     minSpeedTemp, maxSpeedTemp,
-                                     numReads,numWrites
+                                     minSpeedTemp, maxSpeedTemp
                                     );
     minSpeedTemp = minSpeedTemp/XCoords->dX2;
     maxSpeedTemp = maxSpeedTemp/XCoords->dX2;
@@ -425,8 +559,7 @@ double timeStepper::computeDt(int &numReads, int &numWrites)
   if(params::dim>2)
   {
     elemOld->computeMinMaxCharSpeeds(directions::X3,
-                                     minSpeedTemp, maxSpeedTemp,
-                                     numReads,numWrites);
+                                     minSpeedTemp, maxSpeedTemp);
     minSpeedTemp = minSpeedTemp/XCoords->dX3;
     maxSpeedTemp = maxSpeedTemp/XCoords->dX3;
     maxSpeed    += af::max(maxSpeedTemp,af::abs(minSpeedTemp));
@@ -434,27 +567,11 @@ double timeStepper::computeDt(int &numReads, int &numWrites)
   array maxInvDt_af = af::max(af::max(af::max(maxSpeed,2),1),0);
   double maxInvDt = maxInvDt_af.host<double>()[0];
 
-  /* Use MPI to find minimum over all processors */
-  if (world_rank == 0) 
-  {
-    double temp; 
-    for(int i=1;i<world_size;i++)
-    {
-      MPI_Recv(&temp, 1, MPI_DOUBLE, i, i, PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
-      if( maxInvDt < temp)
-      {
-        maxInvDt = temp;
-      }
-    }
-  }
-  else
-  {
-    MPI_Send(&maxInvDt, 1, MPI_DOUBLE, 0, world_rank, PETSC_COMM_WORLD);
-  }
-  MPI_Barrier(PETSC_COMM_WORLD);
-  MPI_Bcast(&maxInvDt,1,MPI_DOUBLE,0,PETSC_COMM_WORLD);
-  MPI_Barrier(PETSC_COMM_WORLD);
-  
+  /* Maximum over all processors, with the checkpoint requests */
+  PROFILE_BEGIN("MPI_Allreduce");
+  reduceStepState(maxInvDt);
+  PROFILE_END();
+
   double newDt = params::CourantFactor/maxInvDt;
     
   if (newDt > params::maxDtIncrement*dt)
@@ -480,5 +597,10 @@ void timeStepper::timeStepFluidCons(const double dt
     arraysThatNeedEval.push_back(&cons->vars[var]);
   }
 
+  PROFILE_BYTES(  profiler::arrayBytes(arraysThatNeedEval)
+                + profiler::arrayBytes(vars::U3+1, consOld->vars)
+                + profiler::arrayBytes(vars::U3+1, divFluxes->vars)
+                + profiler::arrayBytes(vars::U3+1, sourcesExplicit->vars)
+               );
   af::eval(arraysThatNeedEval.size(), &arraysThatNeedEval[0]);
 }
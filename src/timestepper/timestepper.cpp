@@ -1,5 +1,7 @@
 #include "timestepper.hpp"
 #include <fstream>
+#include <sstream>
+#include <iterator>
 
 timeStepper::timeStepper(const int N1, 
                          const int N2,
@@ -30,9 +32,23 @@ timeStepper::timeStepper(const int N1,
   PetscPrintf(PETSC_COMM_WORLD,  " | |__| | | \\ \\ _| |_| |  | |\n");
   PetscPrintf(PETSC_COMM_WORLD,  "  \\_____|_|  \\_\\_____|_|  |_|\n");
   PetscPrintf(PETSC_COMM_WORLD,  "\n");
+
+  double phaseStart = MPI_Wtime();
   
   this->time = time;
   this->dt = dt;
+  stepNumber = 0;
+  wallTimeStart          = phaseStart;
+  wallTimeElapsed        = 0.;
+  lastCheckpointWallTime = 0.;
+  stopRequested            = 0;
+  checkpointRequested      = 0;
+  checkpointSignalsSeen    = 0;
+  checkpointSignalsHandled = 0;
+  if (params::checkpointOnSignal)
+  {
+    installCheckpointSignalHandlers();
+  }
   this->numGhost = numGhost;
   this->dim = dim;
   this->numVars = numVars;
@@ -82,13 +98,23 @@ timeStepper::timeStepper(const int N1,
   this->N2 = prim->N2;
   this->N3 = prim->N3;
   std::string deviceInfo = af::infoString();
+  endStartupPhase("grids", phaseStart);
   
-  double availableBandwidth = bandwidthTest(10000);
+  double availableBandwidth = nodeBandwidth();
+  profiler::setPeakBandwidth(availableBandwidth);
+  endStartupPhase("bandwidth probe", phaseStart);
+  char bandwidthInfo[64] = "not measured (see bandwidthProbe)";
+  if (availableBandwidth > 0.)
+  {
+    snprintf(bandwidthInfo, sizeof(bandwidthInfo), "%g GB/sec",
+             availableBandwidth
+            );
+  }
   PetscSynchronizedPrintf(PETSC_COMM_WORLD, 
-  "#### Rank %d of %d: System info ####\n %s \n  Local size       : %i x %i x %i\n  Memory Bandwidth : %g GB/sec\n\n",
+  "#### Rank %d of %d: System info ####\n %s \n  Local size       : %i x %i x %i\n  Memory Bandwidth : %s\n\n",
                           world_rank, world_size, deviceInfo.c_str(),
                           prim->N1Total, prim->N2Total, prim->N3Total,
-                          availableBandwidth
+                          bandwidthInfo
                          );  
   PetscSynchronizedFlush(PETSC_COMM_WORLD, PETSC_STDOUT);
 
@@ -225,67 +251,101 @@ timeStepper::timeStepper(const int N1,
                                 X2Start, X2End,
                                 X3Start, X3End
                                );
+  endStartupPhase("grids", phaseStart);
+
+  const int faceLocations[3] = {locations::LEFT,
+                                locations::BOTTOM,
+                                locations::BACK
+                               };
+  const char *faceNames[3] = {"LEFT", "BOTTOM", "BACK"};
+  /* The flat metric is made of constants, there is nothing to cache */
+  const bool cacheGeometry = params::geometryCache
+                          && metric != metrics::MINKOWSKI;
+  for (int d=0; d < dim; d++)
+  {
+    XCoords->setXCoords(faceLocations[d]);
+    std::string cacheFileName =
+      cacheGeometry ? geometryCacheFile(faceLocations[d]) : "";
+    if (cacheGeometry && geometryCacheFound(cacheFileName))
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "  Loading metric at %s face...",
+                  faceNames[d]
+                 );
+      geomFaces[d] = new geometry(metric,
+                                  blackHoleSpin,
+                                  hSlope,
+                                  *XCoords,
+                                  cacheFileName
+                                 );
+      endStartupPhase("metric at faces", phaseStart);
+    }
+    else
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at %s face...",
+                  faceNames[d]
+                 );
+      geomFaces[d] = new geometry(metric,
+                                  blackHoleSpin,
+                                  hSlope,
+                                  *XCoords
+                                 );
+      endStartupPhase("metric at faces", phaseStart);
+      if (cacheGeometry)
+      {
+        geomFaces[d]->dumpCache(cacheFileName);
+        endStartupPhase("geometry cache", phaseStart);
+      }
+    }
+    PetscPrintf(PETSC_COMM_WORLD, "done\n");
+  }
 
-  PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at LEFT face...");
-  XCoords->setXCoords(locations::LEFT);
-  geomLeft    = new geometry(metric,
-                             blackHoleSpin,
-                             hSlope, 
-                             *XCoords
-                            );
-  PetscPrintf(PETSC_COMM_WORLD, "done\n");
-
-  PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at RIGHT face...");
-  XCoords->setXCoords(locations::RIGHT);
-  geomRight   = new geometry(metric,
-                             blackHoleSpin,
-                             hSlope,
-                             *XCoords
-                            );
-  PetscPrintf(PETSC_COMM_WORLD, "done\n");
-
-  PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at BOTTOM face...");
-  XCoords->setXCoords(locations::BOTTOM);
-  geomBottom  = new geometry(metric,
-                             blackHoleSpin,
-                             hSlope,
-                             *XCoords
-                            );
-  PetscPrintf(PETSC_COMM_WORLD, "done\n");
-
-  PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at TOP face...");
-  XCoords->setXCoords(locations::TOP);
-  geomTop     = new geometry(metric,
-                             blackHoleSpin,
-                             hSlope, 
-                             *XCoords
-                            );
-  PetscPrintf(PETSC_COMM_WORLD, "done\n");
-
-  PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at zone CENTER...");
   XCoords->setXCoords(locations::CENTER);
-  geomCenter  = new geometry(metric,
-                             blackHoleSpin,
-                             hSlope,
-                             *XCoords
-                            );
-  PetscPrintf(PETSC_COMM_WORLD, "done\n");
-
-  PetscPrintf(PETSC_COMM_WORLD, "  Computing connections at zone CENTER...");
-  geomCenter->computeConnectionCoeffs();
-  PetscPrintf(PETSC_COMM_WORLD, "done\n\n");
+  std::string cacheFileName =
+    cacheGeometry ? geometryCacheFile(locations::CENTER) : "";
+  if (cacheGeometry && geometryCacheFound(cacheFileName))
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "  Loading metric and connections at zone CENTER..."
+               );
+    geomCenter  = new geometry(metric,
+                               blackHoleSpin,
+                               hSlope,
+                               *XCoords,
+                               cacheFileName
+                              );
+    endStartupPhase("metric at zone center", phaseStart);
+    PetscPrintf(PETSC_COMM_WORLD, "done\n\n");
+  }
+  else
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "  Generating metric at zone CENTER...");
+    geomCenter  = new geometry(metric,
+                               blackHoleSpin,
+                               hSlope,
+                               *XCoords
+                              );
+    endStartupPhase("metric at zone center", phaseStart);
+    PetscPrintf(PETSC_COMM_WORLD, "done\n");
+
+    PetscPrintf(PETSC_COMM_WORLD, "  Computing connections at zone CENTER...");
+    geomCenter->computeConnectionCoeffs();
+    endStartupPhase("connection coefficients", phaseStart);
+    PetscPrintf(PETSC_COMM_WORLD, "done\n\n");
+    if (cacheGeometry)
+    {
+      geomCenter->dumpCache(cacheFileName);
+      endStartupPhase("geometry cache", phaseStart);
+    }
+  }
+  for (int d=dim; d < 3; d++)
+  {
+    geomFaces[d] = geomCenter;
+  }
   /* XCoords set to locations::CENTER */
 
-  int numReads, numWrites;
-  elem          = new fluidElement(*prim, *geomCenter,
-                                   numReads, numWrites
-                                  ); /* n+1   */
-  elemOld       = new fluidElement(*primOld, *geomCenter,
-                                   numReads, numWrites
-                                  ); /* n     */
-  elemHalfStep  = new fluidElement(*primHalfStep, *geomCenter,
-                                   numReads, numWrites
-                                  ); /* n+1/2 */
+  elem          = new fluidElement(*prim, *geomCenter); /* n+1   */
+  elemOld       = new fluidElement(*primOld, *geomCenter); /* n     */
+  elemHalfStep  = new fluidElement(*primHalfStep, *geomCenter); /* n+1/2 */
 
   riemann = new riemannSolver(*prim, *geomCenter);
 
@@ -375,67 +435,98 @@ timeStepper::timeStepper(const int N1,
 
   residualMask(domainX1, domainX2, domainX3) = 1.;
 
-  initialConditions(numReads, numWrites);
+  idealSolverFailures  = 0.*residualMask;
+  idealSolverZoneIters = 0.*residualMask;
+  idealSolverIters     = 0;
+  resetZoneCost();
+  fluxTaskUtilization = 0.;
+
+  /* The native backend only covers the explicit ideal MHD step */
+#ifdef GRIM_NATIVE_BACKEND
+  useNativeBackend = (   params::conduction == 0
+                      && params::viscosity  == 0
+                      && params::solver     == solvers::IDEAL
+                     );
+#else
+  useNativeBackend = false;
+#endif
+  PetscPrintf(PETSC_COMM_WORLD, "  Backend : %s\n",
+              useNativeBackend ? "Native (OpenMP)" : "ArrayFire"
+             );
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    native::placeGeometry(*geomCenter);
+    for (int d=0; d < dim; d++)
+    {
+      native::placeGeometry(*geomFaces[d]);
+    }
+  }
+#endif
+  if (params::tiledFluxes)
+  {
+    if (useNativeBackend && fluxFilterChangesFluid())
+    {
+      /* The tiles sum the fluid divergence before the filter runs, so it
+       * would act on stale fluid fluxes and change nothing */
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "tiledFluxes = 1 needs a flux filter that leaves the fluid "
+                  "fluxes alone; this problem's does not. Set tiledFluxes "
+                  "= 0\n"
+                 );
+      MPI_Abort(PETSC_COMM_WORLD, 1);
+    }
+    if (useNativeBackend)
+    {
+      PetscPrintf(PETSC_COMM_WORLD, "  Tiles   : %i x %i x %i zones\n",
+                  params::tileSizeX1, params::tileSizeX2, params::tileSizeX3
+                 );
+    }
+    else
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "  Tiles   : need the native backend, ignored\n"
+                 );
+    }
+  }
+  PetscPrintf(PETSC_COMM_WORLD, "\n");
+  endStartupPhase("solver data", phaseStart);
 
-  struct stat fileInfoName;
-  struct stat fileInfoTime;
-  if (
-      params::restart || 
-      ( (stat(params::restartFileName.c_str(), &fileInfoName) == 0) && 
-	(stat(params::restartFileTime.c_str(), &fileInfoTime) == 0) ) 
-     )
+  /* A restart continues from the checkpoint alone. Problems whose
+   * boundary conditions use primIC need the initial conditions too. */
+  std::string restartFile = findRestartFile();
+  if (restartFile.empty() || !params::restartWithoutInitialConditions)
   {
-    struct stat fileInfo;
-    int rank;
-    MPI_Comm_rank(PETSC_COMM_WORLD,&rank);
+    initialConditions();
+    endStartupPhase("initial conditions", phaseStart);
+  }
+  if (!restartFile.empty())
+  {
+    restartFrom(restartFile);
+    endStartupPhase("restart", phaseStart);
+  }
 
-    if((stat(params::restartFileName.c_str(), &fileInfoName) == 0) &&
-       (stat(params::restartFileTime.c_str(), &fileInfoTime) == 0) )
-      {
-	std::ifstream fTime(params::restartFileTime.c_str());
-	double RestartTime;
-	fTime>>RestartTime;
-	this->time = RestartTime;
-	if (rank==0)
-	  {
-	    PetscPrintf(PETSC_COMM_WORLD, "\n Restarting from file %s at time %e\n\n",
-			params::restartFileName.c_str(),
-			RestartTime
-			);
-	  }
-	fTime.close();
-	std::ifstream fName(params::restartFileName.c_str());
-	std::string mFileName;
-	fName>>mFileName;
-	primOld->load("primitives",mFileName);
-      }
-    else
-      {
-	if (rank==0)
-	  {
-	    if (stat(params::restartFile.c_str(), &fileInfo) == 0)
-	      {
-		/* File exists */
-		PetscPrintf(PETSC_COMM_WORLD, "\nFound restart file: %s\n\n", 
-			    params::restartFile.c_str()
-			    ); 
-	      }
-	    else
-	      {
-		/* File does not exist */
-		PetscPrintf(PETSC_COMM_WORLD, "\n");
-		PetscPrintf(PETSC_COMM_WORLD, "Restart file %s does not exist\n",
-			    params::restartFile.c_str()
-			    );
-		MPI_Abort(PETSC_COMM_WORLD, 1);
-	      }
-	  }
-	
-	primOld->load("primitives", params::restartFile);
-      }
-    // Need to call the diagnostics to reset the time step !!!
-    fullStepDiagnostics(numReads, numWrites);
+#ifdef GRIM_NATIVE_BACKEND
+  if (useNativeBackend)
+  {
+    /* The grids the native kernels write in place. prim is also the guess
+     * of the inversion, so it gets a fresh buffer every solve. */
+    std::vector<grid *> grids;
+    grids.push_back(cons);
+    grids.push_back(consOld);
+    grids.push_back(sourcesExplicit);
+    grids.push_back(fluxesX1);
+    grids.push_back(fluxesX2);
+    grids.push_back(fluxesX3);
+    grids.push_back(divFluxes);
+    std::vector<array *> others;
+    others.push_back(&idealSolverFailures);
+    others.push_back(&idealSolverZoneIters);
+    native::placeGrids(grids, others);
   }
+#endif
+
+  printStartupSummary();
 }
 
 timeStepper::~timeStepper()
@@ -450,7 +541,11 @@ timeStepper::~timeStepper()
   delete emfX1, emfX2, emfX3;
   delete elem, elemOld, elemHalfStep;
   delete riemann;
-  delete geomLeft, geomRight, geomBottom, geomTop, geomCenter;
+  for (int d=0; d < dim; d++)
+  {
+    delete geomFaces[d];
+  }
+  delete geomCenter;
 
   delete primGuessLineSearchTrial;
   delete primGuessPlusEps;
@@ -462,16 +557,11 @@ timeStepper::~timeStepper()
 }
 
 /* Returns memory bandwidth in GB/sec */
-double timeStepper::memoryBandwidth(const double numReads,
-                                    const double numWrites,
-                                    const double numEvals,
+double timeStepper::memoryBandwidth(const double bytes,
                                     const double timeElapsed
                                     )
 {
-  return   (double)(prim->N1Total)
-         * (double)(prim->N2Total)
-         * (double)(prim->N3Total)
-         * 8. * (numReads + numWrites) * numEvals /timeElapsed/1e9;
+  return bytes/timeElapsed/1e9;
 }
 
 double timeStepper::bandwidthTest(const int numEvals)
@@ -508,12 +598,294 @@ double timeStepper::bandwidthTest(const int numEvals)
   }
   af::sync();
 
-  int numReads  = 2;
-  int numWrites = 1;
   double timeElapsed = af::timer::stop();
 
-  return memoryBandwidth(numReads, numWrites,
-                         numEvals, timeElapsed
+  /* Two reads and one write per evaluation */
+  return memoryBandwidth(numEvals*profiler::arrayBytes(3, prim.vars),
+                         timeElapsed
                         );
 }
 
+/* Memory bandwidth per rank in GB/sec of this node, from
+ * params::bandwidthCacheFile or, if params::bandwidthProbe asks for it,
+ * measured with bandwidthTest() by all ranks of the node at once and added
+ * to the cache. A cache line is "<host> <ranks on the host> <GB/sec per
+ * rank>"; the last one of a node wins. Returns 0 if unknown. Collective. */
+double timeStepper::nodeBandwidth()
+{
+  MPI_Comm nodeComm;
+  MPI_Comm_split_type(PETSC_COMM_WORLD, MPI_COMM_TYPE_SHARED, world_rank,
+                      MPI_INFO_NULL, &nodeComm
+                     );
+  int nodeRank, nodeSize;
+  MPI_Comm_rank(nodeComm, &nodeRank);
+  MPI_Comm_size(nodeComm, &nodeSize);
+
+  char hostName[MPI_MAX_PROCESSOR_NAME];
+  int hostNameLength;
+  MPI_Get_processor_name(hostName, &hostNameLength);
+
+  std::string cache;
+  if (world_rank == 0)
+  {
+    std::ifstream cacheFile(params::bandwidthCacheFile.c_str());
+    cache.assign(std::istreambuf_iterator<char>(cacheFile),
+                 std::istreambuf_iterator<char>()
+                );
+  }
+  int cacheSize = cache.size();
+  MPI_Bcast(&cacheSize, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  cache.resize(cacheSize);
+  MPI_Bcast(&cache[0], cacheSize, MPI_CHAR, 0, PETSC_COMM_WORLD);
+
+  double bandwidth = 0.;
+  if (params::bandwidthProbe < 2)
+  {
+    std::istringstream lines(cache);
+    std::string host;
+    int ranks;
+    double value;
+    while (lines >> host >> ranks >> value)
+    {
+      if (host == hostName && ranks == nodeSize)
+      {
+        bandwidth = value;
+      }
+    }
+  }
+
+  /* The test grid is created on all ranks, so all ranks measure if any node
+   * needs to. The nodes then stream concurrently, as during the run. */
+  int measure = (bandwidth == 0. && params::bandwidthProbe > 0);
+  int anyMeasure;
+  MPI_Allreduce(&measure, &anyMeasure, 1, MPI_INT, MPI_MAX,
+                PETSC_COMM_WORLD
+               );
+  if (!anyMeasure)
+  {
+    MPI_Comm_free(&nodeComm);
+    return bandwidth;
+  }
+
+  PetscPrintf(PETSC_COMM_WORLD, "  Measuring memory bandwidth...");
+  double rankBandwidth = bandwidthTest(10000);
+  double sumBandwidth;
+  MPI_Allreduce(&rankBandwidth, &sumBandwidth, 1, MPI_DOUBLE, MPI_SUM,
+                nodeComm
+               );
+  PetscPrintf(PETSC_COMM_WORLD, "done\n");
+  if (measure)
+  {
+    bandwidth = sumBandwidth/nodeSize;
+  }
+
+  /* Rank 0 appends the new lines, one per measured node */
+  std::ostringstream line;
+  if (measure && nodeRank == 0)
+  {
+    line.precision(6);
+    line << hostName << " " << nodeSize << " " << bandwidth << "\n";
+  }
+  std::string newLine = line.str();
+  int newLineSize = newLine.size();
+  std::vector<int> newLineSizes(world_size), offsets(world_size, 0);
+  MPI_Gather(&newLineSize, 1, MPI_INT, &newLineSizes[0], 1, MPI_INT,
+             0, PETSC_COMM_WORLD
+            );
+  for (int rank=1; rank < world_size; rank++)
+  {
+    offsets[rank] = offsets[rank-1] + newLineSizes[rank-1];
+  }
+  std::string newLines(offsets[world_size-1] + newLineSizes[world_size-1], ' ');
+  MPI_Gatherv(&newLine[0], newLineSize, MPI_CHAR,
+              &newLines[0], &newLineSizes[0], &offsets[0], MPI_CHAR,
+              0, PETSC_COMM_WORLD
+             );
+  if (world_rank == 0 && newLines.size() > 0)
+  {
+    std::ofstream cacheFile(params::bandwidthCacheFile.c_str(),
+                            std::ios::app
+                           );
+    cacheFile << newLines;
+  }
+
+  MPI_Comm_free(&nodeComm);
+  return bandwidth;
+}
+
+/* 64 bit FNV-1a */
+unsigned long long timeStepper::hashString(const std::string key)
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  for (int i=0; i < key.size(); i++)
+  {
+    hash ^= (unsigned char) key[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/* Per-rank cache file of the geometry at location, named after a hash of
+ * everything the geometry depends on: the code that computes it, the metric
+ * and coordinate map parameters, the grid and this rank's part of it. A
+ * change to any of them gives another file, so stale files are never read. */
+std::string timeStepper::geometryCacheFile(const int location)
+{
+  /* The same for all locations; built once, as it reads the map tables */
+  if (geometryCacheKey.empty())
+  {
+    std::ostringstream key;
+    key.precision(17);
+    key << "geometry cache v2 " << geometry::sourceHash()
+        << " " << params::metric << " " << params::blackHoleSpin
+        << " " << params::hSlope
+        << " " << params::DerefineThetaHorizon << " " << params::DoCylindrify
+        << " " << params::X1cyl << " " << params::X2cyl
+        << " " << params::analyticConnectionCoeffs
+        << " " << XCoords->X1Start << " " << XCoords->X1End
+        << " " << XCoords->X2Start << " " << XCoords->X2End
+        << " " << XCoords->X3Start << " " << XCoords->X3End
+        << " " << params::X1Start
+        << " " << N1 << " " << N2 << " " << N3 << " " << dim
+        << " " << numGhost
+        << " " << world_size
+        << " " << XCoords->iLocalStart << " " << XCoords->N1Local
+        << " " << XCoords->jLocalStart << " " << XCoords->N2Local
+        << " " << XCoords->kLocalStart << " " << XCoords->N3Local;
+
+    /* The tables themselves, so that an edited table gives another file */
+    const std::string mapFiles[2] = {params::X1MapFile, params::X2MapFile};
+    for (int i=0; i<2; i++)
+    {
+      if (   params::metric == metrics::MODIFIED_KERR_SCHILD
+          && !mapFiles[i].empty()
+         )
+      {
+        coordinateMap::shared(mapFiles[i]).writeKey(key);
+      }
+    }
+    geometryCacheKey = key.str();
+  }
+
+  std::ostringstream locationKey;
+  locationKey << geometryCacheKey << " " << location;
+  const unsigned long long hash = hashString(locationKey.str());
+
+  char fileName[64];
+  snprintf(fileName, sizeof(fileName), "/geometry_%016llx_rank%d.h5",
+           hash, world_rank
+          );
+  return params::geometryCacheDirectory + fileName;
+}
+
+/* True on all ranks if the cache is on and every rank has its file, so that
+ * all ranks either load or generate the geometry. Collective. */
+bool timeStepper::geometryCacheFound(const std::string cacheFileName)
+{
+  if (!params::geometryCache)
+  {
+    return false;
+  }
+
+  if (world_rank == 0)
+  {
+    mkdir(params::geometryCacheDirectory.c_str(), 0755);
+  }
+  MPI_Barrier(PETSC_COMM_WORLD);
+
+  struct stat fileInfo;
+  int found = (stat(cacheFileName.c_str(), &fileInfo) == 0);
+  int foundOnAll;
+  MPI_Allreduce(&found, &foundOnAll, 1, MPI_INT, MPI_MIN, PETSC_COMM_WORLD);
+
+  return foundOnAll;
+}
+
+/* Add the time since phaseStart to the startup phase name and restart the
+ * clock. Waits for the device, as construction is mostly lazy ArrayFire
+ * work. */
+void timeStepper::endStartupPhase(const std::string name, double &phaseStart)
+{
+  af::sync();
+  double phaseEnd = MPI_Wtime();
+
+  int phase = 0;
+  while (phase < startupPhases.size() && startupPhases[phase].first != name)
+  {
+    phase++;
+  }
+  if (phase == startupPhases.size())
+  {
+    startupPhases.push_back(std::make_pair(name, 0.));
+  }
+  startupPhases[phase].second += phaseEnd - phaseStart;
+  phaseStart = phaseEnd;
+}
+
+/* Time of the startup phases on the slowest rank. All ranks go through the
+ * same phases in the same order. */
+void timeStepper::printStartupSummary()
+{
+  int numPhases = startupPhases.size();
+  std::vector<double> phaseTimes(numPhases + 1, 0.);
+  for (int phase=0; phase < numPhases; phase++)
+  {
+    phaseTimes[phase]      = startupPhases[phase].second;
+    phaseTimes[numPhases] += startupPhases[phase].second;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &phaseTimes[0], numPhases + 1, MPI_DOUBLE,
+                MPI_MAX, PETSC_COMM_WORLD
+               );
+
+  const double totalTime = phaseTimes[numPhases];
+  PetscPrintf(PETSC_COMM_WORLD, "  Startup (slowest rank)\n");
+  for (int phase=0; phase < numPhases; phase++)
+  {
+    PetscPrintf(PETSC_COMM_WORLD, "    %-24s : %8.3f sec  %5.1f%%\n",
+                startupPhases[phase].first.c_str(), phaseTimes[phase],
+                100.*phaseTimes[phase]/totalTime
+               );
+  }
+  PetscPrintf(PETSC_COMM_WORLD, "    %-24s : %8.3f sec\n\n", "total", totalTime);
+}
+
+
+void timeStepper::resetZoneCost()
+{
+  zoneWork     = 0.*residualMask;
+  zoneWorkTime = 0.;
+}
+
+/* Write the cost map read by grid::loadOwnershipRanges(): each rank's
+ * measured time, spread over its zones in proportion to zoneWork */
+void timeStepper::dumpZoneCost(const std::string fileName)
+{
+  double localWork = af::sum<double>(zoneWork(domainX1, domainX2, domainX3));
+
+  grid zoneCost(N1, N2, N3, dim, 1, numGhost, false, false, false);
+  if (localWork > 0.)
+  {
+    zoneCost.vars[0] = zoneWork * (zoneWorkTime/localWork);
+  }
+  zoneCost.dump("zoneCost", fileName);
+
+  /* The grid the map is for, checked by grid::loadOwnershipRanges() */
+  PetscInt gridSize[4] = {N1, N2, N3, dim};
+  PetscViewer viewer;
+  PetscViewerHDF5Open(PETSC_COMM_WORLD,
+                      fileName.c_str(), FILE_MODE_APPEND, &viewer
+                     );
+  PetscViewerHDF5WriteAttribute(viewer, "zoneCost", "N1",
+                                PETSC_INT, &gridSize[0]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "zoneCost", "N2",
+                                PETSC_INT, &gridSize[1]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "zoneCost", "N3",
+                                PETSC_INT, &gridSize[2]
+                               );
+  PetscViewerHDF5WriteAttribute(viewer, "zoneCost", "dim",
+                                PETSC_INT, &gridSize[3]
+                               );
+  PetscViewerDestroy(&viewer);
+}
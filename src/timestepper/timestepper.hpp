@@ -7,6 +7,11 @@
 #include "../physics/physics.hpp"
 #include "../geometry/geometry.hpp"
 #include "../boundary/boundary.hpp"
+#include "../threads/threads.hpp"
+#ifdef GRIM_NATIVE_BACKEND
+#include "../native/native.hpp"
+#endif
+#include "../profiler/profiler.hpp"
 #include "mkl.h"
 
 namespace timeStepperSwitches
@@ -17,6 +22,15 @@ namespace timeStepperSwitches
   };
 };
 
+/* Stages of the half step that timeStepper::replay() repeats */
+namespace replayStages
+{
+  enum
+  {
+    DIV_OF_FLUXES, SOLVE, FLOORS
+  };
+};
+
 class timeStepper
 {
   int world_rank, world_size;
@@ -35,35 +49,63 @@ class timeStepper
   double *AHostPtr, *bHostPtr;
 
   void solve(grid &primGuess);
-  void computeResidual(const grid &prim, grid &residual,
-                       int &numReads,
-                       int &numWrites
-                      );
+  void computeResidual(const grid &prim, grid &residual);
   void batchLinearSolve(const array &A, const array &b, array &x);
   double linearSolverTime;
   double lineSearchTime;
   double jacobianAssemblyTime;
 
-  void idealSolver(grid &primGuess,                                   
-                   int &numreads,
-                   int &numwrites
-                  );
+  void idealSolverFixedIter(grid &primGuess);
   void timeStepFluidCons(const double dt
                         );
 
+  void replaySetup();
+  void replaySolve();
+
+  /* Set when built with GRIM_NATIVE_BACKEND and the step is ideal MHD */
+  bool useNativeBackend;
+  void computeDivOfFluxesTasks(const grid &primFlux, const double dX[3]);
+
   af::seq domainX1, domainX2, domainX3;
   array residualMask;
 
-  double memoryBandwidth(const double numReads,
-                         const double numWrites,
-                         const double numEvals,
+  double memoryBandwidth(const double bytes,
                          const double timeElapsed
                         );
 
   double bandwidthTest(const int numEvals);
+  double nodeBandwidth();
+
+  static unsigned long long hashString(const std::string key);
+  std::string geometryCacheFile(const int location);
+  std::string geometryCacheKey;
+  bool geometryCacheFound(const std::string cacheFileName);
+
+  /* Checkpoints, see restart.cpp */
+  std::string restartParameters();
+  std::string findRestartFile();
+  bool loadRestart(const std::string fileName);
+
+  /* Checkpoints on signals and on a cadence, see checkpointIfDue(). The wall
+   * time is counted from the start of the constructor, and is the same on
+   * all ranks. */
+  double wallTimeStart, wallTimeElapsed, lastCheckpointWallTime;
+  int stopRequested, checkpointRequested;
+  int checkpointSignalsSeen, checkpointSignalsHandled;
+  void installCheckpointSignalHandlers();
+  void reduceStepState(double &maxInvDt);
+  void writeCheckpoint();
+  void restartFrom(const std::string fileName);
+
+  /* Wall time of each phase of the constructor, see endStartupPhase() */
+  std::vector<std::pair<std::string, double> > startupPhases;
+  void endStartupPhase(const std::string name, double &phaseStart);
+  void printStartupSummary();
 
   public:
     double dt, time;
+    /* Steps taken since the initial conditions, kept across restarts */
+    int stepNumber;
     int N1, N2, N3, numGhost, dim;
     int numVars;
 
@@ -84,20 +126,50 @@ class timeStepper
     grid *divFluxes;
     grid *divB;
 
-    geometry *geomLeft,   *geomRight;
-    geometry *geomBottom, *geomTop;
+    /* Geometry on the lower face of each zone in direction X1, X2, X3 (LEFT,
+     * BOTTOM, BACK). The upper face of zone i is the lower face of zone i+1.
+     * Directions beyond dim share geomCenter. */
+    geometry *geomFaces[3];
     geometry *geomCenter;
 
     fluidElement *elem, *elemOld, *elemHalfStep;
 
     riemannSolver *riemann;
 
-    void computeDivOfFluxes(const grid &prim,
-                            int &numReads, int &numWrites
-                           );
+    void computeDivOfFluxes(const grid &prim);
 
     int currentStep;
 
+    /* Status of the last ideal solve in each zone (see idealSolverStatus).
+     * Failed zones hold the guess until fixupFailedZones() replaces them
+     * with the average of their converged neighbours, before the floors. */
+    void idealSolver(grid &primGuess);
+    void fixupFailedZones(grid &primFixup);
+    array idealSolverFailures;
+    array idealSolverZoneIters;
+    int idealSolverIters;
+    void benchmarkIdealSolver(const int numEvals);
+    void benchmarkFluxTiles(const int numEvals);
+    void benchmarkKernels(const int numEvals, const std::string fileName);
+    void replay(const int stage, const int numEvals);
+#ifdef GRIM_NATIVE_BACKEND
+    bool compareBackends(double &divFluxesError, double &primError,
+                         double &nativeResidual, double &arrayFireResidual
+                        );
+    bool compareFluxTasks(double &divFluxesError);
+#endif
+    /* Busy fraction of the OpenMP threads in the last flux task graph */
+    double fluxTaskUtilization;
+
+    /* Per-zone cost map for load balancing (see grid::loadOwnershipRanges).
+     * zoneWork counts one unit per zone per step plus one per ideal solver
+     * iteration; zoneWorkTime is this rank's time in timeStep() outside of
+     * communication. */
+    array zoneWork;
+    double zoneWorkTime;
+    void resetZoneCost();
+    void dumpZoneCost(const std::string fileName);
+
     timeStepper(const int N1, 
                 const int N2,
                 const int N3,
@@ -118,23 +190,27 @@ class timeStepper
                );
     ~timeStepper();
 
-    void timeStep(int &numReads, int &numWrites);
+    void timeStep();
+
+    /* Checkpoint of primOld with time, dt and stepNumber, see restart.cpp */
+    void dumpRestart(const std::string fileName);
+    int checkpointIfDue();
+    /* Checkpoints of another resolution, see prolongation.cpp */
+    void prolongRestart(const std::string fileName, const int sourceN[3]);
 
-    void fluxCT(int &numReads, int &numWrites);
-    void computeEMF(int &numReadsEMF, int &numWritesEMF);
-    void computeDivB(const grid &prim,
-                     int &numReads,
-                     int &numWrites
-                    );
+    void fluxCT();
+    void computeEMF();
+    void computeDivB(const grid &prim);
 
-    double computeDt(int &numReads, int &numWrites);
+    double computeDt();
 
     /* Function definitions in the problem folder */
-    void initialConditions(int &numReads, int &numWrites);
-    void halfStepDiagnostics(int &numReads, int &numWrites);
-    void fullStepDiagnostics(int &numReads, int &numWrites);
-    void setProblemSpecificBCs(int &numReads, int &numWrites);
-    void applyProblemSpecificFluxFilter(int &numReads, int &numWrites);
+    void initialConditions();
+    void halfStepDiagnostics();
+    void fullStepDiagnostics();
+    void setProblemSpecificBCs();
+    void applyProblemSpecificFluxFilter();
+    bool fluxFilterChangesFluid();
     int CheckWallClockTermination();
 };
 
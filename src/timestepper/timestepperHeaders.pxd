@@ -1,4 +1,5 @@
-from gridHeaders cimport grid, coordinatesGrid
+from libcpp.string cimport string
+from gridHeaders cimport grid, coordinatesGrid, array
 from geometryHeaders cimport geometry
 from physicsHeaders cimport fluidElement
 
@@ -50,20 +51,17 @@ cdef extern from "timestepper.hpp":
     fluidElement *elemHalfStep
 
     geometry *geomCenter
-    geometry *geomLeft
-    geometry *geomRight
-    geometry *geomBottom
-    geometry *geomTop
+    geometry *geomFaces[3]
 
-    void timeStep(int &numReads, int &numWrites)
+    void timeStep()
+    void prolongRestart(const string fileName, const int *sourceN)
 
-    void fluxCT(int &numReads, int &numWrites)
-    void computeEMF(int &numReadsEMF, int &numWritesEMF)
-    void computeDivB(const grid &prim,
-                     int &numReads,
-                     int &numWrites
-                    )
+    void fluxCT()
+    void computeEMF()
+    void computeDivB(const grid &prim)
 
-    void computeDivOfFluxes(const grid &prim,
-                            int &numReads, int &numWrites
-                           )
+    void computeDivOfFluxes(const grid &prim)
+
+    void idealSolver(grid &primGuess)
+    void fixupFailedZones(grid &primFixup)
+    array idealSolverFailures